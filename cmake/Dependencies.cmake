@@ -37,6 +37,12 @@ FetchContent_Declare(
         GIT_TAG        v1.4.320
         GIT_SHALLOW    TRUE
 )
+FetchContent_Declare(
+        meshoptimizer
+        GIT_REPOSITORY https://github.com/zeux/meshoptimizer
+        GIT_TAG        v0.22
+        GIT_SHALLOW    TRUE
+)
 
 FetchContent_Declare(
         slang
@@ -45,4 +51,18 @@ FetchContent_Declare(
         GIT_SHALLOW    TRUE
 )
 
-FetchContent_MakeAvailable(glm glfw vma imgui tinygltf vk_bootstrap slang)
+# KTX2 loading and Basis Universal transcoding only, uploads go through the engine's own staging
+set(KTX_FEATURE_TESTS OFF CACHE BOOL "" FORCE)
+set(KTX_FEATURE_TOOLS OFF CACHE BOOL "" FORCE)
+set(KTX_FEATURE_DOC OFF CACHE BOOL "" FORCE)
+set(KTX_FEATURE_GL_UPLOAD OFF CACHE BOOL "" FORCE)
+set(KTX_FEATURE_VK_UPLOAD OFF CACHE BOOL "" FORCE)
+set(KTX_FEATURE_STATIC_LIBRARY ON CACHE BOOL "" FORCE)
+FetchContent_Declare(
+        ktx
+        GIT_REPOSITORY https://github.com/KhronosGroup/KTX-Software
+        GIT_TAG        v4.4.0
+        GIT_SHALLOW    TRUE
+)
+
+FetchContent_MakeAvailable(glm glfw vma imgui tinygltf vk_bootstrap meshoptimizer slang ktx)
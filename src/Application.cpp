@@ -4,30 +4,32 @@
 
 #include "Application.h"
 
+#include <algorithm>
 #include <array>
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_vulkan.h>
 
-#include "Utilities.h"
 #include "Renderer.h"
+#include "Trace.h"
 #include "vk/Error.h"
+#include "vk/Swapchain.h"
 
 namespace spectra {
-Application::Application()
+Application::Application(const Options& options)
 {
-    pCtx_ = std::make_shared<vk::Context>();
+    SPECTRA_TRACE_THREAD("Main");
 
-    utils::vk::createTemporaryCommandPool(
-        pCtx_->device, pCtx_->vkbDevice.get_queue_index(vkb::QueueType::graphics).value(), temporaryCmdPool_);
+    pCtx_ = std::make_shared<vk::Context>();
 
-    createSwapchain();
+    auto pSwapchain = std::make_unique<vk::Swapchain>(pCtx_, options.presentMode);
 
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
-    setupImGui();
+    setupImGui(*pSwapchain, options.framesInFlight);
 
-    pRenderer_ = std::make_unique<Renderer>(pCtx_, vkbSwapchain_, swapchainImageViews_);
+    // The renderer owns the swapchain from here on and recreates it when the window is resized
+    pRenderer_ = std::make_unique<Renderer>(pCtx_, std::move(pSwapchain), options.framesInFlight);
     pRenderer_->loadScene("scenes/BoxVertexColors.glb");
 }
 
@@ -38,11 +40,6 @@ Application::~Application()
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
     vkDestroyDescriptorPool(pCtx_->device, imguiDescriptorPool_, nullptr);
-
-    vkDestroyCommandPool(pCtx_->device, temporaryCmdPool_, nullptr);
-
-    vkbSwapchain_.destroy_image_views(swapchainImageViews_);
-    vkb::destroy_swapchain(vkbSwapchain_);
 }
 
 void Application::run()
@@ -50,52 +47,29 @@ void Application::run()
     // Main loop
     while (!glfwWindowShouldClose(pCtx_->pWindow))
     {
-        glfwPollEvents();
+        SPECTRA_TRACE_SCOPE("Frame");
+        {
+            SPECTRA_TRACE_SCOPE("Poll events");
+            glfwPollEvents();
+            // A minimized window has nothing to present to, sleep until it is restored
+            while (glfwGetWindowAttrib(pCtx_->pWindow, GLFW_ICONIFIED) && !glfwWindowShouldClose(pCtx_->pWindow))
+            {
+                glfwWaitEvents();
+            }
+        }
 
         pRenderer_->render();
     }
 
     // Prepare for destruction
     vkDeviceWaitIdle(pCtx_->device);
-}
-
-void Application::createSwapchain()
-{
-    vkb::SwapchainBuilder swapchainBuilder(pCtx_->vkbDevice);
-    auto builderRet = swapchainBuilder.set_old_swapchain(swapchain_).build();
-    if (!builderRet)
-    {
-        std::cerr << builderRet.error().message() << " " << builderRet.vk_result() << "\n";
-    }
-
-    vkb::destroy_swapchain(vkbSwapchain_);
-    vkbSwapchain_ = builderRet.value();
-    swapchain_ = vkbSwapchain_.swapchain;
-
-    swapchainImages_ = vkbSwapchain_.get_images().value();
-    swapchainImageViews_ = vkbSwapchain_.get_image_views().value();
-
-    VkCommandBuffer cmd{};
-    utils::vk::beginOneTimeCommands(cmd, pCtx_->device, temporaryCmdPool_);
-
-    // Set initial swapchain image layouts to VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
-    for (int i = 0; i < vkbSwapchain_.image_count; i++)
-    {
-        utils::vk::transitionImageLayout(cmd,
-            swapchainImages_[i],
-            VK_IMAGE_LAYOUT_UNDEFINED,
-            VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-            VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
-            VK_PIPELINE_STAGE_2_NONE,
-            VK_ACCESS_NONE
-        );
-    }
 
-    utils::vk::endOneTimeCommands(cmd, pCtx_->device, temporaryCmdPool_, pCtx_->graphicsQueue);
+#ifdef SPECTRA_ENABLE_TRACING
+    trace::writeChromeTrace("spectra_trace.json");
+#endif
 }
 
-void Application::setupImGui()
+void Application::setupImGui(const vk::Swapchain& swapchain, uint32_t framesInFlight)
 {
     constexpr uint32_t texturePoolSize = 128U;
     static VkFormat imageFormats = VK_FORMAT_B8G8R8A8_UNORM;  // Must be static for ImGui_ImplVulkan_InitInfo
@@ -119,7 +93,7 @@ void Application::setupImGui()
     io.ConfigFlags = configFlags;
 
     ImGui_ImplGlfw_InitForVulkan(pCtx_->pWindow, true);
-    imageFormats = vkbSwapchain_.image_format;
+    imageFormats = swapchain.format();
 
     ImGui_ImplVulkan_InitInfo initInfo = {
         .ApiVersion                  = VK_API_VERSION_1_3,
@@ -129,8 +103,8 @@ void Application::setupImGui()
         .QueueFamily                 = pCtx_->vkbDevice.get_queue_index(vkb::QueueType::graphics).value(),
         .Queue                       = pCtx_->vkbDevice.get_queue(vkb::QueueType::graphics).value(),
         .DescriptorPool              = imguiDescriptorPool_,
-        .MinImageCount               = MAX_FRAMES_IN_FLIGHT,
-        .ImageCount                  = std::max(vkbSwapchain_.image_count, MAX_FRAMES_IN_FLIGHT),
+        .MinImageCount               = 2,
+        .ImageCount                  = std::max(swapchain.imageCount(), framesInFlight),
         .UseDynamicRendering         = true,
         .PipelineRenderingCreateInfo =
         {
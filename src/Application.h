@@ -12,23 +12,22 @@ namespace spectra {
 
 class Application {
 public:
-    Application();
+    struct Options
+    {
+        VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;
+        uint32_t framesInFlight = Renderer::DEFAULT_FRAMES_IN_FLIGHT;
+    };
+
+    explicit Application(const Options& options = {});
     ~Application();
 
     void run();
 
 private:
-    void createSwapchain();
-    void setupImGui();
+    void setupImGui(const vk::Swapchain& swapchain, uint32_t framesInFlight);
 
-    VkCommandPool temporaryCmdPool_ = VK_NULL_HANDLE;
     VkDescriptorPool imguiDescriptorPool_ = VK_NULL_HANDLE;
 
-    vkb::Swapchain vkbSwapchain_{};
-    VkSwapchainKHR swapchain_ = VK_NULL_HANDLE;
-    std::vector<VkImage> swapchainImages_;
-    std::vector<VkImageView> swapchainImageViews_;
-
     std::shared_ptr<vk::Context> pCtx_;
     std::unique_ptr<Renderer> pRenderer_;
 };
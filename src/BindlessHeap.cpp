@@ -0,0 +1,228 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "BindlessHeap.h"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+
+#include "vk/Error.h"
+
+namespace spectra {
+namespace {
+constexpr std::array KIND_NAMES = { "sampled image", "sampler", "storage buffer" };
+constexpr std::array KIND_TYPES = {
+    VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+    VK_DESCRIPTOR_TYPE_SAMPLER,
+    VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+};
+}
+
+std::optional<uint32_t> HandleAllocator::allocate()
+{
+    if (!freeList_.empty())
+    {
+        const uint32_t handle = freeList_.back();
+        freeList_.pop_back();
+        return handle;
+    }
+    if (next_ == capacity_)
+    {
+        return std::nullopt;
+    }
+    return next_++;
+}
+
+void HandleAllocator::free(uint32_t handle)
+{
+    freeList_.push_back(handle);
+}
+
+BindlessHeap::BindlessHeap(std::shared_ptr<vk::Context> pCtx, uint32_t frameCount, uint32_t maxImages,
+                           uint32_t maxSamplers, uint32_t maxStorageBuffers)
+    : pCtx_(std::move(pCtx)), device_(pCtx_->device), frameCount_(frameCount)
+{
+    // Update-after-bind descriptors have their own, usually much larger, limits
+    VkPhysicalDeviceVulkan12Properties vk12Properties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES,
+    };
+    VkPhysicalDeviceProperties2 properties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &vk12Properties,
+    };
+    vkGetPhysicalDeviceProperties2(pCtx_->physicalDevice, &properties);
+
+    // Every binding is visible to all stages, so the per-stage limits apply as well as the per-set ones
+    std::array<uint32_t, 3> capacities = {
+        std::min({ maxImages, vk12Properties.maxDescriptorSetUpdateAfterBindSampledImages,
+                   vk12Properties.maxPerStageDescriptorUpdateAfterBindSampledImages }),
+        std::min({ maxSamplers, vk12Properties.maxDescriptorSetUpdateAfterBindSamplers,
+                   vk12Properties.maxPerStageDescriptorUpdateAfterBindSamplers }),
+        std::min({ maxStorageBuffers, vk12Properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+                   vk12Properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers }),
+    };
+    // Images and buffers also share the per-stage resource limit, samplers do not count toward it. Images are the
+    // ones a scene runs out of, so buffers give up most of the space.
+    const uint32_t maxResources = vk12Properties.maxPerStageUpdateAfterBindResources;
+    if (uint64_t{ capacities[0] } + capacities[2] > maxResources)
+    {
+        capacities[2] = std::min(capacities[2], maxResources / 4);
+        capacities[0] = std::min(capacities[0], maxResources - capacities[2]);
+    }
+
+    std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+    std::array<VkDescriptorBindingFlags, 3> bindingFlags{};
+    std::array<VkDescriptorPoolSize, 3> poolSizes{};
+    for (uint32_t i = 0; i < bindings.size(); i++)
+    {
+        allocators_[i] = HandleAllocator(capacities[i]);
+        bindings[i] = {
+            .binding = i,
+            .descriptorType = KIND_TYPES[i],
+            .descriptorCount = capacities[i],
+            .stageFlags = VK_SHADER_STAGE_ALL,
+        };
+        bindingFlags[i] = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT |
+                          VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        poolSizes[i] = { KIND_TYPES[i], capacities[i] };
+    }
+    // Only the last binding of a set may have a variable count
+    bindingFlags.back() |= VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT;
+
+    const VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = static_cast<uint32_t>(bindingFlags.size()),
+        .pBindingFlags = bindingFlags.data(),
+    };
+    const VkDescriptorSetLayoutCreateInfo layoutCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &bindingFlagsInfo,
+        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+        .bindingCount = static_cast<uint32_t>(bindings.size()),
+        .pBindings = bindings.data(),
+    };
+    CHECK_VK(vkCreateDescriptorSetLayout(device_, &layoutCreateInfo, nullptr, &setLayout_));
+
+    const VkDescriptorPoolCreateInfo poolCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets = 1,
+        .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+        .pPoolSizes = poolSizes.data(),
+    };
+    CHECK_VK(vkCreateDescriptorPool(device_, &poolCreateInfo, nullptr, &pool_));
+
+    const uint32_t variableCount = capacities.back();
+    const VkDescriptorSetVariableDescriptorCountAllocateInfo variableCountInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO,
+        .descriptorSetCount = 1,
+        .pDescriptorCounts = &variableCount,
+    };
+    const VkDescriptorSetAllocateInfo allocateInfo {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .pNext = &variableCountInfo,
+        .descriptorPool = pool_,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &setLayout_,
+    };
+    CHECK_VK(vkAllocateDescriptorSets(device_, &allocateInfo, &set_));
+
+    std::clog << std::format("Bindless heap: {} images, {} samplers, {} storage buffers\n",
+                             capacities[0], capacities[1], capacities[2]);
+}
+
+BindlessHeap::~BindlessHeap()
+{
+    vkDestroyDescriptorPool(device_, pool_, nullptr);
+    vkDestroyDescriptorSetLayout(device_, setLayout_, nullptr);
+}
+
+uint32_t BindlessHeap::registerImage(VkImageView view, VkImageLayout layout)
+{
+    const uint32_t handle = allocate(Kind::SampledImage);
+    const VkDescriptorImageInfo imageInfo { .imageView = view, .imageLayout = layout };
+    write(Kind::SampledImage, handle, &imageInfo, nullptr);
+    return handle;
+}
+
+uint32_t BindlessHeap::registerSampler(VkSampler sampler)
+{
+    const uint32_t handle = allocate(Kind::Sampler);
+    const VkDescriptorImageInfo imageInfo { .sampler = sampler };
+    write(Kind::Sampler, handle, &imageInfo, nullptr);
+    return handle;
+}
+
+uint32_t BindlessHeap::registerStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+{
+    const uint32_t handle = allocate(Kind::StorageBuffer);
+    const VkDescriptorBufferInfo bufferInfo { .buffer = buffer, .offset = offset, .range = range };
+    write(Kind::StorageBuffer, handle, nullptr, &bufferInfo);
+    return handle;
+}
+
+void BindlessHeap::release(Kind kind, uint32_t handle)
+{
+    if (handle != INVALID_HANDLE)
+    {
+        pendingReleases_.push_back({ kind, handle, frameNumber_ });
+    }
+}
+
+void BindlessHeap::beginFrame()
+{
+    frameNumber_++;
+    while (!pendingReleases_.empty() && pendingReleases_.front().frame + frameCount_ <= frameNumber_)
+    {
+        const PendingRelease& release = pendingReleases_.front();
+        allocators_[static_cast<uint32_t>(release.kind)].free(release.handle);
+        pendingReleases_.pop_front();
+    }
+}
+
+void BindlessHeap::bind(VkCommandBuffer cb, VkPipelineBindPoint bindPoint, VkPipelineLayout layout) const
+{
+    vkCmdBindDescriptorSets(cb, bindPoint, layout, 0, 1, &set_, 0, nullptr);
+}
+
+BindlessHeap::Stats BindlessHeap::stats() const
+{
+    Stats stats;
+    for (size_t i = 0; i < allocators_.size(); i++)
+    {
+        stats.used[i] = allocators_[i].used();
+        stats.capacity[i] = allocators_[i].capacity();
+    }
+    return stats;
+}
+
+uint32_t BindlessHeap::allocate(Kind kind)
+{
+    const auto handle = allocators_[static_cast<uint32_t>(kind)].allocate();
+    if (!handle)
+    {
+        throw std::runtime_error(std::format("Bindless heap is out of {} slots",
+                                             KIND_NAMES[static_cast<uint32_t>(kind)]));
+    }
+    return *handle;
+}
+
+void BindlessHeap::write(Kind kind, uint32_t handle, const VkDescriptorImageInfo* pImageInfo,
+                         const VkDescriptorBufferInfo* pBufferInfo) const
+{
+    const VkWriteDescriptorSet write {
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = set_,
+        .dstBinding = static_cast<uint32_t>(kind),
+        .dstArrayElement = handle,
+        .descriptorCount = 1,
+        .descriptorType = KIND_TYPES[static_cast<uint32_t>(kind)],
+        .pImageInfo = pImageInfo,
+        .pBufferInfo = pBufferInfo,
+    };
+    vkUpdateDescriptorSets(device_, 1, &write, 0, nullptr);
+}
+} // spectra
@@ -0,0 +1,107 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_BINDLESSHEAP_H
+#define SPECTRA_BINDLESSHEAP_H
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "vk/Context.h"
+
+namespace spectra {
+// Hands out stable indices in [0, capacity). Freed indices are reused, so the range stays dense.
+class HandleAllocator {
+public:
+    HandleAllocator() = default;
+    explicit HandleAllocator(uint32_t capacity) : capacity_(capacity) {}
+
+    std::optional<uint32_t> allocate();
+    void free(uint32_t handle);
+
+    [[nodiscard]] uint32_t capacity() const { return capacity_; }
+    [[nodiscard]] uint32_t used() const { return next_ - static_cast<uint32_t>(freeList_.size()); }
+
+private:
+    uint32_t capacity_ = 0;
+    uint32_t next_ = 0; // Handles below this have been handed out at least once
+    std::vector<uint32_t> freeList_;
+};
+
+// One descriptor set holding every sampled image, sampler and storage buffer the shaders can reach. It is bound
+// once per command buffer and resources are addressed by their index, typically passed through push constants or
+// stored in materials, so draws never bind or allocate descriptor sets. The set is update-after-bind and partially
+// bound: registering a resource writes its slot while frames using other slots are in flight. Released slots are
+// only reused once every frame that could have read them has retired. Not thread safe.
+class BindlessHeap {
+public:
+    // Binding numbers, mirrored by shaders/bindless.slang
+    enum class Kind : uint32_t
+    {
+        SampledImage = 0,
+        Sampler = 1,
+        StorageBuffer = 2,
+    };
+
+    static constexpr uint32_t INVALID_HANDLE = ~0U;
+
+    struct Stats
+    {
+        std::array<uint32_t, 3> used{};
+        std::array<uint32_t, 3> capacity{};
+    };
+
+    BindlessHeap(std::shared_ptr<vk::Context> pCtx, uint32_t frameCount, uint32_t maxImages = 16384,
+                 uint32_t maxSamplers = 256, uint32_t maxStorageBuffers = 4096);
+    ~BindlessHeap();
+
+    BindlessHeap(const BindlessHeap&) = delete;
+    BindlessHeap& operator=(const BindlessHeap&) = delete;
+
+    // Throw when the heap is full
+    uint32_t registerImage(VkImageView view, VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    uint32_t registerSampler(VkSampler sampler);
+    uint32_t registerStorageBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+    // The resource itself must outlive the frames in flight, the slot is recycled after them
+    void release(Kind kind, uint32_t handle);
+
+    // Recycles slots released frameCount frames ago, call once per frame after the frame slot wait
+    void beginFrame();
+
+    void bind(VkCommandBuffer cb, VkPipelineBindPoint bindPoint, VkPipelineLayout layout) const;
+
+    [[nodiscard]] VkDescriptorSetLayout setLayout() const { return setLayout_; }
+    [[nodiscard]] Stats stats() const;
+
+private:
+    struct PendingRelease
+    {
+        Kind kind;
+        uint32_t handle;
+        uint64_t frame; // Frame number the release was requested in
+    };
+
+    uint32_t allocate(Kind kind);
+    void write(Kind kind, uint32_t handle, const VkDescriptorImageInfo* pImageInfo,
+               const VkDescriptorBufferInfo* pBufferInfo) const;
+
+    std::shared_ptr<vk::Context> pCtx_;
+    VkDevice device_ = VK_NULL_HANDLE;
+    uint32_t frameCount_ = 0;
+
+    VkDescriptorSetLayout setLayout_ = VK_NULL_HANDLE;
+    VkDescriptorPool pool_ = VK_NULL_HANDLE;
+    VkDescriptorSet set_ = VK_NULL_HANDLE;
+
+    std::array<HandleAllocator, 3> allocators_;
+    std::deque<PendingRelease> pendingReleases_;
+    uint64_t frameNumber_ = 0;
+};
+} // spectra
+
+#endif //SPECTRA_BINDLESSHEAP_H
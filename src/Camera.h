@@ -0,0 +1,35 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_CAMERA_H
+#define SPECTRA_CAMERA_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace spectra {
+struct Camera
+{
+    glm::vec3 position{ 0.0f, 0.0f, 3.0f };
+    glm::vec3 target{ 0.0f };
+    glm::vec3 up{ 0.0f, 1.0f, 0.0f };
+    float fovY = glm::radians(60.0f);
+    float nearPlane = 0.1f;
+    float farPlane = 1000.0f;
+
+    [[nodiscard]] glm::mat4 view() const { return glm::lookAt(position, target, up); }
+
+    [[nodiscard]] glm::mat4 projection(float aspect) const
+    {
+        // Vulkan clip depth runs from 0 at the near plane to 1 at the far plane, GL's -1 would clip the nearest part
+        glm::mat4 proj = glm::perspectiveRH_ZO(fovY, aspect, nearPlane, farPlane);
+        proj[1][1] *= -1.0f; // Vulkan clip space has Y pointing down
+        return proj;
+    }
+
+    [[nodiscard]] glm::mat4 viewProjection(float aspect) const { return projection(aspect) * view(); }
+};
+} // spectra
+
+#endif //SPECTRA_CAMERA_H
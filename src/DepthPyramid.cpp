@@ -0,0 +1,128 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "DepthPyramid.h"
+
+#include "vk/Error.h"
+
+namespace spectra {
+namespace {
+constexpr uint32_t BUILD_GROUP_SIZE = 8; // numthreads of shaders/depth_pyramid.slang
+
+void memoryBarrier(VkCommandBuffer cb, VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+                   VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess)
+{
+    const VkMemoryBarrier2 barrier {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+        .srcStageMask = srcStage,
+        .srcAccessMask = srcAccess,
+        .dstStageMask = dstStage,
+        .dstAccessMask = dstAccess,
+    };
+    const VkDependencyInfo dependencyInfo {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &barrier,
+    };
+    vkCmdPipelineBarrier2(cb, &dependencyInfo);
+}
+}
+
+DepthPyramid::DepthPyramid(VkDevice device, VmaAllocator allocator, uint32_t frameCount)
+    : device_(device), allocator_(allocator), buffers_(frameCount)
+{
+}
+
+DepthPyramid::~DepthPyramid()
+{
+    for (const PyramidBuffer& pyramid : buffers_)
+    {
+        if (pyramid.buffer != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(allocator_, pyramid.buffer, pyramid.alloc);
+        }
+    }
+}
+
+void DepthPyramid::beginFrame(uint32_t frameIndex, VkExtent2D depthExtent)
+{
+    frameIndex_ = frameIndex;
+    PyramidBuffer& pyramid = buffers_[frameIndex_];
+
+    Header header { .depthSize = { depthExtent.width, depthExtent.height } };
+    glm::uvec2 levelSize = header.depthSize;
+    uint32_t floatCount = 0;
+    while (header.levelCount < MAX_LEVELS)
+    {
+        levelSize = (levelSize + 1U) / 2U;
+        header.levels[header.levelCount++] = glm::uvec4(levelSize, floatCount, 0);
+        floatCount += levelSize.x * levelSize.y;
+        if (levelSize.x == 1 && levelSize.y == 1)
+        {
+            break;
+        }
+    }
+
+    // Resizing the window only grows the buffer, a frame slot's buffer is free once its previous frame has finished
+    const VkDeviceSize size = sizeof(Header) + floatCount * sizeof(float);
+    if (pyramid.capacity < size)
+    {
+        if (pyramid.buffer != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(allocator_, pyramid.buffer, pyramid.alloc);
+        }
+        const VkBufferCreateInfo bufferCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = size,
+            .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+                     VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+        };
+        const VmaAllocationCreateInfo allocCreateInfo { .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE };
+        CHECK_VK(vmaCreateBuffer(allocator_, &bufferCreateInfo, &allocCreateInfo, &pyramid.buffer, &pyramid.alloc,
+                                 nullptr));
+
+        const VkBufferDeviceAddressInfo addressInfo {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+            .buffer = pyramid.buffer,
+        };
+        pyramid.address = vkGetBufferDeviceAddress(device_, &addressInfo);
+        pyramid.capacity = size;
+    }
+
+    header.data = pyramid.address + sizeof(Header);
+    pyramid.header = header;
+}
+
+void DepthPyramid::recordBuild(VkCommandBuffer cb, VkPipeline pipeline, VkPipelineLayout layout,
+                               uint32_t depthTexture) const
+{
+    const PyramidBuffer& pyramid = buffers_[frameIndex_];
+
+    // The header is small enough to travel in the command buffer
+    vkCmdUpdateBuffer(cb, pyramid.buffer, 0, sizeof(Header), &pyramid.header);
+    memoryBarrier(cb, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                  VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    for (uint32_t level = 0; level < pyramid.header.levelCount; level++)
+    {
+        // Every level reads the one written before it
+        if (level > 0)
+        {
+            memoryBarrier(cb, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                          VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
+        }
+
+        const BuildConstants constants {
+            .pyramid = pyramid.address,
+            .depthTexture = depthTexture,
+            .level = level,
+        };
+        vkCmdPushConstants(cb, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(BuildConstants), &constants);
+        const glm::uvec4& extent = pyramid.header.levels[level];
+        vkCmdDispatch(cb, (extent.x + BUILD_GROUP_SIZE - 1) / BUILD_GROUP_SIZE,
+                      (extent.y + BUILD_GROUP_SIZE - 1) / BUILD_GROUP_SIZE, 1);
+    }
+}
+} // spectra
@@ -0,0 +1,77 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_DEPTHPYRAMID_H
+#define SPECTRA_DEPTHPYRAMID_H
+
+#include <array>
+#include <vector>
+#include <vk_mem_alloc.h>
+#include <glm/glm.hpp>
+
+namespace spectra {
+// Hierarchical max-depth buffer for occlusion culling. Level 0 halves the depth buffer, rounding up, and every further
+// level halves the one before down to 1x1; a texel keeps the farthest depth of the texels it covers, so anything
+// behind it is hidden. The levels live in one storage buffer per frame in flight that shaders reach by its device
+// address, the bindless heap has no storage images to build a mip chain with.
+class DepthPyramid {
+public:
+    static constexpr uint32_t MAX_LEVELS = 16;
+
+    // PyramidConstants in shaders/depth_pyramid.slang
+    struct BuildConstants
+    {
+        VkDeviceAddress pyramid;
+        uint32_t depthTexture;
+        uint32_t level;
+    };
+
+    DepthPyramid(VkDevice device, VmaAllocator allocator, uint32_t frameCount);
+    ~DepthPyramid();
+
+    DepthPyramid(const DepthPyramid&) = delete;
+    DepthPyramid& operator=(const DepthPyramid&) = delete;
+
+    // Sizes the pyramid of frame slot frameIndex, whose previous frame must have finished, for a depth buffer of
+    // depthExtent
+    void beginFrame(uint32_t frameIndex, VkExtent2D depthExtent);
+
+    // Records one dispatch per level, reading the depth buffer through the bindless image depthTexture. The caller
+    // orders the depth writes before it and the reads of the pyramid after it, the render graph does so from the
+    // usages of the depth image and buffer().
+    void recordBuild(VkCommandBuffer cb, VkPipeline pipeline, VkPipelineLayout layout, uint32_t depthTexture) const;
+
+    [[nodiscard]] VkBuffer buffer() const { return buffers_[frameIndex_].buffer; }
+    // DepthPyramid in shaders/scene.slang
+    [[nodiscard]] VkDeviceAddress address() const { return buffers_[frameIndex_].address; }
+    [[nodiscard]] uint32_t levelCount() const { return buffers_[frameIndex_].header.levelCount; }
+
+private:
+    // DepthPyramid in shaders/scene.slang, the levels follow it in the same buffer
+    struct Header
+    {
+        VkDeviceAddress data = 0;
+        glm::uvec2 depthSize{ 0 };
+        uint32_t levelCount = 0;
+        std::array<uint32_t, 3> padding{};
+        std::array<glm::uvec4, MAX_LEVELS> levels{}; // Width, height and offset into data in floats
+    };
+
+    struct PyramidBuffer
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation alloc = VK_NULL_HANDLE;
+        VkDeviceAddress address = 0;
+        VkDeviceSize capacity = 0;
+        Header header;
+    };
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VmaAllocator allocator_ = VK_NULL_HANDLE;
+    std::vector<PyramidBuffer> buffers_; // Per frame in flight
+    uint32_t frameIndex_ = 0;
+};
+} // spectra
+
+#endif //SPECTRA_DEPTHPYRAMID_H
@@ -0,0 +1,138 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "DrawListBuilder.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
+namespace spectra {
+namespace {
+constexpr uint32_t RADIX_BITS = 8;
+constexpr uint32_t RADIX_BUCKETS = 1U << RADIX_BITS;
+constexpr uint32_t RADIX_PASSES = 64 / RADIX_BITS;
+}
+
+uint64_t DrawListBuilder::makeKey(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth)
+{
+    constexpr uint32_t maxDepth = (1U << DEPTH_BITS) - 1;
+    const auto quantizedDepth = static_cast<uint32_t>(std::clamp(depth, 0.0f, 1.0f) * static_cast<float>(maxDepth));
+
+    return static_cast<uint64_t>(pipeline & ((1U << PIPELINE_BITS) - 1)) << (MATERIAL_BITS + MESH_BITS + DEPTH_BITS) |
+           static_cast<uint64_t>(material & ((1U << MATERIAL_BITS) - 1)) << (MESH_BITS + DEPTH_BITS) |
+           static_cast<uint64_t>(mesh & ((1U << MESH_BITS) - 1)) << DEPTH_BITS |
+           quantizedDepth;
+}
+
+void DrawListBuilder::begin()
+{
+    entries_.clear();
+    stats_ = {};
+}
+
+void DrawListBuilder::add(uint64_t key, uint32_t item)
+{
+    if (!entries_.empty())
+    {
+        const uint64_t previous = entries_.back().key;
+        stats_.unsortedPipelineBinds += keyPipeline(previous) != keyPipeline(key);
+        stats_.unsortedMaterialBinds += keyPipeline(previous) != keyPipeline(key) || keyMaterial(previous) != keyMaterial(key);
+    }
+    else
+    {
+        stats_.unsortedPipelineBinds = 1;
+        stats_.unsortedMaterialBinds = 1;
+    }
+
+    entries_.push_back({ key, item });
+}
+
+void DrawListBuilder::build(bool sortAndMerge)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    if (sortAndMerge)
+    {
+        radixSort();
+    }
+
+    batches_.clear();
+    instances_.resize(entries_.size());
+    for (uint32_t i = 0; i < entries_.size(); i++)
+    {
+        const Entry& entry = entries_[i];
+        instances_[i] = entry.item;
+
+        // Keys equal above the depth bits share pipeline, material and mesh, so the draws collapse into one
+        if (sortAndMerge && !batches_.empty() && (batches_.back().key >> DEPTH_BITS) == (entry.key >> DEPTH_BITS))
+        {
+            batches_.back().instanceCount++;
+            continue;
+        }
+
+        if (batches_.empty() || keyPipeline(batches_.back().key) != keyPipeline(entry.key))
+        {
+            stats_.pipelineBinds++;
+            stats_.materialBinds++;
+        }
+        else if (keyMaterial(batches_.back().key) != keyMaterial(entry.key))
+        {
+            stats_.materialBinds++;
+        }
+        batches_.push_back({ entry.key, i, 1 });
+    }
+
+    stats_.draws = static_cast<uint32_t>(entries_.size());
+    stats_.drawCalls = static_cast<uint32_t>(batches_.size());
+    stats_.buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void DrawListBuilder::radixSort()
+{
+    if (entries_.size() < 2)
+    {
+        return;
+    }
+
+    // One pass over the keys fills the histograms of every digit
+    std::array<std::array<uint32_t, RADIX_BUCKETS>, RADIX_PASSES> histograms{};
+    for (const Entry& entry : entries_)
+    {
+        for (uint32_t pass = 0; pass < RADIX_PASSES; pass++)
+        {
+            histograms[pass][(entry.key >> (pass * RADIX_BITS)) & (RADIX_BUCKETS - 1)]++;
+        }
+    }
+
+    scratch_.resize(entries_.size());
+    const auto count = static_cast<uint32_t>(entries_.size());
+    for (uint32_t pass = 0; pass < RADIX_PASSES; pass++)
+    {
+        auto& histogram = histograms[pass];
+        const uint32_t shift = pass * RADIX_BITS;
+
+        // Pipeline and material bits rarely vary within a frame, a digit every key shares leaves the order as is
+        if (histogram[(entries_.front().key >> shift) & (RADIX_BUCKETS - 1)] == count)
+        {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t& bucket : histogram)
+        {
+            const uint32_t bucketSize = bucket;
+            bucket = offset;
+            offset += bucketSize;
+        }
+
+        // Stable scatter, so lower digits sorted by earlier passes stay in order
+        for (const Entry& entry : entries_)
+        {
+            scratch_[histogram[(entry.key >> shift) & (RADIX_BUCKETS - 1)]++] = entry;
+        }
+        entries_.swap(scratch_);
+    }
+}
+} // spectra
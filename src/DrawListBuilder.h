@@ -0,0 +1,83 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_DRAWLISTBUILDER_H
+#define SPECTRA_DRAWLISTBUILDER_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace spectra {
+// Orders a frame's draws by a 64-bit key and merges draws of the same mesh with the same state into instanced
+// draws. The key packs, from most to least significant, pipeline | material | mesh | depth, so a radix sort groups
+// draws by pipeline first, then material, and identical meshes end up adjacent in front-to-back order. Each
+// resulting batch covers a contiguous range of instances, which the caller backs with a per-instance buffer.
+class DrawListBuilder {
+public:
+    // A frame draws with at most one pipeline per scene feature combination
+    static constexpr uint32_t PIPELINE_BITS = 4;
+    static constexpr uint32_t MATERIAL_BITS = 16;
+    // The renderer keys draws by their LOD across all primitives, which outnumber meshes several times
+    static constexpr uint32_t MESH_BITS = 24;
+    static constexpr uint32_t DEPTH_BITS = 20;
+    static_assert(PIPELINE_BITS + MATERIAL_BITS + MESH_BITS + DEPTH_BITS == 64);
+
+    struct Batch
+    {
+        uint64_t key = 0; // Key of the first instance, pipeline/material/mesh are shared by the whole batch
+        uint32_t firstInstance = 0; // Into instances()
+        uint32_t instanceCount = 0;
+    };
+
+    struct Stats
+    {
+        uint32_t draws = 0;     // Draws added
+        uint32_t drawCalls = 0; // Batches after merging
+        uint32_t pipelineBinds = 0;
+        uint32_t materialBinds = 0;
+        // State changes the draws would have needed in the order they were added
+        uint32_t unsortedPipelineBinds = 0;
+        uint32_t unsortedMaterialBinds = 0;
+        double buildMs = 0.0;
+    };
+
+    // depth is the normalized view depth in [0, 1], values outside are clamped
+    static uint64_t makeKey(uint32_t pipeline, uint32_t material, uint32_t mesh, float depth);
+    static uint32_t keyPipeline(uint64_t key) { return static_cast<uint32_t>(key >> (64 - PIPELINE_BITS)); }
+    static uint32_t keyMaterial(uint64_t key)
+    {
+        return static_cast<uint32_t>(key >> (MESH_BITS + DEPTH_BITS)) & ((1U << MATERIAL_BITS) - 1);
+    }
+    static uint32_t keyMesh(uint64_t key) { return static_cast<uint32_t>(key >> DEPTH_BITS) & ((1U << MESH_BITS) - 1); }
+
+    void begin();
+    // `item` is an opaque caller index, it comes back through instances() in batch order
+    void add(uint64_t key, uint32_t item);
+    // Without sorting every draw keeps its position and becomes a batch of one
+    void build(bool sortAndMerge = true);
+
+    [[nodiscard]] std::span<const Batch> batches() const { return batches_; }
+    [[nodiscard]] std::span<const uint32_t> instances() const { return instances_; }
+    [[nodiscard]] const Stats& stats() const { return stats_; }
+
+private:
+    struct Entry
+    {
+        uint64_t key;
+        uint32_t item;
+    };
+
+    // LSD radix sort on 8-bit digits, digits shared by every key are skipped
+    void radixSort();
+
+    std::vector<Entry> entries_;
+    std::vector<Entry> scratch_;
+    std::vector<Batch> batches_;
+    std::vector<uint32_t> instances_;
+    Stats stats_{};
+};
+} // spectra
+
+#endif //SPECTRA_DRAWLISTBUILDER_H
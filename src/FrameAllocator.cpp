@@ -0,0 +1,91 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "FrameAllocator.h"
+
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+
+#include "vk/Error.h"
+
+namespace spectra {
+FrameAllocator::FrameAllocator(VkDevice device, VmaAllocator allocator, const VkPhysicalDeviceLimits& limits,
+                               uint32_t frameCount, VkDeviceSize bytesPerFrame)
+    : allocator_(allocator)
+{
+    uniformAlignment_ = std::max<VkDeviceSize>(limits.minUniformBufferOffsetAlignment, 16);
+    storageAlignment_ = std::max<VkDeviceSize>(limits.minStorageBufferOffsetAlignment, 16);
+
+    // Frame regions start on an alignment every kind of allocation accepts
+    const VkDeviceSize regionAlignment = std::max({ uniformAlignment_, storageAlignment_, limits.nonCoherentAtomSize });
+    bytesPerFrame_ = (bytesPerFrame + regionAlignment - 1) / regionAlignment * regionAlignment;
+
+    VkBufferCreateInfo bufferCreateInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = bytesPerFrame_ * frameCount,
+        .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT |
+                 VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+    };
+    // Prefers device-local host-visible memory (ReBAR) and falls back to system memory
+    VmaAllocationCreateInfo allocCreateInfo
+    {
+        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+    };
+    VmaAllocationInfo allocInfo{};
+    CHECK_VK(vmaCreateBuffer(allocator_, &bufferCreateInfo, &allocCreateInfo, &buffer_, &allocation_, &allocInfo));
+    pMapped_ = static_cast<uint8_t*>(allocInfo.pMappedData);
+
+    const VkBufferDeviceAddressInfo addressInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .buffer = buffer_,
+    };
+    baseAddress_ = vkGetBufferDeviceAddress(device, &addressInfo);
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    vmaDestroyBuffer(allocator_, buffer_, allocation_);
+}
+
+void FrameAllocator::beginFrame(uint32_t frameIndex)
+{
+    frameBegin_ = bytesPerFrame_ * frameIndex;
+    cursor_ = frameBegin_;
+}
+
+void FrameAllocator::endFrame()
+{
+    peakBytes_ = std::max(peakBytes_, usedBytes());
+
+    // No-op on coherent memory
+    if (cursor_ > frameBegin_)
+    {
+        CHECK_VK(vmaFlushAllocation(allocator_, allocation_, frameBegin_, cursor_ - frameBegin_));
+    }
+}
+
+FrameAllocator::Allocation FrameAllocator::allocate(VkDeviceSize size, VkDeviceSize alignment)
+{
+    const VkDeviceSize offset = (cursor_ + alignment - 1) / alignment * alignment;
+    if (offset + size > frameBegin_ + bytesPerFrame_)
+    {
+        throw std::runtime_error(std::format("Frame allocator exhausted: {} bytes requested, {} of {} bytes used",
+                                             size, usedBytes(), bytesPerFrame_));
+    }
+    cursor_ = offset + size;
+
+    return Allocation {
+        .pData = pMapped_ + offset,
+        .buffer = buffer_,
+        .offset = offset,
+        .address = baseAddress_ + offset,
+        .size = size,
+    };
+}
+} // spectra
@@ -0,0 +1,82 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_FRAMEALLOCATOR_H
+#define SPECTRA_FRAMEALLOCATOR_H
+
+#include <cstring>
+#include <span>
+#include <vk_mem_alloc.h>
+
+namespace spectra {
+// Bump allocator for data that lives for a single frame (uniforms, instance data, dynamic vertices). Each frame in
+// flight owns a region of one persistently mapped buffer; the region is reset by beginFrame() once that frame
+// has finished, so allocating is a pointer bump and never touches the driver.
+class FrameAllocator {
+public:
+    struct Allocation
+    {
+        void* pData = nullptr;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;          // Offset into buffer, for descriptor or vertex/index buffer binds
+        VkDeviceAddress address = 0;      // Device address of pData, for shader pointers
+        VkDeviceSize size = 0;
+    };
+
+    FrameAllocator(VkDevice device, VmaAllocator allocator, const VkPhysicalDeviceLimits& limits,
+                   uint32_t frameCount, VkDeviceSize bytesPerFrame = 16ULL << 20);
+    ~FrameAllocator();
+
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    // Must only be called once the GPU has finished the previous use of frameIndex
+    void beginFrame(uint32_t frameIndex);
+    // Makes this frame's writes visible to the device, call before submitting
+    void endFrame();
+
+    Allocation allocate(VkDeviceSize size, VkDeviceSize alignment = 16);
+    Allocation allocateUniform(VkDeviceSize size) { return allocate(size, uniformAlignment_); }
+    Allocation allocateStorage(VkDeviceSize size) { return allocate(size, storageAlignment_); }
+
+    template <typename T>
+    Allocation push(const T& value, VkDeviceSize alignment = alignof(T) < 16 ? 16 : alignof(T))
+    {
+        Allocation allocation = allocate(sizeof(T), alignment);
+        *static_cast<T*>(allocation.pData) = value;
+        return allocation;
+    }
+
+    template <typename T>
+    Allocation push(std::span<const T> values, VkDeviceSize alignment = alignof(T) < 16 ? 16 : alignof(T))
+    {
+        Allocation allocation = allocate(values.size_bytes(), alignment);
+        memcpy(allocation.pData, values.data(), values.size_bytes());
+        return allocation;
+    }
+
+    [[nodiscard]] VkDeviceSize bytesPerFrame() const { return bytesPerFrame_; }
+    [[nodiscard]] VkDeviceSize usedBytes() const { return cursor_ - frameBegin_; }
+    // High-water mark of any frame, for sizing bytesPerFrame
+    [[nodiscard]] VkDeviceSize peakBytes() const { return peakBytes_; }
+
+private:
+    VmaAllocator allocator_ = VK_NULL_HANDLE;
+
+    VkBuffer buffer_ = VK_NULL_HANDLE;
+    VmaAllocation allocation_{};
+    uint8_t* pMapped_ = nullptr;
+    VkDeviceAddress baseAddress_ = 0;
+
+    VkDeviceSize bytesPerFrame_ = 0;
+    VkDeviceSize uniformAlignment_ = 16;
+    VkDeviceSize storageAlignment_ = 16;
+
+    VkDeviceSize frameBegin_ = 0;
+    VkDeviceSize cursor_ = 0;
+    VkDeviceSize peakBytes_ = 0;
+};
+} // spectra
+
+#endif //SPECTRA_FRAMEALLOCATOR_H
@@ -0,0 +1,338 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "FrustumCuller.h"
+
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <future>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SPECTRA_CULL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+// MSVC compiles AVX intrinsics without per-function target flags
+#define SPECTRA_TARGET_AVX2
+#else
+#define SPECTRA_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace spectra {
+namespace {
+struct BoxArrays
+{
+    const float* centerX;
+    const float* centerY;
+    const float* centerZ;
+    const float* extentX;
+    const float* extentY;
+    const float* extentZ;
+};
+
+// Plane terms split per component, |n| lets the box extent be projected without testing all 8 corners
+struct PlaneTerms
+{
+    std::array<float, 6> nx;
+    std::array<float, 6> ny;
+    std::array<float, 6> nz;
+    std::array<float, 6> absX;
+    std::array<float, 6> absY;
+    std::array<float, 6> absZ;
+    std::array<float, 6> w;
+
+    explicit PlaneTerms(const Frustum& frustum)
+    {
+        for (size_t i = 0; i < 6; i++)
+        {
+            const glm::vec4& plane = frustum.planes[i];
+            nx[i] = plane.x;
+            ny[i] = plane.y;
+            nz[i] = plane.z;
+            absX[i] = std::abs(plane.x);
+            absY[i] = std::abs(plane.y);
+            absZ[i] = std::abs(plane.z);
+            w[i] = plane.w;
+        }
+    }
+};
+
+void cullScalar(const PlaneTerms& planes, const BoxArrays& boxes, uint32_t first, uint32_t last,
+                std::vector<uint32_t>& visible)
+{
+    for (uint32_t i = first; i < last; i++)
+    {
+        bool inside = true;
+        for (size_t p = 0; p < 6 && inside; p++)
+        {
+            // Distance of the box corner furthest along the plane normal
+            const float distance = planes.nx[p] * boxes.centerX[i] + planes.ny[p] * boxes.centerY[i] +
+                                   planes.nz[p] * boxes.centerZ[i] + planes.w[p] +
+                                   planes.absX[p] * boxes.extentX[i] + planes.absY[p] * boxes.extentY[i] +
+                                   planes.absZ[p] * boxes.extentZ[i];
+            inside = distance >= 0.0f;
+        }
+        if (inside)
+        {
+            visible.push_back(i);
+        }
+    }
+}
+
+#ifdef SPECTRA_CULL_X86
+void appendMask(uint32_t base, uint32_t mask, std::vector<uint32_t>& visible)
+{
+    while (mask != 0)
+    {
+        visible.push_back(base + static_cast<uint32_t>(std::countr_zero(mask)));
+        mask &= mask - 1;
+    }
+}
+
+void cullSse(const PlaneTerms& planes, const BoxArrays& boxes, uint32_t first, uint32_t last,
+             std::vector<uint32_t>& visible)
+{
+    uint32_t i = first;
+    for (; i + 4 <= last; i += 4)
+    {
+        const __m128 centerX = _mm_loadu_ps(boxes.centerX + i);
+        const __m128 centerY = _mm_loadu_ps(boxes.centerY + i);
+        const __m128 centerZ = _mm_loadu_ps(boxes.centerZ + i);
+        const __m128 extentX = _mm_loadu_ps(boxes.extentX + i);
+        const __m128 extentY = _mm_loadu_ps(boxes.extentY + i);
+        const __m128 extentZ = _mm_loadu_ps(boxes.extentZ + i);
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (size_t p = 0; p < 6; p++)
+        {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.nx[p]), centerX),
+                                         _mm_mul_ps(_mm_set1_ps(planes.ny[p]), centerY));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.nz[p]), centerZ));
+            distance = _mm_add_ps(distance, _mm_set1_ps(planes.w[p]));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.absX[p]), extentX));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.absY[p]), extentY));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(planes.absZ[p]), extentZ));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+        }
+        appendMask(i, static_cast<uint32_t>(_mm_movemask_ps(inside)), visible);
+    }
+    cullScalar(planes, boxes, i, last, visible);
+}
+
+SPECTRA_TARGET_AVX2
+void cullAvx2(const PlaneTerms& planes, const BoxArrays& boxes, uint32_t first, uint32_t last,
+              std::vector<uint32_t>& visible)
+{
+    uint32_t i = first;
+    for (; i + 8 <= last; i += 8)
+    {
+        const __m256 centerX = _mm256_loadu_ps(boxes.centerX + i);
+        const __m256 centerY = _mm256_loadu_ps(boxes.centerY + i);
+        const __m256 centerZ = _mm256_loadu_ps(boxes.centerZ + i);
+        const __m256 extentX = _mm256_loadu_ps(boxes.extentX + i);
+        const __m256 extentY = _mm256_loadu_ps(boxes.extentY + i);
+        const __m256 extentZ = _mm256_loadu_ps(boxes.extentZ + i);
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (size_t p = 0; p < 6; p++)
+        {
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.nx[p]), centerX),
+                                            _mm256_mul_ps(_mm256_set1_ps(planes.ny[p]), centerY));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.nz[p]), centerZ));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(planes.w[p]));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.absX[p]), extentX));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.absY[p]), extentY));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(planes.absZ[p]), extentZ));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+        appendMask(i, static_cast<uint32_t>(_mm256_movemask_ps(inside)), visible);
+    }
+    // The SSE kernel takes the remainder, its own tail goes scalar
+    cullSse(planes, boxes, i, last, visible);
+}
+
+bool cpuSupportsAvx2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    // The OS must save the YMM registers on context switches as well
+    __cpuid(info, 1);
+    const bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+    __cpuidex(info, 7, 0);
+    return osSavesAvx && (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+}
+
+Frustum Frustum::fromViewProjection(const glm::mat4& viewProjection)
+{
+    // Gribb/Hartmann plane extraction from the rows of the clip matrix
+    const glm::mat4 m = glm::transpose(viewProjection);
+    Frustum frustum;
+    frustum.planes[0] = m[3] + m[0]; // Left
+    frustum.planes[1] = m[3] - m[0]; // Right
+    frustum.planes[2] = m[3] + m[1]; // Bottom
+    frustum.planes[3] = m[3] - m[1]; // Top
+    frustum.planes[4] = m[2];        // Near, clip depth starts at 0 in Vulkan
+    frustum.planes[5] = m[3] - m[2]; // Far
+
+    for (auto& plane : frustum.planes)
+    {
+        plane /= glm::length(glm::vec3(plane));
+    }
+    return frustum;
+}
+
+FrustumCuller::FrustumCuller()
+    : kernel_(bestSupportedKernel())
+{
+}
+
+void FrustumCuller::resize(uint32_t count)
+{
+    centerX_.resize(count);
+    centerY_.resize(count);
+    centerZ_.resize(count);
+    extentX_.resize(count);
+    extentY_.resize(count);
+    extentZ_.resize(count);
+}
+
+void FrustumCuller::setBounds(uint32_t index, const glm::vec3& min, const glm::vec3& max)
+{
+    const glm::vec3 center = (min + max) * 0.5f;
+    const glm::vec3 extent = (max - min) * 0.5f;
+    centerX_[index] = center.x;
+    centerY_[index] = center.y;
+    centerZ_[index] = center.z;
+    extentX_[index] = extent.x;
+    extentY_[index] = extent.y;
+    extentZ_[index] = extent.z;
+}
+
+void FrustumCuller::cull(const Frustum& frustum, std::vector<uint32_t>& visible, ThreadPool* pThreadPool)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    visible.clear();
+    const uint32_t count = size();
+    if (pThreadPool && pThreadPool->size() > 1 && count >= PARALLEL_MIN_OBJECTS)
+    {
+        // Chunks start on a multiple of 8 so only the last one runs a scalar tail
+        const auto chunkCount = static_cast<uint32_t>(pThreadPool->size());
+        const uint32_t chunkSize = ((count + chunkCount - 1) / chunkCount + 7) & ~7U;
+        chunkResults_.resize(chunkCount);
+
+        std::vector<std::future<void>> jobs;
+        jobs.reserve(chunkCount);
+        for (uint32_t chunk = 0; chunk < chunkCount; chunk++)
+        {
+            const uint32_t first = std::min(chunk * chunkSize, count);
+            const uint32_t last = std::min(first + chunkSize, count);
+            jobs.push_back(pThreadPool->submit([this, &frustum, chunk, first, last]
+            {
+                chunkResults_[chunk].clear();
+                cullRange(frustum, first, last, chunkResults_[chunk]);
+            }));
+        }
+        for (auto& job : jobs)
+        {
+            job.get();
+        }
+
+        for (const auto& chunkVisible : chunkResults_)
+        {
+            visible.insert(visible.end(), chunkVisible.begin(), chunkVisible.end());
+        }
+    }
+    else
+    {
+        cullRange(frustum, 0, count, visible);
+    }
+
+    stats_ = {
+        .tested = count,
+        .visible = static_cast<uint32_t>(visible.size()),
+        .cullMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(),
+    };
+}
+
+FrustumCuller::Kernel FrustumCuller::bestSupportedKernel()
+{
+    if (isSupported(Kernel::Avx2))
+    {
+        return Kernel::Avx2;
+    }
+    return isSupported(Kernel::Sse) ? Kernel::Sse : Kernel::Scalar;
+}
+
+bool FrustumCuller::isSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef SPECTRA_CULL_X86
+    case Kernel::Avx2:
+    {
+        static const bool supported = cpuSupportsAvx2();
+        return supported;
+    }
+    case Kernel::Sse:
+        // Part of the x86-64 baseline
+        return true;
+#endif
+    case Kernel::Scalar:
+        return true;
+    default:
+        return false;
+    }
+}
+
+const char* FrustumCuller::kernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case Kernel::Avx2:
+        return "AVX2";
+    case Kernel::Sse:
+        return "SSE";
+    default:
+        return "scalar";
+    }
+}
+
+void FrustumCuller::cullRange(const Frustum& frustum, uint32_t first, uint32_t last,
+                              std::vector<uint32_t>& visible) const
+{
+    const PlaneTerms planes(frustum);
+    const BoxArrays boxes {
+        centerX_.data(), centerY_.data(), centerZ_.data(),
+        extentX_.data(), extentY_.data(), extentZ_.data(),
+    };
+
+    switch (kernel_)
+    {
+#ifdef SPECTRA_CULL_X86
+    case Kernel::Avx2:
+        cullAvx2(planes, boxes, first, last, visible);
+        break;
+    case Kernel::Sse:
+        cullSse(planes, boxes, first, last, visible);
+        break;
+#endif
+    default:
+        cullScalar(planes, boxes, first, last, visible);
+        break;
+    }
+}
+} // spectra
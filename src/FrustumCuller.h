@@ -0,0 +1,81 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_FRUSTUMCULLER_H
+#define SPECTRA_FRUSTUMCULLER_H
+
+#include <array>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "ThreadPool.h"
+
+namespace spectra {
+struct Frustum
+{
+    // xyz is the inward normal, a point p is inside a plane when dot(xyz, p) + w >= 0
+    std::array<glm::vec4, 6> planes{};
+
+    // Expects a Vulkan projection with depth in [0, 1]
+    static Frustum fromViewProjection(const glm::mat4& viewProjection);
+};
+
+// Tests world-space AABBs against a frustum. Boxes are stored as center/extent structure-of-arrays so the kernels
+// test 4 (SSE) or 8 (AVX2) boxes per plane at once; the widest kernel the CPU supports is picked at runtime and a
+// scalar kernel covers other architectures. Large sets are split into chunks culled on a thread pool.
+class FrustumCuller {
+public:
+    enum class Kernel
+    {
+        Scalar,
+        Sse,
+        Avx2,
+    };
+
+    struct Stats
+    {
+        uint32_t tested = 0;
+        uint32_t visible = 0;
+        double cullMs = 0.0;
+    };
+
+    FrustumCuller();
+
+    void resize(uint32_t count);
+    void setBounds(uint32_t index, const glm::vec3& min, const glm::vec3& max);
+    [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(centerX_.size()); }
+
+    // Replaces `visible` with the indices of the boxes intersecting the frustum, in ascending order. The pool is
+    // only used for sets of at least PARALLEL_MIN_OBJECTS boxes.
+    void cull(const Frustum& frustum, std::vector<uint32_t>& visible, ThreadPool* pThreadPool = nullptr);
+
+    static Kernel bestSupportedKernel();
+    static bool isSupported(Kernel kernel);
+    static const char* kernelName(Kernel kernel);
+    // Falls back to the scalar kernel if the CPU does not support the requested one
+    void setKernel(Kernel kernel) { kernel_ = isSupported(kernel) ? kernel : Kernel::Scalar; }
+    [[nodiscard]] Kernel kernel() const { return kernel_; }
+
+    [[nodiscard]] const Stats& stats() const { return stats_; }
+
+    static constexpr uint32_t PARALLEL_MIN_OBJECTS = 16384;
+
+private:
+    // Appends the indices of visible boxes in [first, last) to visible
+    void cullRange(const Frustum& frustum, uint32_t first, uint32_t last, std::vector<uint32_t>& visible) const;
+
+    std::vector<float> centerX_;
+    std::vector<float> centerY_;
+    std::vector<float> centerZ_;
+    std::vector<float> extentX_;
+    std::vector<float> extentY_;
+    std::vector<float> extentZ_;
+
+    Kernel kernel_ = Kernel::Scalar;
+    Stats stats_{};
+    std::vector<std::vector<uint32_t>> chunkResults_;
+};
+} // spectra
+
+#endif //SPECTRA_FRUSTUMCULLER_H
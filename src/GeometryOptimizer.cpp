@@ -0,0 +1,169 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "GeometryOptimizer.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <meshoptimizer.h>
+
+namespace spectra {
+namespace {
+constexpr unsigned VERTEX_CACHE_SIZE = 16;
+// Overdraw optimization may raise ACMR by up to this factor
+constexpr float OVERDRAW_THRESHOLD = 1.05f;
+// Weight of backface cone tightness against spatial compactness when clustering
+constexpr float MESHLET_CONE_WEIGHT = 0.25f;
+// Target triangle count of a LOD relative to the level before it
+constexpr float LOD_REDUCTION = 0.5f;
+// Relative to the mesh extent, simplification stops short of the target rather than exceed it
+constexpr float LOD_MAX_ERROR = 0.1f;
+// A level has to drop at least this share of the triangles of the level before it to be kept
+constexpr float LOD_MIN_SAVING = 0.15f;
+constexpr size_t LOD_MIN_TRIANGLES = 32;
+
+VertexCacheMetrics analyze(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices, bool overdraw)
+{
+    const meshopt_VertexCacheStatistics cache = meshopt_analyzeVertexCache(indices.data(), indices.size(),
+                                                                           vertices.size(), VERTEX_CACHE_SIZE, 0, 0);
+    VertexCacheMetrics metrics { .acmr = cache.acmr, .atvr = cache.atvr };
+    if (overdraw)
+    {
+        metrics.overdraw = meshopt_analyzeOverdraw(indices.data(), indices.size(), &vertices[0].position.x,
+                                                   vertices.size(), sizeof(Vertex)).overdraw;
+    }
+    return metrics;
+}
+}
+
+GeometryOptimizeResult optimizeGeometry(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                        const GeometryOptimizeOptions& options)
+{
+    GeometryOptimizeResult result;
+    if (vertices.empty() || indices.empty() || indices.size() % 3 != 0)
+    {
+        return result;
+    }
+
+    result.before = analyze(vertices, indices, options.overdraw);
+    if (!options.optimize)
+    {
+        result.after = result.before;
+        return result;
+    }
+
+    meshopt_optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+    if (options.overdraw)
+    {
+        meshopt_optimizeOverdraw(indices.data(), indices.data(), indices.size(), &vertices[0].position.x,
+                                 vertices.size(), sizeof(Vertex), OVERDRAW_THRESHOLD);
+    }
+
+    // Vertices in first-use order, so the fetches of consecutive triangles hit the same cache lines
+    std::vector<Vertex> reordered(vertices.size());
+    const size_t vertexCount = meshopt_optimizeVertexFetch(reordered.data(), indices.data(), indices.size(),
+                                                           vertices.data(), vertices.size(), sizeof(Vertex));
+    reordered.resize(vertexCount);
+    vertices = std::move(reordered);
+
+    result.after = analyze(vertices, indices, options.overdraw);
+    return result;
+}
+
+void buildMeshlets(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                   std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletVertices,
+                   std::vector<uint8_t>& meshletTriangles)
+{
+    if (vertices.empty() || indices.empty() || indices.size() % 3 != 0)
+    {
+        return;
+    }
+
+    const size_t maxMeshlets = meshopt_buildMeshletsBound(indices.size(), MESHLET_MAX_VERTICES, MESHLET_MAX_TRIANGLES);
+    std::vector<meshopt_Meshlet> clusters(maxMeshlets);
+    std::vector<uint32_t> clusterVertices(maxMeshlets * MESHLET_MAX_VERTICES);
+    std::vector<uint8_t> clusterTriangles(maxMeshlets * MESHLET_MAX_TRIANGLES * 3);
+    const size_t count = meshopt_buildMeshlets(clusters.data(), clusterVertices.data(), clusterTriangles.data(),
+                                               indices.data(), indices.size(), &vertices[0].position.x,
+                                               vertices.size(), sizeof(Vertex), MESHLET_MAX_VERTICES,
+                                               MESHLET_MAX_TRIANGLES, MESHLET_CONE_WEIGHT);
+
+    const auto vertexBase = static_cast<uint32_t>(meshletVertices.size());
+    const auto triangleBase = static_cast<uint32_t>(meshletTriangles.size());
+    for (size_t i = 0; i < count; i++)
+    {
+        const meshopt_Meshlet& cluster = clusters[i];
+        meshopt_optimizeMeshlet(&clusterVertices[cluster.vertex_offset], &clusterTriangles[cluster.triangle_offset],
+                                cluster.triangle_count, cluster.vertex_count);
+        const meshopt_Bounds bounds = meshopt_computeMeshletBounds(
+            &clusterVertices[cluster.vertex_offset], &clusterTriangles[cluster.triangle_offset],
+            cluster.triangle_count, &vertices[0].position.x, vertices.size(), sizeof(Vertex));
+
+        meshlets.push_back({
+            .center = { bounds.center[0], bounds.center[1], bounds.center[2] },
+            .radius = bounds.radius,
+            .coneApex = { bounds.cone_apex[0], bounds.cone_apex[1], bounds.cone_apex[2] },
+            .coneCutoff = bounds.cone_cutoff,
+            .coneAxis = { bounds.cone_axis[0], bounds.cone_axis[1], bounds.cone_axis[2] },
+            .vertexOffset = vertexBase + cluster.vertex_offset,
+            .triangleOffset = triangleBase + cluster.triangle_offset,
+            .vertexCount = cluster.vertex_count,
+            .triangleCount = cluster.triangle_count,
+        });
+    }
+
+    // Every meshlet's triangle list is padded to four bytes, the last one ends the used range
+    if (count > 0)
+    {
+        const meshopt_Meshlet& last = clusters[count - 1];
+        meshletVertices.insert(meshletVertices.end(), clusterVertices.begin(),
+                               clusterVertices.begin() + last.vertex_offset + last.vertex_count);
+        meshletTriangles.insert(meshletTriangles.end(), clusterTriangles.begin(),
+                                clusterTriangles.begin() + last.triangle_offset + ((last.triangle_count * 3 + 3) & ~3U));
+    }
+}
+
+std::vector<LodLevel> buildLods(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices)
+{
+    std::vector<LodLevel> lods;
+    if (vertices.empty() || indices.size() % 3 != 0)
+    {
+        return lods;
+    }
+
+    // Errors come back relative to the mesh extent
+    const float scale = meshopt_simplifyScale(&vertices[0].position.x, vertices.size(), sizeof(Vertex));
+    std::vector<uint32_t> simplified(indices.size());
+    size_t previousCount = indices.size();
+    float previousError = 0.0f;
+    for (uint32_t level = 1; level < MAX_LODS; level++)
+    {
+        const size_t targetCount = static_cast<size_t>(static_cast<float>(previousCount) * LOD_REDUCTION) / 3 * 3;
+        if (targetCount < LOD_MIN_TRIANGLES * 3)
+        {
+            break;
+        }
+
+        // Every level starts from full detail, so its error is measured against the surface that was authored
+        float error = 0.0f;
+        const size_t count = meshopt_simplify(simplified.data(), indices.data(), indices.size(),
+                                              &vertices[0].position.x, vertices.size(), sizeof(Vertex), targetCount,
+                                              LOD_MAX_ERROR, 0, &error);
+        if (count == 0 || static_cast<float>(count) > static_cast<float>(previousCount) * (1.0f - LOD_MIN_SAVING))
+        {
+            break;
+        }
+
+        LodLevel& lod = lods.emplace_back();
+        lod.indices.assign(simplified.begin(), simplified.begin() + static_cast<ptrdiff_t>(count));
+        meshopt_optimizeVertexCache(lod.indices.data(), lod.indices.data(), count, vertices.size());
+        // Selection walks the chain until the error is too large, it must not shrink again further down
+        lod.error = std::max(error * scale, previousError);
+
+        previousCount = count;
+        previousError = lod.error;
+    }
+    return lods;
+}
+} // spectra
@@ -0,0 +1,82 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_GEOMETRYOPTIMIZER_H
+#define SPECTRA_GEOMETRYOPTIMIZER_H
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "VertexFormat.h"
+
+// Import-time geometry processing with meshoptimizer
+namespace spectra {
+// A cluster of up to MESHLET_MAX_VERTICES vertices and MESHLET_MAX_TRIANGLES triangles of one primitive, with the
+// bounds to cull it on its own. Stored in scene packages.
+struct Meshlet
+{
+    glm::vec3 center{ 0.0f }; // Bounding sphere, mesh space
+    float radius = 0.0f;
+    // Backfacing for every camera position p with dot(normalize(coneApex - p), coneAxis) >= coneCutoff
+    glm::vec3 coneApex{ 0.0f };
+    float coneCutoff = 1.0f;
+    glm::vec3 coneAxis{ 0.0f };
+    uint32_t vertexOffset = 0;   // Into the meshlet vertices, which index the primitive's vertices
+    uint32_t triangleOffset = 0; // Into the meshlet triangles, three bytes indexing the meshlet vertices each
+    uint32_t vertexCount = 0;
+    uint32_t triangleCount = 0;
+    uint32_t padding = 0;
+};
+
+constexpr uint32_t MESHLET_MAX_VERTICES = 64;
+constexpr uint32_t MESHLET_MAX_TRIANGLES = 124;
+
+// Levels per primitive including full detail
+constexpr uint32_t MAX_LODS = 8;
+
+// A simplified version of a primitive, indexing the same vertices as its full-detail triangles
+struct LodLevel
+{
+    std::vector<uint32_t> indices;
+    float error = 0.0f; // How far the surface may have moved, in mesh units
+};
+
+struct GeometryOptimizeOptions
+{
+    bool optimize = true;  // Vertex cache order of the triangles, then fetch order of the vertices
+    bool overdraw = false; // Trade a little vertex cache efficiency for front-to-back triangle order
+};
+
+// Post-transform vertex cache and fetch efficiency of a triangle list, simulating a 16-entry FIFO cache
+struct VertexCacheMetrics
+{
+    float acmr = 0.0f;     // Vertices transformed per triangle, 0.5 at best and 3 at worst
+    float atvr = 0.0f;     // Vertices transformed per vertex, 1 at best
+    float overdraw = 0.0f; // Pixels shaded per covered pixel, only measured when optimizing for overdraw
+};
+
+struct GeometryOptimizeResult
+{
+    VertexCacheMetrics before;
+    VertexCacheMetrics after;
+};
+
+// Reorders a primitive's triangles and vertices in place, unreferenced vertices are dropped. The triangle list must
+// have a multiple of three indices, anything else is left as it is.
+GeometryOptimizeResult optimizeGeometry(std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                        const GeometryOptimizeOptions& options);
+
+// Splits a primitive into meshlets, appending them and their vertex and triangle lists to the outputs
+void buildMeshlets(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices,
+                   std::vector<Meshlet>& meshlets, std::vector<uint32_t>& meshletVertices,
+                   std::vector<uint8_t>& meshletTriangles);
+
+// Simplifies a primitive into a chain of up to MAX_LODS - 1 levels, each with about half the triangles of the one
+// before, by edge collapses that keep the error below a tenth of the mesh extent. The chain ends early once
+// simplification stops paying off. Errors never decrease along the chain and every level is in vertex cache order.
+std::vector<LodLevel> buildLods(const std::vector<Vertex>& vertices, const std::vector<uint32_t>& indices);
+} // spectra
+
+#endif //SPECTRA_GEOMETRYOPTIMIZER_H
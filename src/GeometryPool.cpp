@@ -0,0 +1,75 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "GeometryPool.h"
+
+#include "vk/Error.h"
+
+namespace spectra {
+GeometryPool::GeometryPool(VmaAllocator allocator, uint32_t vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity)
+    : allocator_(allocator), vertexStride_(vertexStride), vertexRanges_(vertexCapacity), indexRanges_(indexCapacity)
+{
+    VmaAllocationCreateInfo allocCreateInfo
+    {
+        .flags = 0,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE
+    };
+
+    VkBufferCreateInfo vertBufferCreateInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = static_cast<VkDeviceSize>(vertexCapacity) * vertexStride,
+        .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+    };
+    CHECK_VK(vmaCreateBuffer(allocator_, &vertBufferCreateInfo, &allocCreateInfo, &vertexBuffer_, &vertexAlloc_, nullptr));
+
+    VkBufferCreateInfo indexBufferCreateInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = static_cast<VkDeviceSize>(indexCapacity) * sizeof(uint32_t),
+        .usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+    };
+    CHECK_VK(vmaCreateBuffer(allocator_, &indexBufferCreateInfo, &allocCreateInfo, &indexBuffer_, &indexAlloc_, nullptr));
+}
+
+GeometryPool::~GeometryPool()
+{
+    vmaDestroyBuffer(allocator_, indexBuffer_, indexAlloc_);
+    vmaDestroyBuffer(allocator_, vertexBuffer_, vertexAlloc_);
+}
+
+std::optional<GeometryPool::Allocation> GeometryPool::allocate(uint32_t vertexCount, uint32_t indexCount)
+{
+    auto vertices = vertexRanges_.allocate(vertexCount);
+    if (!vertices)
+    {
+        return std::nullopt;
+    }
+
+    auto indices = indexRanges_.allocate(indexCount);
+    if (!indices)
+    {
+        vertexRanges_.free(*vertices);
+        return std::nullopt;
+    }
+
+    return Allocation{ *vertices, *indices };
+}
+
+void GeometryPool::free(const Allocation& allocation)
+{
+    vertexRanges_.free(allocation.vertices);
+    indexRanges_.free(allocation.indices);
+}
+
+VkDeviceSize GeometryPool::usedBytes() const
+{
+    return vertexRanges_.usedSize() * vertexStride_ + indexRanges_.usedSize() * sizeof(uint32_t);
+}
+
+VkDeviceSize GeometryPool::capacityBytes() const
+{
+    return vertexRanges_.capacity() * vertexStride_ + indexRanges_.capacity() * sizeof(uint32_t);
+}
+} // spectra
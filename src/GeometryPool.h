@@ -0,0 +1,55 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_GEOMETRYPOOL_H
+#define SPECTRA_GEOMETRYPOOL_H
+
+#include <optional>
+#include <vk_mem_alloc.h>
+
+#include "OffsetAllocator.h"
+
+namespace spectra {
+// One device-local vertex buffer and one index buffer shared by all meshes. Meshes get sub-ranges, so a whole
+// scene binds its geometry once and selects meshes through firstIndex/vertexOffset.
+class GeometryPool {
+public:
+    struct Allocation
+    {
+        OffsetAllocator::Allocation vertices; // In vertices
+        OffsetAllocator::Allocation indices;  // In 32-bit indices
+    };
+
+    GeometryPool(VmaAllocator allocator, uint32_t vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity);
+    ~GeometryPool();
+
+    GeometryPool(const GeometryPool&) = delete;
+    GeometryPool& operator=(const GeometryPool&) = delete;
+
+    std::optional<Allocation> allocate(uint32_t vertexCount, uint32_t indexCount);
+    void free(const Allocation& allocation);
+
+    [[nodiscard]] VkBuffer vertexBuffer() const { return vertexBuffer_; }
+    [[nodiscard]] VkBuffer indexBuffer() const { return indexBuffer_; }
+    [[nodiscard]] uint32_t vertexStride() const { return vertexStride_; }
+    [[nodiscard]] uint64_t freeVertices() const { return vertexRanges_.capacity() - vertexRanges_.usedSize(); }
+    [[nodiscard]] uint64_t freeIndices() const { return indexRanges_.capacity() - indexRanges_.usedSize(); }
+    [[nodiscard]] VkDeviceSize usedBytes() const;
+    [[nodiscard]] VkDeviceSize capacityBytes() const;
+
+private:
+    VmaAllocator allocator_ = VK_NULL_HANDLE;
+    uint32_t vertexStride_ = 0;
+
+    VkBuffer vertexBuffer_ = VK_NULL_HANDLE;
+    VmaAllocation vertexAlloc_{};
+    VkBuffer indexBuffer_ = VK_NULL_HANDLE;
+    VmaAllocation indexAlloc_{};
+
+    OffsetAllocator vertexRanges_;
+    OffsetAllocator indexRanges_;
+};
+} // spectra
+
+#endif //SPECTRA_GEOMETRYPOOL_H
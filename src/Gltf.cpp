@@ -0,0 +1,257 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "Gltf.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace spectra::gltf {
+namespace {
+template <typename T>
+T load(const uint8_t* p)
+{
+    T value;
+    memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+float readComponent(const uint8_t* p, int componentType, bool normalized)
+{
+    switch (componentType)
+    {
+    case TINYGLTF_COMPONENT_TYPE_FLOAT:
+        return load<float>(p);
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+        return normalized ? load<uint8_t>(p) / 255.0f : load<uint8_t>(p);
+    case TINYGLTF_COMPONENT_TYPE_BYTE:
+        return normalized ? std::max(load<int8_t>(p) / 127.0f, -1.0f) : load<int8_t>(p);
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+        return normalized ? load<uint16_t>(p) / 65535.0f : load<uint16_t>(p);
+    case TINYGLTF_COMPONENT_TYPE_SHORT:
+        return normalized ? std::max(load<int16_t>(p) / 32767.0f, -1.0f) : load<int16_t>(p);
+    case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+        return static_cast<float>(load<uint32_t>(p));
+    default:
+        return 0.0f;
+    }
+}
+
+template <typename Vec, int N>
+std::vector<Vec> readVectors(const tinygltf::Model& model, int accessorIndex)
+{
+    const std::vector<float> floats = readFloats(model, accessorIndex, N);
+    std::vector<Vec> vectors(floats.size() / N);
+    memcpy(vectors.data(), floats.data(), vectors.size() * sizeof(Vec));
+    return vectors;
+}
+
+// First element of an accessor with a buffer view, null when the view lies outside its buffer or the elements outside
+// the view, as in truncated or malformed files
+const uint8_t* accessorData(const tinygltf::Model& model, const tinygltf::Accessor& accessor, size_t elementSize,
+                            size_t stride)
+{
+    if (accessor.bufferView >= static_cast<int>(model.bufferViews.size()))
+    {
+        return nullptr;
+    }
+    const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
+    if (view.buffer < 0 || view.buffer >= static_cast<int>(model.buffers.size()))
+    {
+        return nullptr;
+    }
+    const tinygltf::Buffer& buffer = model.buffers[view.buffer];
+    if (view.byteOffset > buffer.data.size() || view.byteLength > buffer.data.size() - view.byteOffset ||
+        accessor.byteOffset > view.byteLength)
+    {
+        return nullptr;
+    }
+
+    // The last element ends at (count - 1) * stride + elementSize, compared without overflowing
+    const size_t available = view.byteLength - accessor.byteOffset;
+    if (accessor.count > 0 && (elementSize > available || accessor.count - 1 > (available - elementSize) / stride))
+    {
+        return nullptr;
+    }
+    return buffer.data.data() + view.byteOffset + accessor.byteOffset;
+}
+
+// Keeps the encoded bytes, the texture streamer decodes or transcodes the images materials actually use
+bool keepEncodedImage(tinygltf::Image* pImage, const int, std::string*, std::string*, int, int,
+                      const unsigned char* pBytes, int size, void*)
+{
+    pImage->image.assign(pBytes, pBytes + size);
+    return true;
+}
+} // namespace
+
+bool loadModel(const std::string& path, tinygltf::Model& model)
+{
+    tinygltf::TinyGLTF loader;
+    loader.SetImageLoader(&keepEncodedImage, nullptr);
+    std::string err;
+    std::string warn;
+
+    const bool ret = path.ends_with(".gltf") ? loader.LoadASCIIFromFile(&model, &err, &warn, path)
+                                             : loader.LoadBinaryFromFile(&model, &err, &warn, path);
+    if (!warn.empty())
+    {
+        std::cerr << "glTF warning: " << warn << "\n";
+    }
+    if (!err.empty())
+    {
+        std::cerr << "glTF error: " << err << "\n";
+    }
+    if (!ret)
+    {
+        std::cerr << "Failed to parse glTF: " << path << "\n";
+    }
+    return ret;
+}
+
+std::vector<float> readFloats(const tinygltf::Model& model, int accessorIndex, int components)
+{
+    if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size()))
+    {
+        return {};
+    }
+
+    const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+
+    // Accessors without a buffer view are all zeros (sparse accessors are not supported yet)
+    if (accessor.bufferView < 0)
+    {
+        return std::vector<float>(accessor.count * components, 0.0f);
+    }
+
+    const int componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+    const int elementComponents = tinygltf::GetNumComponentsInType(accessor.type);
+    const int stride = accessor.bufferView < static_cast<int>(model.bufferViews.size())
+                       ? accessor.ByteStride(model.bufferViews[accessor.bufferView])
+                       : -1;
+    if (componentSize <= 0 || elementComponents <= 0 || stride <= 0)
+    {
+        return {};
+    }
+    const uint8_t* pData = accessorData(model, accessor, static_cast<size_t>(componentSize) * elementComponents,
+                                        static_cast<size_t>(stride));
+    if (pData == nullptr)
+    {
+        return {};
+    }
+
+    std::vector<float> result(accessor.count * components, 0.0f);
+    const int copied = std::min(components, elementComponents);
+    for (size_t i = 0; i < accessor.count; i++)
+    {
+        const uint8_t* pElement = pData + i * stride;
+        for (int c = 0; c < copied; c++)
+        {
+            result[i * components + c] = readComponent(pElement + c * componentSize, accessor.componentType, accessor.normalized);
+        }
+    }
+
+    return result;
+}
+
+std::vector<glm::vec2> readVec2(const tinygltf::Model& model, int accessorIndex)
+{
+    return readVectors<glm::vec2, 2>(model, accessorIndex);
+}
+
+std::vector<glm::vec3> readVec3(const tinygltf::Model& model, int accessorIndex)
+{
+    return readVectors<glm::vec3, 3>(model, accessorIndex);
+}
+
+std::vector<glm::vec4> readVec4(const tinygltf::Model& model, int accessorIndex)
+{
+    return readVectors<glm::vec4, 4>(model, accessorIndex);
+}
+
+std::vector<uint32_t> readIndices(const tinygltf::Model& model, int accessorIndex)
+{
+    if (accessorIndex < 0 || accessorIndex >= static_cast<int>(model.accessors.size()))
+    {
+        return {};
+    }
+
+    const tinygltf::Accessor& accessor = model.accessors[accessorIndex];
+    if (accessor.bufferView < 0)
+    {
+        return std::vector<uint32_t>(accessor.count, 0);
+    }
+
+    // Indices are single unsigned integers
+    const bool unsignedType = accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE ||
+                              accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT ||
+                              accessor.componentType == TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT;
+    const int componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+    const int stride = accessor.bufferView < static_cast<int>(model.bufferViews.size())
+                       ? accessor.ByteStride(model.bufferViews[accessor.bufferView])
+                       : -1;
+    if (!unsignedType || accessor.type != TINYGLTF_TYPE_SCALAR || stride <= 0)
+    {
+        return {};
+    }
+    const uint8_t* pData = accessorData(model, accessor, componentSize, static_cast<size_t>(stride));
+    if (pData == nullptr)
+    {
+        return {};
+    }
+
+    std::vector<uint32_t> indices(accessor.count, 0);
+    for (size_t i = 0; i < accessor.count; i++)
+    {
+        const uint8_t* pElement = pData + i * stride;
+        switch (accessor.componentType)
+        {
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+            indices[i] = load<uint8_t>(pElement);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+            indices[i] = load<uint16_t>(pElement);
+            break;
+        case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+            indices[i] = load<uint32_t>(pElement);
+            break;
+        default:
+            break;
+        }
+    }
+
+    return indices;
+}
+
+glm::mat4 nodeLocalMatrix(const tinygltf::Node& node)
+{
+    if (node.matrix.size() == 16)
+    {
+        glm::dmat4 matrix = glm::make_mat4(node.matrix.data());
+        return glm::mat4(matrix);
+    }
+
+    glm::mat4 matrix(1.0f);
+    if (node.translation.size() == 3)
+    {
+        matrix[3] = glm::vec4(glm::vec3(glm::make_vec3(node.translation.data())), 1.0f);
+    }
+    if (node.rotation.size() == 4)
+    {
+        // glTF stores quaternions as xyzw, glm constructs them as wxyz
+        const glm::quat rotation(static_cast<float>(node.rotation[3]), static_cast<float>(node.rotation[0]),
+                                 static_cast<float>(node.rotation[1]), static_cast<float>(node.rotation[2]));
+        matrix = matrix * glm::mat4_cast(rotation);
+    }
+    if (node.scale.size() == 3)
+    {
+        matrix = glm::scale(matrix, glm::vec3(glm::make_vec3(node.scale.data())));
+    }
+    return matrix;
+}
+} // spectra::gltf
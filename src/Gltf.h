@@ -0,0 +1,33 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_GLTF_H
+#define SPECTRA_GLTF_H
+
+#include <string>
+#include <vector>
+#include <tiny_gltf.h>
+#include <glm/glm.hpp>
+
+// Helpers for pulling typed data out of tinygltf accessors
+namespace spectra::gltf {
+// Parses a .glb or .gltf file. Images are left encoded in Image::image, nothing is decoded at load.
+bool loadModel(const std::string& path, tinygltf::Model& model);
+
+// Converts every element of the accessor to floats, honouring byte stride and normalized integer types.
+// Returns `components` floats per element; missing components are zero. Empty when the accessor or the bytes it
+// covers do not fit the file, as in truncated or malformed files.
+std::vector<float> readFloats(const tinygltf::Model& model, int accessorIndex, int components);
+
+std::vector<glm::vec2> readVec2(const tinygltf::Model& model, int accessorIndex);
+std::vector<glm::vec3> readVec3(const tinygltf::Model& model, int accessorIndex);
+std::vector<glm::vec4> readVec4(const tinygltf::Model& model, int accessorIndex);
+
+// Empty when the accessor or the bytes it covers do not fit the file, as in truncated or malformed files
+std::vector<uint32_t> readIndices(const tinygltf::Model& model, int accessorIndex);
+
+glm::mat4 nodeLocalMatrix(const tinygltf::Node& node);
+} // spectra::gltf
+
+#endif //SPECTRA_GLTF_H
@@ -0,0 +1,226 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <utility>
+
+#include "vk/Error.h"
+
+namespace spectra {
+namespace {
+// One pair per scope plus the frame bracket
+constexpr uint32_t QUERIES_PER_FRAME = 2 * GpuProfiler::MAX_SCOPES_PER_FRAME + 2;
+}
+
+GpuProfiler::GpuProfiler(std::shared_ptr<vk::Context> pCtx, uint32_t frameCount)
+    : pCtx_(std::move(pCtx))
+{
+    frames_.resize(frameCount);
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(pCtx_->physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(pCtx_->physicalDevice, &familyCount, families.data());
+    const uint32_t validBits = families[pCtx_->graphicsQueueFamily].timestampValidBits;
+
+    // Software rasterizers may not support timestamps at all, CPU timings still work without them
+    if (validBits == 0 || !pCtx_->physicalDeviceProperties.limits.timestampComputeAndGraphics)
+    {
+        std::cerr << "Timestamp queries are not supported, GPU timings are unavailable\n";
+        return;
+    }
+
+    // Differences are taken modulo the valid bits so a counter wrapping mid-frame still gives the right duration
+    timestampMask_ = validBits >= 64 ? ~0ULL : (1ULL << validBits) - 1;
+    periodNs_ = pCtx_->physicalDeviceProperties.limits.timestampPeriod;
+
+    queryPools_.resize(frameCount);
+    for (auto& pool : queryPools_)
+    {
+        VkQueryPoolCreateInfo queryPoolInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+            .queryType = VK_QUERY_TYPE_TIMESTAMP,
+            .queryCount = QUERIES_PER_FRAME,
+        };
+        CHECK_VK(vkCreateQueryPool(pCtx_->device, &queryPoolInfo, nullptr, &pool));
+    }
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    for (const auto& pool : queryPools_)
+    {
+        vkDestroyQueryPool(pCtx_->device, pool, nullptr);
+    }
+}
+
+void GpuProfiler::collect(uint32_t frameIndex)
+{
+    FrameQueries& frame = frames_[frameIndex];
+    if (!enabled() || !frame.recorded)
+    {
+        return;
+    }
+    frame.recorded = false;
+
+    // The frame slot wait has already passed, so this does not stall. Without the wait flag an incomplete frame
+    // returns VK_NOT_READY and is skipped rather than blocking.
+    std::vector<uint64_t> timestamps(frame.queryCount);
+    const VkResult result = vkGetQueryPoolResults(pCtx_->device, queryPools_[frameIndex], 0, frame.queryCount,
+                                                  timestamps.size() * sizeof(uint64_t), timestamps.data(),
+                                                  sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS)
+    {
+        return;
+    }
+
+    for (const auto& scope : frame.scopes)
+    {
+        if (scope.beginQuery == INVALID_SCOPE || scope.endQuery == INVALID_SCOPE)
+        {
+            continue;
+        }
+
+        const uint64_t ticks = (timestamps[scope.endQuery] - timestamps[scope.beginQuery]) & timestampMask_;
+        const double ms = static_cast<double>(ticks) * periodNs_ * 1e-6;
+        addSample(scope.name, ms);
+
+        if (&scope == &frame.scopes.front())
+        {
+            lastFrameTimeMs_ = ms;
+        }
+        if (csv_.is_open())
+        {
+            csv_ << frame.frameNumber << ',' << scope.name << ',' << ms << '\n';
+        }
+    }
+}
+
+void GpuProfiler::beginFrame(VkCommandBuffer cb, uint32_t frameIndex)
+{
+    recordingFrame_ = frameIndex;
+    FrameQueries& frame = frames_[frameIndex];
+    frame.scopes.clear();
+    frame.queryCount = 0;
+    frame.frameNumber = frameNumber_++;
+
+    if (!enabled())
+    {
+        return;
+    }
+
+    vkCmdResetQueryPool(cb, queryPools_[frameIndex], 0, QUERIES_PER_FRAME);
+    frame.scopes.push_back({ "Frame", writeTimestamp(cb, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT), INVALID_SCOPE });
+}
+
+void GpuProfiler::endFrame(VkCommandBuffer cb)
+{
+    FrameQueries& frame = frames_[recordingFrame_];
+    if (!enabled())
+    {
+        return;
+    }
+
+    frame.scopes.front().endQuery = writeTimestamp(cb, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    frame.recorded = true;
+}
+
+uint32_t GpuProfiler::beginScope(VkCommandBuffer cb, const char* name)
+{
+    FrameQueries& frame = frames_[recordingFrame_];
+    if (!enabled() || frame.scopes.size() > MAX_SCOPES_PER_FRAME)
+    {
+        return INVALID_SCOPE;
+    }
+
+    // All-commands timestamps are written once prior work has finished, so consecutive scopes do not overlap
+    frame.scopes.push_back({ name, writeTimestamp(cb, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT), INVALID_SCOPE });
+    return static_cast<uint32_t>(frame.scopes.size() - 1);
+}
+
+void GpuProfiler::endScope(VkCommandBuffer cb, uint32_t scope)
+{
+    if (scope == INVALID_SCOPE)
+    {
+        return;
+    }
+
+    frames_[recordingFrame_].scopes[scope].endQuery = writeTimestamp(cb, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+}
+
+bool GpuProfiler::startCsvCapture(const std::string& path)
+{
+    csv_.close();
+    csv_.open(path);
+    if (!csv_)
+    {
+        std::cerr << "Failed to open " << path << " for GPU timings\n";
+        return false;
+    }
+
+    csv_ << "frame,scope,gpu_ms\n";
+    return true;
+}
+
+void GpuProfiler::stopCsvCapture()
+{
+    csv_.close();
+}
+
+std::vector<GpuProfiler::ScopeStats> GpuProfiler::stats() const
+{
+    std::vector<ScopeStats> result;
+    result.reserve(history_.size());
+    for (const auto& history : history_)
+    {
+        const auto [minIt, maxIt] = std::ranges::minmax_element(history.samplesMs);
+        result.push_back({
+            .name = history.name,
+            .lastMs = history.samplesMs.back(),
+            .avgMs = std::accumulate(history.samplesMs.begin(), history.samplesMs.end(), 0.0) /
+                     static_cast<double>(history.samplesMs.size()),
+            .minMs = *minIt,
+            .maxMs = *maxIt,
+        });
+    }
+    return result;
+}
+
+std::optional<double> GpuProfiler::consumeFrameTimeMs()
+{
+    return std::exchange(lastFrameTimeMs_, std::nullopt);
+}
+
+uint32_t GpuProfiler::writeTimestamp(VkCommandBuffer cb, VkPipelineStageFlags2 stage)
+{
+    FrameQueries& frame = frames_[recordingFrame_];
+    if (frame.queryCount == QUERIES_PER_FRAME)
+    {
+        return INVALID_SCOPE;
+    }
+
+    vkCmdWriteTimestamp2(cb, stage, queryPools_[recordingFrame_], frame.queryCount);
+    return frame.queryCount++;
+}
+
+void GpuProfiler::addSample(const std::string& name, double ms)
+{
+    auto it = std::ranges::find(history_, name, &History::name);
+    if (it == history_.end())
+    {
+        it = history_.insert(history_.end(), { name, {} });
+    }
+
+    it->samplesMs.push_back(ms);
+    if (it->samplesMs.size() > HISTORY_FRAMES)
+    {
+        it->samplesMs.pop_front();
+    }
+}
+} // spectra
@@ -0,0 +1,123 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_GPUPROFILER_H
+#define SPECTRA_GPUPROFILER_H
+
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "vk/Context.h"
+
+namespace spectra {
+// Measures named GPU scopes with timestamp queries. Each frame in flight owns a query pool that is read back once
+// that frame has finished, so results arrive frameCount frames late but never stall the CPU.
+// Devices without timestamp support get a profiler that records nothing.
+class GpuProfiler {
+public:
+    static constexpr uint32_t MAX_SCOPES_PER_FRAME = 32;
+    static constexpr size_t HISTORY_FRAMES = 120; // Window of the rolling statistics
+
+    struct ScopeStats
+    {
+        std::string name;
+        double lastMs = 0.0;
+        double avgMs = 0.0;
+        double minMs = 0.0;
+        double maxMs = 0.0;
+    };
+
+    // Begins a scope on construction and ends it on destruction
+    class Scope {
+    public:
+        Scope(GpuProfiler& profiler, VkCommandBuffer cb, const char* name)
+            : profiler_(profiler), cb_(cb), index_(profiler.beginScope(cb, name)) {}
+        ~Scope() { profiler_.endScope(cb_, index_); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler& profiler_;
+        VkCommandBuffer cb_;
+        uint32_t index_;
+    };
+
+    GpuProfiler(std::shared_ptr<vk::Context> pCtx, uint32_t frameCount);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    // Reads back the scopes last recorded for frameIndex, call once that frame has finished
+    void collect(uint32_t frameIndex);
+
+    // Bracket everything recorded for a frame, the total is reported as the "Frame" scope
+    void beginFrame(VkCommandBuffer cb, uint32_t frameIndex);
+    void endFrame(VkCommandBuffer cb);
+
+    // Returns a handle for endScope(), scopes beyond MAX_SCOPES_PER_FRAME are dropped
+    uint32_t beginScope(VkCommandBuffer cb, const char* name);
+    void endScope(VkCommandBuffer cb, uint32_t scope);
+
+    // Appends frame,scope,gpu_ms rows for every collected frame until stopped
+    bool startCsvCapture(const std::string& path);
+    void stopCsvCapture();
+    [[nodiscard]] bool isCapturing() const { return csv_.is_open(); }
+
+    [[nodiscard]] bool enabled() const { return !queryPools_.empty(); }
+    // In order of first appearance
+    [[nodiscard]] std::vector<ScopeStats> stats() const;
+    // Frame time of the most recently collected frame, empty if nothing new was collected since the last call
+    std::optional<double> consumeFrameTimeMs();
+
+private:
+    static constexpr uint32_t INVALID_SCOPE = ~0U;
+
+    struct RecordedScope
+    {
+        std::string name;
+        uint32_t beginQuery = 0;
+        uint32_t endQuery = 0;
+    };
+
+    struct FrameQueries
+    {
+        std::vector<RecordedScope> scopes;
+        uint32_t queryCount = 0;
+        uint64_t frameNumber = 0;
+        bool recorded = false; // Results are pending readback
+    };
+
+    struct History
+    {
+        std::string name;
+        std::deque<double> samplesMs;
+    };
+
+    uint32_t writeTimestamp(VkCommandBuffer cb, VkPipelineStageFlags2 stage);
+    void addSample(const std::string& name, double ms);
+
+    std::shared_ptr<vk::Context> pCtx_;
+
+    std::vector<VkQueryPool> queryPools_; // Per frame in flight
+    std::vector<FrameQueries> frames_;
+    uint32_t recordingFrame_ = 0;
+    uint64_t frameNumber_ = 0;
+
+    double periodNs_ = 1.0;
+    uint64_t timestampMask_ = ~0ULL;
+
+    std::vector<History> history_;
+    std::optional<double> lastFrameTimeMs_;
+
+    std::ofstream csv_;
+};
+} // spectra
+
+#endif //SPECTRA_GPUPROFILER_H
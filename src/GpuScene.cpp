@@ -0,0 +1,242 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "GpuScene.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "vk/Error.h"
+
+namespace spectra {
+namespace {
+// The draw counts of the early and late phase sit at the start of a draw buffer, the commands of both follow
+constexpr VkDeviceSize COMMANDS_OFFSET = 16;
+constexpr uint32_t CULL_GROUP_SIZE = 64; // numthreads of shaders/cull.slang
+constexpr uint32_t MIN_DRAW_CAPACITY = 1024;
+
+// The late phase counts and appends behind the early one
+VkDeviceSize countOffset(GpuScene::CullPhase phase)
+{
+    return phase == GpuScene::CullPhase::Late ? sizeof(uint32_t) : 0;
+}
+
+VkDeviceSize commandsOffset(GpuScene::CullPhase phase, uint32_t capacity)
+{
+    return COMMANDS_OFFSET +
+           (phase == GpuScene::CullPhase::Late ? capacity * sizeof(VkDrawIndexedIndirectCommand) : 0);
+}
+
+void memoryBarrier(VkCommandBuffer cb, VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+                   VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess)
+{
+    const VkMemoryBarrier2 barrier {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+        .srcStageMask = srcStage,
+        .srcAccessMask = srcAccess,
+        .dstStageMask = dstStage,
+        .dstAccessMask = dstAccess,
+    };
+    const VkDependencyInfo dependencyInfo {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &barrier,
+    };
+    vkCmdPipelineBarrier2(cb, &dependencyInfo);
+}
+}
+
+GpuScene::GpuScene(VkDevice device, VmaAllocator allocator, UploadManager& uploadManager, uint32_t frameCount)
+    : device_(device), allocator_(allocator), uploadManager_(uploadManager), frameCount_(frameCount),
+      drawBuffers_(frameCount)
+{
+}
+
+GpuScene::~GpuScene()
+{
+    // Uploads into buffers about to be destroyed may still be running on the transfer queue
+    if (pending_)
+    {
+        uploadManager_.wait(pending_->uploadValue);
+        destroy(*pending_);
+    }
+    for (auto& retired : retired_)
+    {
+        uploadManager_.wait(retired.objects.uploadValue);
+        destroy(retired.objects);
+    }
+    destroy(current_);
+
+    for (const auto& draws : drawBuffers_)
+    {
+        if (draws.buffer != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(allocator_, draws.buffer, draws.alloc);
+        }
+    }
+}
+
+void GpuScene::setObjects(std::span<const Object> objects, std::span<const Lod> lods)
+{
+    // A newer set supersedes one that has not landed yet, frames never saw it
+    if (pending_)
+    {
+        retired_.push_back({ *pending_, frameNumber_ });
+        pending_.reset();
+    }
+
+    if (objects.empty())
+    {
+        if (current_.buffer != VK_NULL_HANDLE)
+        {
+            retired_.push_back({ current_, frameNumber_ + frameCount_ - 1 });
+            current_ = {};
+        }
+        return;
+    }
+
+    ObjectBuffer next;
+    next.count = static_cast<uint32_t>(objects.size());
+    next.buffer = createBuffer(objects.size_bytes() + lods.size_bytes() + objects.size() * sizeof(uint32_t),
+                               VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT |
+                               VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                               next.alloc, next.address);
+    next.lodsAddress = next.address + objects.size_bytes();
+    next.visibilityAddress = next.lodsAddress + lods.size_bytes();
+
+    // Large scenes exceed the staging ring, they are streamed in pieces the ring can hold
+    const auto upload = [&](VkDeviceSize bufferOffset, const void* pData, VkDeviceSize size, VkDeviceSize stride)
+    {
+        const VkDeviceSize chunkSize = uploadManager_.ringSize() / 4 / stride * stride;
+        const auto* pBytes = static_cast<const uint8_t*>(pData);
+        for (VkDeviceSize offset = 0; offset < size; offset += chunkSize)
+        {
+            uploadManager_.uploadBuffer(next.buffer, bufferOffset + offset, pBytes + offset,
+                                        std::min(chunkSize, size - offset));
+        }
+    };
+    upload(0, objects.data(), objects.size_bytes(), sizeof(Object));
+    upload(objects.size_bytes(), lods.data(), lods.size_bytes(), sizeof(Lod));
+    // Nothing counts as visible before the first late phase, it draws everything that passes the occlusion test
+    const std::vector<uint32_t> visibility(objects.size(), 0);
+    upload(objects.size_bytes() + lods.size_bytes(), visibility.data(), visibility.size() * sizeof(uint32_t),
+           sizeof(uint32_t));
+    next.uploadValue = uploadManager_.flush();
+
+    pending_ = next;
+}
+
+void GpuScene::beginFrame(uint32_t frameIndex)
+{
+    frameIndex_ = frameIndex;
+    frameNumber_++;
+
+    if (pending_ && uploadManager_.isAvailable(pending_->uploadValue))
+    {
+        // Frames before this one may still read the old set, it is freed once they have all retired
+        if (current_.buffer != VK_NULL_HANDLE)
+        {
+            retired_.push_back({ current_, frameNumber_ + frameCount_ - 1 });
+        }
+        current_ = *pending_;
+        pending_.reset();
+    }
+
+    const auto freed = std::ranges::remove_if(retired_, [this](RetiredBuffer& retired)
+    {
+        if (retired.freeFrame > frameNumber_ || !uploadManager_.isComplete(retired.objects.uploadValue))
+        {
+            return false;
+        }
+        destroy(retired.objects);
+        return true;
+    });
+    retired_.erase(freed.begin(), freed.end());
+
+    // Every object may be visible, so a frame's draw buffer holds a command per object and phase
+    DrawBuffer& draws = drawBuffers_[frameIndex_];
+    if (draws.capacity < current_.count)
+    {
+        if (draws.buffer != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(allocator_, draws.buffer, draws.alloc);
+        }
+        draws.capacity = std::bit_ceil(std::max(current_.count, MIN_DRAW_CAPACITY));
+        draws.buffer = createBuffer(COMMANDS_OFFSET + 2 * draws.capacity * sizeof(VkDrawIndexedIndirectCommand),
+                                    VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+                                    VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                    draws.alloc, draws.address);
+    }
+}
+
+void GpuScene::recordCull(VkCommandBuffer cb, VkPipeline pipeline, VkPipelineLayout layout,
+                          VkDeviceAddress frameData, CullPhase phase, bool frustumCulling,
+                          VkDeviceAddress depthPyramid) const
+{
+    const DrawBuffer& draws = drawBuffers_[frameIndex_];
+
+    // The count is appended to with atomics, it starts from zero every frame
+    vkCmdFillBuffer(cb, draws.buffer, countOffset(phase), sizeof(uint32_t), 0);
+    memoryBarrier(cb, VK_PIPELINE_STAGE_2_CLEAR_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                  VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+
+    const CullConstants constants {
+        .objects = current_.address,
+        .lods = current_.lodsAddress,
+        .commands = draws.address + commandsOffset(phase, draws.capacity),
+        .drawCount = draws.address + countOffset(phase),
+        .frameData = frameData,
+        .visibility = current_.visibilityAddress,
+        .depthPyramid = depthPyramid,
+        .objectCount = current_.count,
+        .phase = phase,
+        .frustumCulling = frustumCulling ? 1U : 0U,
+    };
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    vkCmdPushConstants(cb, layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullConstants), &constants);
+    vkCmdDispatch(cb, (current_.count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+}
+
+void GpuScene::recordDraws(VkCommandBuffer cb, CullPhase phase) const
+{
+    const DrawBuffer& draws = drawBuffers_[frameIndex_];
+    vkCmdDrawIndexedIndirectCount(cb, draws.buffer, commandsOffset(phase, draws.capacity), draws.buffer,
+                                  countOffset(phase), current_.count, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+VkBuffer GpuScene::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaAllocation& alloc,
+                                VkDeviceAddress& address) const
+{
+    VkBufferCreateInfo bufferCreateInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = size,
+        .usage = usage,
+    };
+    VmaAllocationCreateInfo allocCreateInfo
+    {
+        .flags = 0,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE
+    };
+    VkBuffer buffer = VK_NULL_HANDLE;
+    CHECK_VK(vmaCreateBuffer(allocator_, &bufferCreateInfo, &allocCreateInfo, &buffer, &alloc, nullptr))
+
+    const VkBufferDeviceAddressInfo addressInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
+        .buffer = buffer,
+    };
+    address = vkGetBufferDeviceAddress(device_, &addressInfo);
+    return buffer;
+}
+
+void GpuScene::destroy(ObjectBuffer& objects) const
+{
+    if (objects.buffer != VK_NULL_HANDLE)
+    {
+        vmaDestroyBuffer(allocator_, objects.buffer, objects.alloc);
+        objects = {};
+    }
+}
+} // spectra
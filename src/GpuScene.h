@@ -0,0 +1,149 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_GPUSCENE_H
+#define SPECTRA_GPUSCENE_H
+
+#include <optional>
+#include <span>
+#include <vector>
+#include <vk_mem_alloc.h>
+#include <glm/glm.hpp>
+
+#include "UploadManager.h"
+
+namespace spectra {
+// Scene data for GPU-driven rendering. Every drawable object lives in a persistent device-local buffer that a
+// compute pass culls against the frustum, appending a VkDrawIndexedIndirectCommand per visible object to a
+// per-frame draw buffer; the scene is then drawn with a single vkCmdDrawIndexedIndirectCount. The same pass picks
+// the level of detail of every visible object. The CPU cost of a frame does not depend on the number of objects, only
+// changing the objects re-uploads them.
+//
+// With occlusion culling the pass runs twice per frame. The early phase draws the objects that were visible last
+// frame, the late phase tests every object against a depth pyramid of what the early draws left, draws the visible
+// ones the early phase missed and records visibility for the next frame.
+class GpuScene {
+public:
+    // GpuObject in shaders/scene.slang
+    struct Object
+    {
+        glm::mat4 world;
+        glm::vec4 boundsCenter; // World-space AABB, w is the world size of a mesh unit, scaling LOD errors
+        glm::vec4 boundsExtent;
+        uint32_t firstLod = 0;  // Into the LOD table
+        uint32_t lodCount = 0;
+        int32_t vertexOffset = 0;
+        uint32_t material = 0;
+    };
+
+    // GpuLod in shaders/scene.slang, the LODs of an object are ordered by increasing error
+    struct Lod
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        float error = 0.0f; // Mesh units
+        uint32_t padding = 0;
+    };
+
+    // CULL_* in shaders/cull.slang
+    enum class CullPhase : uint32_t
+    {
+        All = 0,   // Frustum culling only, without occlusion culling
+        Early = 1, // Visible last frame
+        Late = 2,  // Not occluded in the depth pyramid and not drawn by the early phase
+    };
+
+    // CullConstants in shaders/cull.slang
+    struct CullConstants
+    {
+        VkDeviceAddress objects;
+        VkDeviceAddress lods;
+        VkDeviceAddress commands;
+        VkDeviceAddress drawCount;
+        VkDeviceAddress frameData;
+        VkDeviceAddress visibility;
+        VkDeviceAddress depthPyramid;
+        uint32_t objectCount;
+        CullPhase phase;
+        uint32_t frustumCulling;
+    };
+
+    GpuScene(VkDevice device, VmaAllocator allocator, UploadManager& uploadManager, uint32_t frameCount);
+    ~GpuScene();
+
+    GpuScene(const GpuScene&) = delete;
+    GpuScene& operator=(const GpuScene&) = delete;
+
+    // Uploads a new object set and the LOD table its objects index into a fresh buffer. Frames keep using the current
+    // set until the upload has landed.
+    void setObjects(std::span<const Object> objects, std::span<const Lod> lods);
+
+    // Swaps in a finished upload and frees buffers no frame in flight can still read. Must only be called once the
+    // GPU has finished the previous use of frameIndex.
+    void beginFrame(uint32_t frameIndex);
+
+    // True once an object set is resident, until then frames have to draw the scene some other way
+    [[nodiscard]] bool ready() const { return current_.buffer != VK_NULL_HANDLE; }
+    [[nodiscard]] uint32_t objectCount() const { return current_.count; }
+    [[nodiscard]] VkDeviceAddress objectsAddress() const { return current_.address; }
+    // Holds the objects, their LODs and the visibility the late cull phase writes for the next frame
+    [[nodiscard]] VkBuffer objectBuffer() const { return current_.buffer; }
+    // Upload timeline value of the newest object set
+    [[nodiscard]] uint64_t uploadValue() const { return pending_ ? pending_->uploadValue : current_.uploadValue; }
+
+    // Records the cull dispatch of a phase into this frame's draw buffer, must be recorded outside of rendering. The
+    // caller orders the indirect draws after it, the render graph does so from the draw buffer's usages. The late
+    // phase reads the depth pyramid. Without frustumCulling every object counts as inside the frustum.
+    void recordCull(VkCommandBuffer cb, VkPipeline pipeline, VkPipelineLayout layout, VkDeviceAddress frameData,
+                    CullPhase phase, bool frustumCulling, VkDeviceAddress depthPyramid = 0) const;
+    // Draw counts followed by the draw commands of this frame, the late phase has its own count and commands
+    [[nodiscard]] VkBuffer drawBuffer() const { return drawBuffers_[frameIndex_].buffer; }
+    // Draws whatever the cull phase of this frame appended, pipeline and geometry buffers must already be bound
+    void recordDraws(VkCommandBuffer cb, CullPhase phase) const;
+
+private:
+    struct ObjectBuffer
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation alloc{};
+        VkDeviceAddress address = 0;
+        VkDeviceAddress lodsAddress = 0; // Behind the objects in the same buffer
+        VkDeviceAddress visibilityAddress = 0; // Behind the LODs, one uint per object
+        uint32_t count = 0;
+        uint64_t uploadValue = 0;
+    };
+
+    struct RetiredBuffer
+    {
+        ObjectBuffer objects;
+        uint64_t freeFrame = 0; // First frame number at which no submitted frame can still read it
+    };
+
+    struct DrawBuffer
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation alloc{};
+        VkDeviceAddress address = 0;
+        uint32_t capacity = 0; // In draw commands per phase
+    };
+
+    VkBuffer createBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VmaAllocation& alloc, VkDeviceAddress& address) const;
+    void destroy(ObjectBuffer& objects) const;
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VmaAllocator allocator_ = VK_NULL_HANDLE;
+    UploadManager& uploadManager_;
+    uint32_t frameCount_ = 0;
+
+    ObjectBuffer current_;
+    std::optional<ObjectBuffer> pending_; // Still uploading
+    std::vector<RetiredBuffer> retired_;
+
+    std::vector<DrawBuffer> drawBuffers_; // Per frame in flight
+    uint32_t frameIndex_ = 0;
+    uint64_t frameNumber_ = 0;
+};
+} // spectra
+
+#endif //SPECTRA_GPUSCENE_H
@@ -0,0 +1,35 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_HASH_H
+#define SPECTRA_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace spectra {
+// 64-bit FNV-1a, for cache keys and content hashes rather than hash tables. Chain calls by passing the previous
+// hash as the seed.
+constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+inline uint64_t fnv1a(const void* data, size_t size, uint64_t hash = FNV_OFFSET_BASIS)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+inline uint64_t fnv1a(std::string_view str, uint64_t hash = FNV_OFFSET_BASIS)
+{
+    return fnv1a(str.data(), str.size(), hash);
+}
+} // spectra
+
+#endif //SPECTRA_HASH_H
@@ -0,0 +1,137 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "MappedFile.h"
+
+#include <format>
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace spectra {
+std::optional<MappedFile> MappedFile::open(const std::string& path)
+{
+    MappedFile file;
+#ifdef _WIN32
+    const HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        std::cerr << std::format("Failed to open {}: error {}\n", path, GetLastError());
+        return std::nullopt;
+    }
+
+    LARGE_INTEGER size{};
+    GetFileSizeEx(handle, &size);
+    file.size_ = static_cast<size_t>(size.QuadPart);
+    if (file.size_ > 0)
+    {
+        file.fileMapping_ = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (file.fileMapping_ != nullptr)
+        {
+            file.pData_ = static_cast<const uint8_t*>(MapViewOfFile(file.fileMapping_, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+    CloseHandle(handle);
+    if (file.size_ > 0 && file.pData_ == nullptr)
+    {
+        std::cerr << std::format("Failed to map {}: error {}\n", path, GetLastError());
+        return std::nullopt;
+    }
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        std::cerr << std::format("Failed to open {}: {}\n", path, strerror(errno));
+        return std::nullopt;
+    }
+
+    struct stat status{};
+    if (fstat(fd, &status) != 0)
+    {
+        std::cerr << std::format("Failed to stat {}: {}\n", path, strerror(errno));
+        close(fd);
+        return std::nullopt;
+    }
+    file.size_ = static_cast<size_t>(status.st_size);
+    if (file.size_ > 0)
+    {
+        void* pData = mmap(nullptr, file.size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pData == MAP_FAILED)
+        {
+            std::cerr << std::format("Failed to map {}: {}\n", path, strerror(errno));
+            close(fd);
+            return std::nullopt;
+        }
+        // Regions are read front to back while uploading
+        madvise(pData, file.size_, MADV_SEQUENTIAL);
+        file.pData_ = static_cast<const uint8_t*>(pData);
+    }
+    // The mapping keeps its own reference to the file
+    close(fd);
+#endif
+    return file;
+}
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : pData_(std::exchange(other.pData_, nullptr)), size_(std::exchange(other.size_, 0))
+#ifdef _WIN32
+    , fileMapping_(std::exchange(other.fileMapping_, nullptr))
+#endif
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        pData_ = std::exchange(other.pData_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+#ifdef _WIN32
+        fileMapping_ = std::exchange(other.fileMapping_, nullptr);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::unmap()
+{
+#ifdef _WIN32
+    if (pData_ != nullptr)
+    {
+        UnmapViewOfFile(pData_);
+    }
+    if (fileMapping_ != nullptr)
+    {
+        CloseHandle(fileMapping_);
+    }
+    fileMapping_ = nullptr;
+#else
+    if (pData_ != nullptr)
+    {
+        munmap(const_cast<uint8_t*>(pData_), size_);
+    }
+#endif
+    pData_ = nullptr;
+    size_ = 0;
+}
+} // spectra
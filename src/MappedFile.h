@@ -0,0 +1,42 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_MAPPEDFILE_H
+#define SPECTRA_MAPPEDFILE_H
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+namespace spectra {
+// Read-only memory mapping of a whole file. Pages are faulted in on first access, so reading a region only costs
+// the pages it touches and the OS page cache is shared between runs.
+class MappedFile {
+public:
+    static std::optional<MappedFile> open(const std::string& path);
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    [[nodiscard]] std::span<const uint8_t> data() const { return { pData_, size_ }; }
+    [[nodiscard]] size_t size() const { return size_; }
+
+private:
+    void unmap();
+
+    const uint8_t* pData_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* fileMapping_ = nullptr;
+#endif
+};
+} // spectra
+
+#endif //SPECTRA_MAPPEDFILE_H
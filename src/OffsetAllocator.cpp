@@ -0,0 +1,116 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "OffsetAllocator.h"
+
+#include <cassert>
+#include <iterator>
+
+namespace spectra {
+OffsetAllocator::OffsetAllocator(uint64_t capacity) : capacity_(capacity)
+{
+    if (capacity > 0)
+    {
+        insertFreeRange(0, capacity);
+    }
+}
+
+std::optional<OffsetAllocator::Allocation> OffsetAllocator::allocate(uint64_t size, uint64_t alignment)
+{
+    if (size == 0 || alignment == 0)
+    {
+        return std::nullopt;
+    }
+
+    // Best fit: the smallest free range that still fits once its start is aligned
+    for (auto it = freeBySize_.lower_bound(size); it != freeBySize_.end(); ++it)
+    {
+        const uint64_t rangeSize = it->first;
+        const uint64_t rangeOffset = it->second;
+        const uint64_t alignedOffset = (rangeOffset + alignment - 1) / alignment * alignment;
+        const uint64_t padding = alignedOffset - rangeOffset;
+        if (padding + size > rangeSize)
+        {
+            continue;
+        }
+
+        eraseFreeRange(freeByOffset_.find(rangeOffset));
+        if (padding > 0)
+        {
+            insertFreeRange(rangeOffset, padding);
+        }
+        if (padding + size < rangeSize)
+        {
+            insertFreeRange(alignedOffset + size, rangeSize - padding - size);
+        }
+
+        usedSize_ += size;
+        return Allocation{ alignedOffset, size };
+    }
+
+    return std::nullopt;
+}
+
+void OffsetAllocator::free(const Allocation& allocation)
+{
+    if (allocation.size == 0)
+    {
+        return;
+    }
+    assert(allocation.offset + allocation.size <= capacity_);
+
+    uint64_t offset = allocation.offset;
+    uint64_t size = allocation.size;
+    usedSize_ -= size;
+
+    // Merge with the following range
+    auto next = freeByOffset_.lower_bound(offset);
+    if (next != freeByOffset_.end() && next->first == offset + size)
+    {
+        size += next->second;
+        next = std::next(next);
+        eraseFreeRange(std::prev(next));
+    }
+
+    // Merge with the preceding range
+    if (next != freeByOffset_.begin())
+    {
+        auto prev = std::prev(next);
+        assert(prev->first + prev->second <= offset && "Double free or overlapping allocation");
+        if (prev->first + prev->second == offset)
+        {
+            offset = prev->first;
+            size += prev->second;
+            eraseFreeRange(prev);
+        }
+    }
+
+    insertFreeRange(offset, size);
+}
+
+uint64_t OffsetAllocator::largestFreeRange() const
+{
+    return freeBySize_.empty() ? 0 : freeBySize_.rbegin()->first;
+}
+
+void OffsetAllocator::insertFreeRange(uint64_t offset, uint64_t size)
+{
+    freeByOffset_.emplace(offset, size);
+    freeBySize_.emplace(size, offset);
+}
+
+void OffsetAllocator::eraseFreeRange(std::map<uint64_t, uint64_t>::iterator it)
+{
+    auto [first, last] = freeBySize_.equal_range(it->second);
+    for (auto sizeIt = first; sizeIt != last; ++sizeIt)
+    {
+        if (sizeIt->second == it->first)
+        {
+            freeBySize_.erase(sizeIt);
+            break;
+        }
+    }
+    freeByOffset_.erase(it);
+}
+} // spectra
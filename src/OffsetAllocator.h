@@ -0,0 +1,44 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_OFFSETALLOCATOR_H
+#define SPECTRA_OFFSETALLOCATOR_H
+
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace spectra {
+// Sub-allocates ranges of an abstract [0, capacity) space, e.g. elements of a GPU buffer. Free ranges are tracked
+// by offset for coalescing and by size for best-fit lookups. Units are up to the caller.
+class OffsetAllocator {
+public:
+    struct Allocation
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+
+    explicit OffsetAllocator(uint64_t capacity);
+
+    std::optional<Allocation> allocate(uint64_t size, uint64_t alignment = 1);
+    void free(const Allocation& allocation);
+
+    [[nodiscard]] uint64_t capacity() const { return capacity_; }
+    [[nodiscard]] uint64_t usedSize() const { return usedSize_; }
+    [[nodiscard]] uint64_t largestFreeRange() const;
+    [[nodiscard]] size_t freeRangeCount() const { return freeByOffset_.size(); }
+
+private:
+    void insertFreeRange(uint64_t offset, uint64_t size);
+    void eraseFreeRange(std::map<uint64_t, uint64_t>::iterator it);
+
+    uint64_t capacity_ = 0;
+    uint64_t usedSize_ = 0;
+    std::map<uint64_t, uint64_t> freeByOffset_;       // offset -> size
+    std::multimap<uint64_t, uint64_t> freeBySize_;    // size -> offset
+};
+} // spectra
+
+#endif //SPECTRA_OFFSETALLOCATOR_H
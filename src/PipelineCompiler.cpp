@@ -0,0 +1,556 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "PipelineCompiler.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <format>
+#include <iostream>
+
+#include "Hash.h"
+#include "Trace.h"
+#include "vk/Error.h"
+
+namespace spectra {
+namespace {
+bool isReady(const std::shared_future<VkPipeline>& future)
+{
+    return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+template <typename T>
+uint64_t hashValues(const std::vector<T>& values, uint64_t hash)
+{
+    hash = fnv1a(&FNV_PRIME, sizeof(FNV_PRIME), hash); // Separates adjacent arrays
+    return fnv1a(values.data(), values.size() * sizeof(T), hash);
+}
+
+template <typename T>
+uint64_t hashValue(const T& value, uint64_t hash)
+{
+    return fnv1a(&value, sizeof(T), hash);
+}
+
+uint64_t hashState(const GraphicsPipelineDesc& desc)
+{
+    uint64_t hash = fnv1a(std::format("graphics;{};{};", desc.vertexEntry, desc.fragmentEntry));
+    hash = hashValues(desc.specialization, hash);
+    hash = hashValues(desc.vertexBindings, hash);
+    hash = hashValues(desc.vertexAttributes, hash);
+    hash = hashValue(desc.layout, hash);
+    hash = hashValue(desc.colorFormat, hash);
+    hash = hashValue(desc.depthFormat, hash);
+    hash = hashValue(desc.dynamicDepthWrite, hash);
+    hash = hashValue(desc.cullMode, hash);
+    return hashValue(desc.frontFace, hash);
+}
+
+uint64_t hashState(const ComputePipelineDesc& desc)
+{
+    uint64_t hash = fnv1a(std::format("compute;{};", desc.entry));
+    hash = hashValues(desc.specialization, hash);
+    return hashValue(desc.layout, hash);
+}
+
+// Entries point into the constants themselves, which serve as the specialization data
+std::vector<VkSpecializationMapEntry> specializationEntries(const std::vector<SpecializationConstant>& constants)
+{
+    std::vector<VkSpecializationMapEntry> entries;
+    for (size_t i = 0; i < constants.size(); i++)
+    {
+        entries.push_back({
+            .constantID = constants[i].id,
+            .offset = static_cast<uint32_t>(i * sizeof(SpecializationConstant) + offsetof(SpecializationConstant, value)),
+            .size = sizeof(uint32_t),
+        });
+    }
+    return entries;
+}
+} // namespace
+
+PipelineCompiler::PipelineCompiler(VkDevice device, VkPipelineCache pipelineCache, ShaderCompiler& shaderCompiler,
+                                   uint32_t frameCount, uint32_t threadCount)
+    : device_(device), pipelineCache_(pipelineCache), shaderCompiler_(shaderCompiler), frameCount_(frameCount),
+      pThreadPool_(std::make_unique<ThreadPool>(threadCount, "Pipeline worker"))
+{
+}
+
+PipelineCompiler::~PipelineCompiler()
+{
+    // Join the workers first, a pipeline may still be in the middle of being created
+    pThreadPool_.reset();
+
+    for (const auto& [hash, shared] : pipelines_)
+    {
+        if (shared.pipeline.get() != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(device_, shared.pipeline.get(), nullptr);
+        }
+    }
+}
+
+PipelineHandle PipelineCompiler::compileGraphics(GraphicsPipelineDesc desc)
+{
+    Source source {
+        .name = desc.name,
+        .shaderModule = desc.shaderModule,
+        .shaderPath = desc.shaderPath,
+        .linkConstants = desc.linkConstants,
+        .stateHash = hashState(desc),
+    };
+    source.build = [this, desc = std::move(desc)](const std::vector<uint32_t>& spirv)
+    {
+        return buildGraphicsPipeline(desc, spirv);
+    };
+    return submit(std::move(source));
+}
+
+PipelineHandle PipelineCompiler::compileCompute(ComputePipelineDesc desc)
+{
+    Source source {
+        .name = desc.name,
+        .shaderModule = desc.shaderModule,
+        .shaderPath = desc.shaderPath,
+        .linkConstants = desc.linkConstants,
+        .stateHash = hashState(desc),
+    };
+    source.build = [this, desc = std::move(desc)](const std::vector<uint32_t>& spirv)
+    {
+        return buildComputePipeline(desc, spirv);
+    };
+    return submit(std::move(source));
+}
+
+PipelineHandle PipelineCompiler::submit(Source source)
+{
+    auto pFuture = std::make_shared<std::shared_future<VkPipeline>>(queue(source));
+    source.pHandleFuture = pFuture;
+    sources_.push_back(std::move(source));
+
+    return PipelineHandle(std::move(pFuture));
+}
+
+std::shared_future<VkPipeline> PipelineCompiler::queue(const Source& source)
+{
+    const auto submitTime = std::chrono::steady_clock::now();
+
+    auto future = pThreadPool_->submit([this, name = source.name, shaderModule = source.shaderModule,
+                                        shaderPath = source.shaderPath, linkConstants = source.linkConstants,
+                                        stateHash = source.stateHash, build = source.build, submitTime]
+    {
+        SPECTRA_TRACE_SCOPE("Compile pipeline");
+        const auto startTime = std::chrono::steady_clock::now();
+
+        CompileRecord record {
+            .name = name,
+            .queuedMs = std::chrono::duration<double, std::milli>(startTime - submitTime).count(),
+        };
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        const std::vector<uint32_t> spirv = shaderCompiler_.compile(shaderModule, shaderPath, linkConstants);
+        if (!spirv.empty())
+        {
+            const uint64_t hash = fnv1a(spirv.data(), spirv.size() * sizeof(uint32_t), stateHash);
+            pipeline = acquire(hash, [&] { return build(spirv); }, record.shared);
+        }
+
+        record.compileMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+        record.succeeded = pipeline != VK_NULL_HANDLE;
+        finish(std::move(record));
+
+        return pipeline;
+    });
+
+    return future.share();
+}
+
+void PipelineCompiler::reload(const std::vector<std::filesystem::path>& changedFiles)
+{
+    uint32_t rebuilds = 0;
+    for (Source& source : sources_)
+    {
+        if (source.pHandleFuture.expired())
+        {
+            continue;
+        }
+
+        // Imports are resolved again, the change itself may have added or removed some
+        const std::vector<std::filesystem::path> files = ShaderCompiler::sourceFiles(source.shaderPath);
+        const bool affected = std::ranges::any_of(files, [&](const std::filesystem::path& file)
+        {
+            return std::ranges::find(changedFiles, file) != changedFiles.end();
+        });
+        if (!affected)
+        {
+            continue;
+        }
+
+        if (source.rebuild.valid())
+        {
+            source.superseded.push_back(std::move(source.rebuild));
+        }
+        source.rebuild = queue(source);
+        rebuilds++;
+    }
+
+    for (const std::filesystem::path& file : changedFiles)
+    {
+        std::clog << std::format("Shader changed: {}\n", file.filename().generic_string());
+    }
+    std::clog << std::format("Rebuilding {} pipeline(s) in the background\n", rebuilds);
+}
+
+void PipelineCompiler::beginFrame()
+{
+    frameNumber_++;
+
+    for (Source& source : sources_)
+    {
+        // Nothing ever used an overtaken rebuild, it goes as soon as it is done
+        std::erase_if(source.superseded, [this](const std::shared_future<VkPipeline>& rebuild)
+        {
+            if (!isReady(rebuild))
+            {
+                return false;
+            }
+            destroyPipeline(rebuild.get());
+            return true;
+        });
+
+        if (!source.rebuild.valid() || !isReady(source.rebuild))
+        {
+            continue;
+        }
+        // A first build still running is waited for, so its pipeline can be retired like any other
+        const auto pHandleFuture = source.pHandleFuture.lock();
+        if (pHandleFuture && !isReady(*pHandleFuture))
+        {
+            continue;
+        }
+
+        const VkPipeline pipeline = source.rebuild.get();
+        if (!pHandleFuture || pipeline == VK_NULL_HANDLE)
+        {
+            // A failed rebuild keeps the old pipeline, the shader error has been logged
+            destroyPipeline(pipeline);
+            source.rebuild = {};
+            continue;
+        }
+
+        // Frames before this one may still use the old pipeline, it is freed once they have all retired
+        const VkPipeline oldPipeline = pHandleFuture->get();
+        if (oldPipeline != VK_NULL_HANDLE)
+        {
+            retired_.push_back({ oldPipeline, frameNumber_ + frameCount_ - 1 });
+        }
+        *pHandleFuture = std::move(source.rebuild);
+        source.rebuild = {};
+        reloadCount_++;
+        std::clog << std::format("Pipeline '{}' reloaded\n", source.name);
+    }
+
+    std::erase_if(sources_, [](const Source& source)
+    {
+        return source.pHandleFuture.expired() && !source.rebuild.valid() && source.superseded.empty();
+    });
+
+    std::erase_if(retired_, [this](const RetiredPipeline& retired)
+    {
+        if (retired.freeFrame > frameNumber_)
+        {
+            return false;
+        }
+        destroyPipeline(retired.pipeline);
+        return true;
+    });
+}
+
+VkPipeline PipelineCompiler::acquire(uint64_t hash, const std::function<VkPipeline()>& build, bool& shared)
+{
+    std::promise<VkPipeline> promise;
+    std::shared_future<VkPipeline> existing;
+    {
+        std::lock_guard lock(mutex_);
+        auto [it, inserted] = pipelines_.try_emplace(hash);
+        it->second.references++;
+        if (inserted)
+        {
+            it->second.pipeline = promise.get_future().share();
+        }
+        else
+        {
+            existing = it->second.pipeline;
+        }
+    }
+
+    // The entry was made by a build that is already running on another worker, so waiting for it cannot deadlock
+    if (existing.valid())
+    {
+        shared = true;
+        return existing.get();
+    }
+
+    const VkPipeline pipeline = build();
+    promise.set_value(pipeline);
+    if (pipeline == VK_NULL_HANDLE)
+    {
+        // The next attempt builds again rather than sharing the failure
+        std::lock_guard lock(mutex_);
+        pipelines_.erase(hash);
+    }
+    return pipeline;
+}
+
+void PipelineCompiler::destroyPipeline(VkPipeline pipeline)
+{
+    if (pipeline == VK_NULL_HANDLE)
+    {
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        const auto it = std::ranges::find_if(pipelines_, [&](const auto& entry)
+        {
+            return isReady(entry.second.pipeline) && entry.second.pipeline.get() == pipeline;
+        });
+        if (it == pipelines_.end() || --it->second.references > 0)
+        {
+            return;
+        }
+        pipelines_.erase(it);
+    }
+    vkDestroyPipeline(device_, pipeline, nullptr);
+}
+
+size_t PipelineCompiler::pipelineCount() const
+{
+    std::lock_guard lock(mutex_);
+    return pipelines_.size();
+}
+
+std::vector<PipelineCompiler::CompileRecord> PipelineCompiler::records() const
+{
+    std::lock_guard lock(mutex_);
+    return records_;
+}
+
+void PipelineCompiler::finish(CompileRecord record)
+{
+    if (!record.succeeded)
+    {
+        std::cerr << std::format("Pipeline '{}' failed to compile\n", record.name);
+    }
+    else if (record.shared)
+    {
+        std::clog << std::format("Pipeline '{}' compiled in {:.2f} ms (queued {:.2f} ms), identical to an existing one\n",
+                                 record.name, record.compileMs, record.queuedMs);
+    }
+    else
+    {
+        std::clog << std::format("Pipeline '{}' compiled in {:.2f} ms (queued {:.2f} ms)\n",
+                                 record.name, record.compileMs, record.queuedMs);
+    }
+
+    std::lock_guard lock(mutex_);
+    records_.push_back(std::move(record));
+}
+
+VkPipeline PipelineCompiler::buildGraphicsPipeline(const GraphicsPipelineDesc& desc, const std::vector<uint32_t>& spirv) const
+{
+    VkShaderModuleCreateInfo shaderModuleInfo {
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .codeSize = spirv.size() * sizeof(uint32_t),
+        .pCode = spirv.data(),
+    };
+
+    // Builds run on the worker pool, a failure leaves the pipeline null for the caller's fallback instead of aborting
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    VkResult result = vkCreateShaderModule(device_, &shaderModuleInfo, nullptr, &shaderModule);
+    if (result != VK_SUCCESS)
+    {
+        std::cerr << std::format("Failed to create shader module for {}: {}\n", desc.name, string_VkResult(result));
+        return VK_NULL_HANDLE;
+    }
+
+    const std::vector<VkSpecializationMapEntry> mapEntries = specializationEntries(desc.specialization);
+    const VkSpecializationInfo specializationInfo {
+        .mapEntryCount = static_cast<uint32_t>(mapEntries.size()),
+        .pMapEntries = mapEntries.data(),
+        .dataSize = desc.specialization.size() * sizeof(SpecializationConstant),
+        .pData = desc.specialization.data(),
+    };
+
+    VkPipelineShaderStageCreateInfo vertStageInfo = {};
+    vertStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    vertStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertStageInfo.module = shaderModule,
+    vertStageInfo.pName = desc.vertexEntry.c_str();
+    vertStageInfo.pSpecializationInfo = mapEntries.empty() ? nullptr : &specializationInfo;
+
+    VkPipelineShaderStageCreateInfo fragStageInfo = {};
+    fragStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    fragStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    fragStageInfo.module = shaderModule,
+    fragStageInfo.pName = desc.fragmentEntry.c_str();
+    fragStageInfo.pSpecializationInfo = mapEntries.empty() ? nullptr : &specializationInfo;
+
+    VkPipelineShaderStageCreateInfo shaderStages[] = { vertStageInfo, fragStageInfo };
+
+    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
+    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(desc.vertexBindings.size());
+    vertexInputInfo.pVertexBindingDescriptions = desc.vertexBindings.data();
+    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(desc.vertexAttributes.size());
+    vertexInputInfo.pVertexAttributeDescriptions = desc.vertexAttributes.data();
+
+    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
+    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    inputAssembly.primitiveRestartEnable = VK_FALSE;
+
+    // Viewport and scissor are dynamic
+    VkPipelineViewportStateCreateInfo viewportState = {};
+    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewportState.viewportCount = 1;
+    viewportState.scissorCount = 1;
+
+    VkPipelineRasterizationStateCreateInfo rasterizer = {};
+    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterizer.depthClampEnable = VK_FALSE;
+    rasterizer.rasterizerDiscardEnable = VK_FALSE;
+    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterizer.lineWidth = 1.0f;
+    rasterizer.cullMode = desc.cullMode;
+    rasterizer.frontFace = desc.frontFace;
+    rasterizer.depthBiasEnable = VK_FALSE;
+
+    VkPipelineMultisampleStateCreateInfo multisampling = {};
+    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisampling.sampleShadingEnable = VK_FALSE;
+    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    const bool hasColor = desc.colorFormat != VK_FORMAT_UNDEFINED;
+    VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
+    colorBlendAttachment.colorWriteMask =
+        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    colorBlendAttachment.blendEnable = VK_FALSE;
+
+    VkPipelineColorBlendStateCreateInfo colorBlendState = {};
+    colorBlendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    colorBlendState.logicOpEnable = VK_FALSE;
+    colorBlendState.logicOp = VK_LOGIC_OP_COPY;
+    colorBlendState.attachmentCount = hasColor ? 1 : 0;
+    colorBlendState.pAttachments = &colorBlendAttachment;
+    colorBlendState.blendConstants[0] = 0.0f;
+    colorBlendState.blendConstants[1] = 0.0f;
+    colorBlendState.blendConstants[2] = 0.0f;
+    colorBlendState.blendConstants[3] = 0.0f;
+
+    const bool hasDepth = desc.depthFormat != VK_FORMAT_UNDEFINED;
+    VkPipelineDepthStencilStateCreateInfo depthStencilState = {};
+    depthStencilState.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    depthStencilState.depthTestEnable = hasDepth ? VK_TRUE : VK_FALSE;
+    depthStencilState.depthWriteEnable = hasDepth ? VK_TRUE : VK_FALSE;
+    depthStencilState.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+    std::vector<VkDynamicState> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+    if (desc.dynamicDepthWrite)
+    {
+        dynamicStates.push_back(VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE);
+    }
+
+    VkPipelineDynamicStateCreateInfo dynamicState = {};
+    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+    dynamicState.pDynamicStates = dynamicStates.data();
+
+    VkPipelineRenderingCreateInfo pipelineRenderingInfo = {};
+    pipelineRenderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+    pipelineRenderingInfo.pNext = VK_NULL_HANDLE;
+    pipelineRenderingInfo.colorAttachmentCount = hasColor ? 1 : 0;
+    pipelineRenderingInfo.pColorAttachmentFormats = &desc.colorFormat;
+    pipelineRenderingInfo.depthAttachmentFormat   = desc.depthFormat;
+    pipelineRenderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+
+    VkGraphicsPipelineCreateInfo pipelineInfo = {};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.stageCount = desc.fragmentEntry.empty() ? 1 : 2;
+    pipelineInfo.pStages = shaderStages;
+    pipelineInfo.pVertexInputState = &vertexInputInfo;
+    pipelineInfo.pInputAssemblyState = &inputAssembly;
+    pipelineInfo.pViewportState = &viewportState;
+    pipelineInfo.pRasterizationState = &rasterizer;
+    pipelineInfo.pMultisampleState = &multisampling;
+    pipelineInfo.pDepthStencilState = &depthStencilState;
+    pipelineInfo.pColorBlendState = &colorBlendState;
+    pipelineInfo.pDynamicState = &dynamicState;
+    pipelineInfo.layout = desc.layout;
+    pipelineInfo.renderPass = VK_NULL_HANDLE;
+    pipelineInfo.subpass = 0;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineInfo.pNext = &pipelineRenderingInfo;
+
+    // The pipeline cache is internally synchronized, workers can share it
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    result = vkCreateGraphicsPipelines(device_, pipelineCache_, 1, &pipelineInfo, VK_NULL_HANDLE, &pipeline);
+    vkDestroyShaderModule(device_, shaderModule, nullptr);
+    if (result != VK_SUCCESS)
+    {
+        std::cerr << std::format("Failed to create pipeline {}: {}\n", desc.name, string_VkResult(result));
+        return VK_NULL_HANDLE;
+    }
+
+    return pipeline;
+}
+
+VkPipeline PipelineCompiler::buildComputePipeline(const ComputePipelineDesc& desc, const std::vector<uint32_t>& spirv) const
+{
+    VkShaderModuleCreateInfo shaderModuleInfo {
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .codeSize = spirv.size() * sizeof(uint32_t),
+        .pCode = spirv.data(),
+    };
+
+    // Builds run on the worker pool, a failure leaves the pipeline null for the caller's fallback instead of aborting
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    VkResult result = vkCreateShaderModule(device_, &shaderModuleInfo, nullptr, &shaderModule);
+    if (result != VK_SUCCESS)
+    {
+        std::cerr << std::format("Failed to create shader module for {}: {}\n", desc.name, string_VkResult(result));
+        return VK_NULL_HANDLE;
+    }
+
+    const std::vector<VkSpecializationMapEntry> mapEntries = specializationEntries(desc.specialization);
+    const VkSpecializationInfo specializationInfo {
+        .mapEntryCount = static_cast<uint32_t>(mapEntries.size()),
+        .pMapEntries = mapEntries.data(),
+        .dataSize = desc.specialization.size() * sizeof(SpecializationConstant),
+        .pData = desc.specialization.data(),
+    };
+
+    VkComputePipelineCreateInfo pipelineInfo {
+        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .stage = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+            .module = shaderModule,
+            .pName = desc.entry.c_str(),
+            .pSpecializationInfo = mapEntries.empty() ? nullptr : &specializationInfo,
+        },
+        .layout = desc.layout,
+    };
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    result = vkCreateComputePipelines(device_, pipelineCache_, 1, &pipelineInfo, VK_NULL_HANDLE, &pipeline);
+    vkDestroyShaderModule(device_, shaderModule, nullptr);
+    if (result != VK_SUCCESS)
+    {
+        std::cerr << std::format("Failed to create pipeline {}: {}\n", desc.name, string_VkResult(result));
+        return VK_NULL_HANDLE;
+    }
+
+    return pipeline;
+}
+} // spectra
@@ -0,0 +1,184 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_PIPELINECOMPILER_H
+#define SPECTRA_PIPELINECOMPILER_H
+
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "ShaderCompiler.h"
+#include "ThreadPool.h"
+
+namespace spectra {
+// Value of a `[vk::constant_id(id)]` constant, folded by the driver when it builds the pipeline. Bools take 0 or 1.
+struct SpecializationConstant
+{
+    uint32_t id = 0;
+    uint32_t value = 0;
+};
+
+struct GraphicsPipelineDesc
+{
+    std::string name;
+    std::string shaderModule;
+    std::filesystem::path shaderPath;
+    std::string vertexEntry = "vertexMain";
+    std::string fragmentEntry = "fragmentMain"; // Empty for a vertex-only pipeline, e.g. a depth prepass
+    std::vector<ShaderCompiler::LinkConstant> linkConstants;
+    std::vector<SpecializationConstant> specialization; // Shared by both stages
+
+    std::vector<VkVertexInputBindingDescription> vertexBindings;
+    std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    VkFormat colorFormat = VK_FORMAT_UNDEFINED; // Undefined for no color attachment
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED; // Depth test and write are enabled with a depth attachment
+    bool dynamicDepthWrite = false; // Set with vkCmdSetDepthWriteEnable, e.g. to test against a prepass
+    VkCullModeFlags cullMode = VK_CULL_MODE_BACK_BIT;
+    VkFrontFace frontFace = VK_FRONT_FACE_CLOCKWISE;
+};
+
+struct ComputePipelineDesc
+{
+    std::string name;
+    std::string shaderModule;
+    std::filesystem::path shaderPath;
+    std::string entry = "computeMain";
+    std::vector<ShaderCompiler::LinkConstant> linkConstants;
+    std::vector<SpecializationConstant> specialization;
+
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+};
+
+// Shared handle to a pipeline that may still be compiling. Copies refer to the same pipeline, which a shader reload
+// replaces in PipelineCompiler::beginFrame().
+class PipelineHandle {
+public:
+    PipelineHandle() = default;
+
+    [[nodiscard]] bool ready() const
+    {
+        return pFuture_ && pFuture_->valid() && pFuture_->wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    // Never blocks, returns VK_NULL_HANDLE while compiling or if compilation failed
+    [[nodiscard]] VkPipeline get() const { return ready() ? pFuture_->get() : VK_NULL_HANDLE; }
+
+    VkPipeline wait() const { return pFuture_ && pFuture_->valid() ? pFuture_->get() : VK_NULL_HANDLE; }
+
+private:
+    friend class PipelineCompiler;
+    explicit PipelineHandle(std::shared_ptr<std::shared_future<VkPipeline>> pFuture) : pFuture_(std::move(pFuture)) {}
+
+    std::shared_ptr<std::shared_future<VkPipeline>> pFuture_;
+};
+
+// Compiles shaders and builds pipelines on worker threads. Owns every pipeline it creates. Pipelines whose SPIR-V and
+// state hash the same are built once and shared by their handles, so permutations that compile to identical code
+// cost a single pipeline.
+//
+// reload() rebuilds the pipelines whose shader sources changed on the workers while frames keep using the old ones.
+// beginFrame() swaps finished rebuilds into their handles and destroys replaced pipelines once no frame in flight can
+// use them; a rebuild that fails keeps the old pipeline. compile*(), reload() and beginFrame() are called from the
+// render thread.
+class PipelineCompiler {
+public:
+    struct CompileRecord
+    {
+        std::string name;
+        double queuedMs = 0.0;  // Time spent waiting for a worker
+        double compileMs = 0.0; // Shader compilation plus vkCreate*Pipelines
+        bool succeeded = false;
+        bool shared = false; // Identical to a pipeline that already existed, nothing was built
+    };
+
+    PipelineCompiler(VkDevice device, VkPipelineCache pipelineCache, ShaderCompiler& shaderCompiler,
+                     uint32_t frameCount, uint32_t threadCount = 2);
+    ~PipelineCompiler();
+
+    PipelineCompiler(const PipelineCompiler&) = delete;
+    PipelineCompiler& operator=(const PipelineCompiler&) = delete;
+
+    PipelineHandle compileGraphics(GraphicsPipelineDesc desc);
+    PipelineHandle compileCompute(ComputePipelineDesc desc);
+
+    // Rebuilds every live pipeline whose shader source or one of its imports is among the changed files
+    void reload(const std::vector<std::filesystem::path>& changedFiles);
+    // Call once per frame, after the frame slot wait and before recording
+    void beginFrame();
+
+    [[nodiscard]] std::vector<CompileRecord> records() const;
+    [[nodiscard]] uint32_t reloadCount() const { return reloadCount_; }
+    // Distinct pipelines alive, shared ones count once
+    [[nodiscard]] size_t pipelineCount() const;
+
+private:
+    using BuildFunction = std::function<VkPipeline(const std::vector<uint32_t>& spirv)>;
+
+    // What it takes to build a handle's pipeline again
+    struct Source
+    {
+        std::string name;
+        std::string shaderModule;
+        std::filesystem::path shaderPath;
+        std::vector<ShaderCompiler::LinkConstant> linkConstants;
+        uint64_t stateHash = 0; // Everything besides the SPIR-V that the build depends on
+        BuildFunction build;
+        std::weak_ptr<std::shared_future<VkPipeline>> pHandleFuture; // Expired once every handle is gone
+        std::shared_future<VkPipeline> rebuild;
+        std::vector<std::shared_future<VkPipeline>> superseded; // Rebuilds overtaken by a newer change
+    };
+
+    struct RetiredPipeline
+    {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        uint64_t freeFrame = 0; // First frame number at which no submitted frame can still use it
+    };
+
+    // A pipeline built once for every handle with the same SPIR-V and state
+    struct SharedPipeline
+    {
+        std::shared_future<VkPipeline> pipeline;
+        uint32_t references = 0;
+    };
+
+    PipelineHandle submit(Source source);
+    // Queues shader compilation followed by the build on a worker
+    std::shared_future<VkPipeline> queue(const Source& source);
+    // Takes a reference to the pipeline with this hash, building it unless it exists. Runs on a worker.
+    VkPipeline acquire(uint64_t hash, const std::function<VkPipeline()>& build, bool& shared);
+    // Drops a reference, the last one destroys the pipeline
+    void destroyPipeline(VkPipeline pipeline);
+    VkPipeline buildGraphicsPipeline(const GraphicsPipelineDesc& desc, const std::vector<uint32_t>& spirv) const;
+    VkPipeline buildComputePipeline(const ComputePipelineDesc& desc, const std::vector<uint32_t>& spirv) const;
+    void finish(CompileRecord record);
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VkPipelineCache pipelineCache_ = VK_NULL_HANDLE;
+    ShaderCompiler& shaderCompiler_;
+    uint32_t frameCount_ = 0;
+
+    std::vector<Source> sources_;
+    std::vector<RetiredPipeline> retired_;
+    uint64_t frameNumber_ = 0;
+    uint32_t reloadCount_ = 0;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, SharedPipeline> pipelines_; // By SPIR-V and state hash
+    std::vector<CompileRecord> records_;
+
+    std::unique_ptr<ThreadPool> pThreadPool_;
+};
+} // spectra
+
+#endif //SPECTRA_PIPELINECOMPILER_H
@@ -0,0 +1,61 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "PipelinePermutations.h"
+
+#include <format>
+
+namespace spectra {
+PipelinePermutations::PipelinePermutations(PipelineCompiler& compiler, GraphicsPipelineDesc desc,
+                                           std::vector<Feature> features)
+    : pCompiler_(&compiler), desc_(std::move(desc)), features_(std::move(features))
+{
+}
+
+const PipelineHandle& PipelinePermutations::request(uint32_t features)
+{
+    if (const auto it = variants_.find(features); it != variants_.end())
+    {
+        return it->second;
+    }
+
+    // Every feature is set either way, a shader declaring an extern constant fails to link without it
+    GraphicsPipelineDesc desc = desc_;
+    std::string enabled;
+    for (size_t i = 0; i < features_.size(); i++)
+    {
+        const Feature& feature = features_[i];
+        const uint32_t value = (features >> i) & 1U;
+        if (feature.constantId == LINK_CONSTANT)
+        {
+            desc.linkConstants.push_back({ feature.name, static_cast<int>(value) });
+        }
+        else
+        {
+            desc.specialization.push_back({ feature.constantId, value });
+        }
+        if (value != 0)
+        {
+            enabled += enabled.empty() ? feature.name : "+" + feature.name;
+        }
+    }
+    desc.name = std::format("{}[{}]", desc_.name, enabled);
+
+    return variants_.emplace(features, pCompiler_->compileGraphics(std::move(desc))).first->second;
+}
+
+VkPipeline PipelinePermutations::get(uint32_t features, uint32_t fallback)
+{
+    const VkPipeline pipeline = request(features).get();
+    return pipeline != VK_NULL_HANDLE ? pipeline : request(fallback).get();
+}
+
+void PipelinePermutations::wait() const
+{
+    for (const auto& [features, handle] : variants_)
+    {
+        handle.wait();
+    }
+}
+} // spectra
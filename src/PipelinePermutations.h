@@ -0,0 +1,49 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_PIPELINEPERMUTATIONS_H
+#define SPECTRA_PIPELINEPERMUTATIONS_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PipelineCompiler.h"
+
+namespace spectra {
+// Variants of one graphics pipeline, selected by a mask of feature bits. Feature i of the mask sets a constant of the
+// shader to 0 or 1: either a link-time constant, which Slang folds before emitting SPIR-V, or a specialization
+// constant, which the driver folds when building the pipeline. Variants are compiled the first time they are asked
+// for; the PipelineCompiler builds variants that end up with identical code and state only once.
+class PipelinePermutations {
+public:
+    static constexpr uint32_t LINK_CONSTANT = ~0U;
+
+    struct Feature
+    {
+        std::string name; // Of the link-time constant, also names the variants
+        uint32_t constantId = LINK_CONSTANT; // Specialization constant id instead, when set
+    };
+
+    PipelinePermutations() = default;
+    PipelinePermutations(PipelineCompiler& compiler, GraphicsPipelineDesc desc, std::vector<Feature> features);
+
+    // Queues the variant on first use, the handle may still be compiling
+    const PipelineHandle& request(uint32_t features);
+    // Pipeline of the variant, or of the fallback variant until it has compiled. Never blocks.
+    VkPipeline get(uint32_t features, uint32_t fallback);
+    // Blocks until every variant requested so far has compiled
+    void wait() const;
+
+    [[nodiscard]] size_t variantCount() const { return variants_.size(); }
+
+private:
+    PipelineCompiler* pCompiler_ = nullptr;
+    GraphicsPipelineDesc desc_;
+    std::vector<Feature> features_;
+    std::unordered_map<uint32_t, PipelineHandle> variants_; // By feature mask
+};
+} // spectra
+
+#endif //SPECTRA_PIPELINEPERMUTATIONS_H
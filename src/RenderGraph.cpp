@@ -0,0 +1,577 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <format>
+#include <iostream>
+
+#include "vk/Error.h"
+
+namespace spectra {
+namespace {
+struct UsageInfo
+{
+    VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+    VkAccessFlags2 readAccess = VK_ACCESS_2_NONE;
+    VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+};
+
+UsageInfo usageInfo(RenderGraph::Usage usage)
+{
+    using Usage = RenderGraph::Usage;
+    switch (usage)
+    {
+    case Usage::ColorAttachment:
+        return { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT,
+                 VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    case Usage::DepthAttachment:
+        return { VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                 VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                 VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL };
+    case Usage::SampledCompute:
+        return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_ACCESS_2_NONE,
+                 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    case Usage::SampledFragment:
+        return { VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, VK_ACCESS_2_NONE,
+                 VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+    case Usage::StorageCompute:
+        return { VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                 VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT, VK_IMAGE_LAYOUT_GENERAL };
+    case Usage::IndirectCommand:
+        return { VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT, VK_ACCESS_2_NONE,
+                 VK_IMAGE_LAYOUT_UNDEFINED };
+    case Usage::TransferSrc:
+        return { VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_ACCESS_2_NONE,
+                 VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL };
+    case Usage::TransferDst:
+        return { VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT, VK_ACCESS_2_NONE, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL };
+    }
+    return {};
+}
+
+// Where the last write to a resource happened and which later accesses have seen it
+struct SyncState
+{
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags2 writeStages = VK_PIPELINE_STAGE_2_NONE;
+    VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+    VkPipelineStageFlags2 readStages = VK_PIPELINE_STAGE_2_NONE; // Reads since the last write
+    VkPipelineStageFlags2 visibleStages = VK_PIPELINE_STAGE_2_NONE;
+    VkAccessFlags2 visibleAccess = VK_ACCESS_2_NONE;
+};
+
+bool isDepthFormat(VkFormat format)
+{
+    return format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_D32_SFLOAT || format == VK_FORMAT_X8_D24_UNORM_PACK32 ||
+           format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT ||
+           format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+}
+
+VkImageCreateInfo imageCreateInfo(const RenderGraph::ImageDesc& desc)
+{
+    return {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = desc.format,
+        .extent = { desc.extent.width, desc.extent.height, 1 },
+        .mipLevels = desc.mipLevels,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = desc.usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+}
+
+bool sameDesc(const RenderGraph::ImageDesc& a, const RenderGraph::ImageDesc& b)
+{
+    return a.format == b.format && a.extent.width == b.extent.width && a.extent.height == b.extent.height &&
+           a.mipLevels == b.mipLevels && a.usage == b.usage;
+}
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+void pipelineBarrier(VkCommandBuffer cb, const std::vector<VkImageMemoryBarrier2>& imageBarriers,
+                     const std::vector<VkBufferMemoryBarrier2>& bufferBarriers)
+{
+    if (imageBarriers.empty() && bufferBarriers.empty())
+    {
+        return;
+    }
+
+    const VkDependencyInfo dependencyInfo {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size()),
+        .pBufferMemoryBarriers = bufferBarriers.data(),
+        .imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size()),
+        .pImageMemoryBarriers = imageBarriers.data(),
+    };
+    vkCmdPipelineBarrier2(cb, &dependencyInfo);
+}
+} // namespace
+
+RenderGraph::RenderGraph(VkDevice device, VmaAllocator allocator, uint32_t frameCount)
+    : device_(device), allocator_(allocator), blocks_(frameCount)
+{
+}
+
+RenderGraph::~RenderGraph()
+{
+    for (TransientBlock& block : blocks_)
+    {
+        destroy(block);
+    }
+}
+
+void RenderGraph::reset(uint32_t frameIndex)
+{
+    frameIndex_ = frameIndex;
+    resources_.clear();
+    passes_.clear();
+    finalBarriers_.clear();
+}
+
+uint32_t RenderGraph::importImage(std::string name, VkImage image, VkImageView view, const ImageDesc& desc,
+                                  VkImageLayout initialLayout, VkPipelineStageFlags2 initialStage,
+                                  VkImageLayout finalLayout)
+{
+    return addResource({
+        .name = std::move(name),
+        .kind = Kind::ImportedImage,
+        .desc = desc,
+        .aspect = isDepthFormat(desc.format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT,
+        .image = image,
+        .view = view,
+        .initialLayout = initialLayout,
+        .initialStage = initialStage,
+        .finalLayout = finalLayout,
+        .output = true,
+    });
+}
+
+uint32_t RenderGraph::importBuffer(std::string name, VkBuffer buffer, VkPipelineStageFlags2 initialStage,
+                                   VkAccessFlags2 initialAccess)
+{
+    return addResource({
+        .name = std::move(name),
+        .kind = Kind::ImportedBuffer,
+        .buffer = buffer,
+        .initialStage = initialStage,
+        .initialAccess = initialAccess,
+    });
+}
+
+uint32_t RenderGraph::createImage(std::string name, const ImageDesc& desc)
+{
+    return addResource({
+        .name = std::move(name),
+        .kind = Kind::TransientImage,
+        .desc = desc,
+        .aspect = isDepthFormat(desc.format) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT,
+    });
+}
+
+void RenderGraph::markOutput(uint32_t resource)
+{
+    resources_[resource].output = true;
+}
+
+uint32_t RenderGraph::addPass(std::string name, ExecuteFn execute)
+{
+    passes_.push_back({ .name = std::move(name), .execute = std::move(execute) });
+    return static_cast<uint32_t>(passes_.size() - 1);
+}
+
+void RenderGraph::read(uint32_t pass, uint32_t resource, Usage usage)
+{
+    access(pass, resource, usage, false);
+}
+
+void RenderGraph::write(uint32_t pass, uint32_t resource, Usage usage)
+{
+    access(pass, resource, usage, true);
+}
+
+void RenderGraph::compile()
+{
+    stats_ = {};
+    stats_.passes = static_cast<uint32_t>(passes_.size());
+
+    cullPasses();
+    placeTransients();
+    buildBarriers();
+}
+
+void RenderGraph::execute(VkCommandBuffer cb) const
+{
+    for (const Pass& pass : passes_)
+    {
+        if (!pass.live)
+        {
+            continue;
+        }
+        pipelineBarrier(cb, pass.imageBarriers, pass.bufferBarriers);
+        pass.execute(cb);
+    }
+    pipelineBarrier(cb, finalBarriers_, {});
+}
+
+uint32_t RenderGraph::addResource(Resource resource)
+{
+    resources_.push_back(std::move(resource));
+    return static_cast<uint32_t>(resources_.size() - 1);
+}
+
+void RenderGraph::access(uint32_t pass, uint32_t resource, Usage usage, bool write)
+{
+    assert(pass < passes_.size() && resource < resources_.size());
+
+    // Reading and writing in the same pass is one access, the usage decides the layout so it has to agree
+    std::vector<Access>& accesses = passes_[pass].accesses;
+    const auto it = std::ranges::find(accesses, resource, &Access::resource);
+    if (it != accesses.end())
+    {
+        assert(it->usage == usage && "A pass accesses a resource with one usage");
+        it->read |= !write;
+        it->write |= write;
+        return;
+    }
+    accesses.push_back({ .resource = resource, .usage = usage, .read = !write, .write = write });
+}
+
+void RenderGraph::cullPasses()
+{
+    // Walking back from the outputs, a pass is live when it writes something a live pass or the frame still needs.
+    // A pass that only writes a resource starts its contents afresh, writers before it are not needed for it.
+    std::vector<bool> needed(resources_.size());
+    for (size_t i = 0; i < resources_.size(); i++)
+    {
+        needed[i] = resources_[i].output;
+    }
+
+    for (auto pass = passes_.rbegin(); pass != passes_.rend(); ++pass)
+    {
+        pass->live = std::ranges::any_of(pass->accesses, [&](const Access& access)
+        {
+            return access.write && needed[access.resource];
+        });
+        if (!pass->live)
+        {
+            stats_.culledPasses++;
+            continue;
+        }
+
+        for (const Access& access : pass->accesses)
+        {
+            if (access.write && !access.read)
+            {
+                needed[access.resource] = false;
+            }
+        }
+        for (const Access& access : pass->accesses)
+        {
+            if (access.read)
+            {
+                needed[access.resource] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::placeTransients()
+{
+    // Lifetimes span the live passes using a transient, images only touched by culled passes get no memory
+    std::vector<uint32_t> transients;
+    for (uint32_t passIndex = 0; passIndex < passes_.size(); passIndex++)
+    {
+        if (!passes_[passIndex].live)
+        {
+            continue;
+        }
+        for (const Access& access : passes_[passIndex].accesses)
+        {
+            Resource& resource = resources_[access.resource];
+            if (resource.kind != Kind::TransientImage)
+            {
+                continue;
+            }
+            if (resource.firstPass == ~0U)
+            {
+                resource.firstPass = passIndex;
+                transients.push_back(access.resource);
+            }
+            resource.lastPass = passIndex;
+        }
+    }
+
+    for (const uint32_t index : transients)
+    {
+        Resource& resource = resources_[index];
+        const VkImageCreateInfo createInfo = imageCreateInfo(resource.desc);
+        const VkDeviceImageMemoryRequirements requirementsInfo {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+            .pCreateInfo = &createInfo,
+        };
+        VkMemoryRequirements2 requirements { .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2 };
+        vkGetDeviceImageMemoryRequirements(device_, &requirementsInfo, &requirements);
+        resource.memory = requirements.memoryRequirements;
+    }
+
+    // Largest first, each image goes to the lowest offset that does not overlap an image alive at the same time
+    std::ranges::stable_sort(transients, std::greater{}, [&](uint32_t index) { return resources_[index].memory.size; });
+
+    VkMemoryRequirements blockRequirements { .alignment = 1, .memoryTypeBits = ~0U };
+    for (size_t i = 0; i < transients.size(); i++)
+    {
+        Resource& resource = resources_[transients[i]];
+        resource.offset = 0;
+        for (bool moved = true; moved;)
+        {
+            moved = false;
+            for (size_t j = 0; j < i; j++)
+            {
+                const Resource& placed = resources_[transients[j]];
+                const bool livesTogether = placed.firstPass <= resource.lastPass &&
+                                           resource.firstPass <= placed.lastPass;
+                const bool overlaps = placed.offset < resource.offset + resource.memory.size &&
+                                      resource.offset < placed.offset + placed.memory.size;
+                if (livesTogether && overlaps)
+                {
+                    resource.offset = alignUp(placed.offset + placed.memory.size, resource.memory.alignment);
+                    moved = true;
+                }
+            }
+        }
+
+        blockRequirements.size = std::max(blockRequirements.size, resource.offset + resource.memory.size);
+        blockRequirements.alignment = std::max(blockRequirements.alignment, resource.memory.alignment);
+        blockRequirements.memoryTypeBits &= resource.memory.memoryTypeBits;
+        stats_.transientBytes += resource.memory.size;
+    }
+    stats_.transientImages = static_cast<uint32_t>(transients.size());
+    stats_.allocatedBytes = blockRequirements.size;
+
+    // The previous frame using this block has finished, so an unchanged placement keeps its images
+    TransientBlock& block = blocks_[frameIndex_];
+    const bool unchanged = block.images.size() == transients.size() &&
+                           std::ranges::equal(block.images, transients, [&](const TransientImage& image, uint32_t index)
+                           {
+                               const Resource& resource = resources_[index];
+                               return sameDesc(image.desc, resource.desc) && image.offset == resource.offset;
+                           });
+    if (!unchanged)
+    {
+        destroy(block);
+        if (!transients.empty())
+        {
+            const VmaAllocationCreateInfo allocCreateInfo {
+                .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            };
+            CHECK_VK(vmaAllocateMemory(allocator_, &blockRequirements, &allocCreateInfo, &block.alloc, nullptr))
+            block.size = blockRequirements.size;
+
+            for (const uint32_t index : transients)
+            {
+                const Resource& resource = resources_[index];
+                TransientImage image {
+                    .desc = resource.desc,
+                    .aspect = resource.aspect,
+                    .offset = resource.offset,
+                };
+                const VkImageCreateInfo createInfo = imageCreateInfo(resource.desc);
+                CHECK_VK(vmaCreateAliasingImage2(allocator_, block.alloc, resource.offset, &createInfo, &image.image))
+
+                const VkImageViewCreateInfo viewCreateInfo {
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                    .image = image.image,
+                    .viewType = VK_IMAGE_VIEW_TYPE_2D,
+                    .format = resource.desc.format,
+                    .subresourceRange = { resource.aspect, 0, resource.desc.mipLevels, 0, 1 },
+                };
+                CHECK_VK(vkCreateImageView(device_, &viewCreateInfo, nullptr, &image.view))
+                block.images.push_back(image);
+            }
+
+            std::clog << std::format("Render graph: {} transient images, {:.1f} MiB placed in {:.1f} MiB\n",
+                                     transients.size(), stats_.transientBytes / (1024.0 * 1024.0),
+                                     block.size / (1024.0 * 1024.0));
+        }
+    }
+
+    for (size_t i = 0; i < transients.size(); i++)
+    {
+        resources_[transients[i]].image = block.images[i].image;
+        resources_[transients[i]].view = block.images[i].view;
+    }
+}
+
+void RenderGraph::buildBarriers()
+{
+    std::vector<SyncState> states(resources_.size());
+    for (size_t i = 0; i < resources_.size(); i++)
+    {
+        states[i].layout = resources_[i].initialLayout;
+        states[i].writeStages = resources_[i].initialStage;
+        states[i].writeAccess = resources_[i].initialAccess;
+    }
+
+    for (uint32_t passIndex = 0; passIndex < passes_.size(); passIndex++)
+    {
+        Pass& pass = passes_[passIndex];
+        if (!pass.live)
+        {
+            continue;
+        }
+
+        for (const Access& access : pass.accesses)
+        {
+            const Resource& resource = resources_[access.resource];
+            SyncState& state = states[access.resource];
+            const UsageInfo info = usageInfo(access.usage);
+            const VkAccessFlags2 accessFlags = (access.read ? info.readAccess : VK_ACCESS_2_NONE) |
+                                               (access.write ? info.writeAccess : VK_ACCESS_2_NONE);
+            const bool isImage = resource.kind != Kind::ImportedBuffer;
+
+            // A transient takes over its memory from the images placed there before it, which must be done with it
+            if (resource.kind == Kind::TransientImage && resource.firstPass == passIndex)
+            {
+                for (size_t i = 0; i < resources_.size(); i++)
+                {
+                    const Resource& previous = resources_[i];
+                    if (previous.kind == Kind::TransientImage && previous.firstPass != ~0U &&
+                        previous.lastPass < passIndex && previous.offset < resource.offset + resource.memory.size &&
+                        resource.offset < previous.offset + previous.memory.size)
+                    {
+                        state.writeStages |= states[i].writeStages | states[i].readStages;
+                        state.writeAccess |= states[i].writeAccess;
+                    }
+                }
+            }
+
+            VkPipelineStageFlags2 srcStages = VK_PIPELINE_STAGE_2_NONE;
+            VkAccessFlags2 srcAccess = VK_ACCESS_2_NONE;
+            const bool transition = isImage && state.layout != info.layout;
+            bool barrier = false;
+            if (transition || access.write)
+            {
+                // Transitions and writes wait for every earlier access and make the last write available
+                srcStages = state.writeStages | state.readStages;
+                srcAccess = state.writeAccess;
+                barrier = transition || srcStages != VK_PIPELINE_STAGE_2_NONE;
+
+                // A read-only transition acts as a write the next readers have to wait for
+                state.writeStages = info.stages;
+                state.writeAccess = access.write ? info.writeAccess : VK_ACCESS_2_NONE;
+                state.readStages = access.write ? VK_PIPELINE_STAGE_2_NONE : info.stages;
+                state.visibleStages = access.write ? VK_PIPELINE_STAGE_2_NONE : info.stages;
+                state.visibleAccess = access.write ? VK_ACCESS_2_NONE : accessFlags;
+            }
+            else
+            {
+                // Reads in the same layout only wait when the last write is not yet visible to them
+                barrier = state.writeStages != VK_PIPELINE_STAGE_2_NONE &&
+                          ((info.stages & ~state.visibleStages) != 0 || (accessFlags & ~state.visibleAccess) != 0);
+                if (barrier)
+                {
+                    srcStages = state.writeStages;
+                    srcAccess = state.writeAccess;
+                }
+                state.readStages |= info.stages;
+                state.visibleStages |= info.stages;
+                state.visibleAccess |= accessFlags;
+            }
+
+            if (!barrier)
+            {
+                continue;
+            }
+            if (isImage)
+            {
+                pass.imageBarriers.push_back({
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                    .srcStageMask = srcStages,
+                    .srcAccessMask = srcAccess,
+                    .dstStageMask = info.stages,
+                    .dstAccessMask = accessFlags,
+                    .oldLayout = transition ? state.layout : info.layout,
+                    .newLayout = info.layout,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .image = resource.image,
+                    .subresourceRange = { resource.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS },
+                });
+                state.layout = info.layout;
+            }
+            else
+            {
+                pass.bufferBarriers.push_back({
+                    .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                    .srcStageMask = srcStages,
+                    .srcAccessMask = srcAccess,
+                    .dstStageMask = info.stages,
+                    .dstAccessMask = accessFlags,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .buffer = resource.buffer,
+                    .offset = 0,
+                    .size = VK_WHOLE_SIZE,
+                });
+            }
+        }
+
+        stats_.imageBarriers += static_cast<uint32_t>(pass.imageBarriers.size());
+        stats_.bufferBarriers += static_cast<uint32_t>(pass.bufferBarriers.size());
+        stats_.barrierBatches += pass.imageBarriers.empty() && pass.bufferBarriers.empty() ? 0 : 1;
+    }
+
+    // Imported images are handed back in their final layout, whatever waits on them next synchronizes on its own
+    for (size_t i = 0; i < resources_.size(); i++)
+    {
+        const Resource& resource = resources_[i];
+        const SyncState& state = states[i];
+        if (resource.kind != Kind::ImportedImage || state.layout == resource.finalLayout)
+        {
+            continue;
+        }
+        finalBarriers_.push_back({
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .srcStageMask = state.writeStages | state.readStages,
+            .srcAccessMask = state.writeAccess,
+            .dstStageMask = VK_PIPELINE_STAGE_2_NONE,
+            .dstAccessMask = VK_ACCESS_2_NONE,
+            .oldLayout = state.layout,
+            .newLayout = resource.finalLayout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = resource.image,
+            .subresourceRange = { resource.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS },
+        });
+    }
+    stats_.imageBarriers += static_cast<uint32_t>(finalBarriers_.size());
+    stats_.barrierBatches += finalBarriers_.empty() ? 0 : 1;
+}
+
+void RenderGraph::destroy(TransientBlock& block) const
+{
+    for (const TransientImage& image : block.images)
+    {
+        vkDestroyImageView(device_, image.view, nullptr);
+        vkDestroyImage(device_, image.image, nullptr);
+    }
+    if (block.alloc != VK_NULL_HANDLE)
+    {
+        vmaFreeMemory(allocator_, block.alloc);
+    }
+    block = {};
+}
+} // spectra
@@ -0,0 +1,184 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_RENDERGRAPH_H
+#define SPECTRA_RENDERGRAPH_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <vk_mem_alloc.h>
+
+namespace spectra {
+// Frame graph, rebuilt every frame. Passes declare the images and buffers they read and write; compile() drops the
+// passes nothing consumes, derives every barrier between the remaining ones from the declared usages and batches the
+// barriers a pass needs into a single vkCmdPipelineBarrier2 before it. Imported resources are owned elsewhere,
+// transient images only live within the frame: they are placed in one memory block per frame in flight, sharing
+// memory where their lifetimes do not overlap, and the block is kept as long as the placement stays the same.
+// Not thread safe.
+class RenderGraph {
+public:
+    static constexpr uint32_t INVALID_RESOURCE = ~0U;
+
+    // How a pass accesses a resource, which sets the stages, access flags and image layout of the access
+    enum class Usage
+    {
+        ColorAttachment,
+        DepthAttachment,
+        SampledCompute,
+        SampledFragment,
+        StorageCompute,   // GENERAL layout for images
+        IndirectCommand,  // Buffers only
+        TransferSrc,
+        TransferDst,
+    };
+
+    struct ImageDesc
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        VkExtent2D extent{};
+        uint32_t mipLevels = 1;
+        VkImageUsageFlags usage = 0; // Transient images only
+    };
+
+    struct Stats
+    {
+        uint32_t passes = 0;
+        uint32_t culledPasses = 0;
+        uint32_t barrierBatches = 0; // vkCmdPipelineBarrier2 calls
+        uint32_t imageBarriers = 0;
+        uint32_t bufferBarriers = 0;
+        uint32_t transientImages = 0;
+        VkDeviceSize transientBytes = 0; // Sum of the transient image sizes
+        VkDeviceSize allocatedBytes = 0; // Memory block they share
+    };
+
+    using ExecuteFn = std::function<void(VkCommandBuffer)>;
+
+    RenderGraph(VkDevice device, VmaAllocator allocator, uint32_t frameCount);
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    // Starts a new graph for the frame in flight frameIndex, whose previous frame must have finished
+    void reset(uint32_t frameIndex);
+
+    // An image in initialLayout whose last writes happened before initialStage; initialLayout undefined discards its
+    // contents. The image is left in finalLayout, which makes it an output of the graph.
+    uint32_t importImage(std::string name, VkImage image, VkImageView view, const ImageDesc& desc,
+                         VkImageLayout initialLayout, VkPipelineStageFlags2 initialStage, VkImageLayout finalLayout);
+    // A buffer whose last writes were initialAccess before initialStage, e.g. by the previous frame. The default
+    // leaves it to the frame pacing to synchronize it with earlier frames. It only is an output when marked as one.
+    uint32_t importBuffer(std::string name, VkBuffer buffer, VkPipelineStageFlags2 initialStage = VK_PIPELINE_STAGE_2_NONE,
+                          VkAccessFlags2 initialAccess = VK_ACCESS_2_NONE);
+    // An image that only lives within the frame, undefined at its first use
+    uint32_t createImage(std::string name, const ImageDesc& desc);
+    // Keeps the passes writing the resource, used for resources read outside the graph
+    void markOutput(uint32_t resource);
+
+    uint32_t addPass(std::string name, ExecuteFn execute);
+    // Reading and writing a resource in one pass keeps its contents, e.g. an attachment that is loaded. A pass only
+    // writing it starts a new version, which culls the earlier writers no other pass reads from.
+    void read(uint32_t pass, uint32_t resource, Usage usage);
+    void write(uint32_t pass, uint32_t resource, Usage usage);
+
+    // Culls passes, places and creates the transient images and derives the barriers
+    void compile();
+    // Records the live passes with their barriers, and the transitions to the final layouts of imported images
+    void execute(VkCommandBuffer cb) const;
+
+    // Valid from compile() until the next reset(), also inside the execute functions
+    [[nodiscard]] VkImage image(uint32_t resource) const { return resources_[resource].image; }
+    [[nodiscard]] VkImageView imageView(uint32_t resource) const { return resources_[resource].view; }
+    [[nodiscard]] VkBuffer buffer(uint32_t resource) const { return resources_[resource].buffer; }
+
+    // Of the last compiled graph
+    [[nodiscard]] const Stats& stats() const { return stats_; }
+
+private:
+    enum class Kind
+    {
+        ImportedImage,
+        ImportedBuffer,
+        TransientImage,
+    };
+
+    struct Resource
+    {
+        std::string name;
+        Kind kind = Kind::TransientImage;
+        ImageDesc desc;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags2 initialStage = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 initialAccess = VK_ACCESS_2_NONE; // Buffers only
+        VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        bool output = false;
+
+        // Transient placement, lifetime in pass indices
+        VkMemoryRequirements memory{};
+        VkDeviceSize offset = 0;
+        uint32_t firstPass = ~0U;
+        uint32_t lastPass = 0;
+    };
+
+    struct Access
+    {
+        uint32_t resource = INVALID_RESOURCE;
+        Usage usage = Usage::ColorAttachment;
+        bool read = false;
+        bool write = false;
+    };
+
+    struct Pass
+    {
+        std::string name;
+        ExecuteFn execute;
+        std::vector<Access> accesses;
+        bool live = false;
+        std::vector<VkImageMemoryBarrier2> imageBarriers;
+        std::vector<VkBufferMemoryBarrier2> bufferBarriers;
+    };
+
+    // Transient images of one frame in flight, all bound to one allocation
+    struct TransientImage
+    {
+        ImageDesc desc;
+        VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+        VkDeviceSize offset = 0;
+        VkImage image = VK_NULL_HANDLE;
+        VkImageView view = VK_NULL_HANDLE;
+    };
+
+    struct TransientBlock
+    {
+        VmaAllocation alloc = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        std::vector<TransientImage> images;
+    };
+
+    uint32_t addResource(Resource resource);
+    void access(uint32_t pass, uint32_t resource, Usage usage, bool write);
+    void cullPasses();
+    void placeTransients();
+    void buildBarriers();
+    void destroy(TransientBlock& block) const;
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VmaAllocator allocator_ = VK_NULL_HANDLE;
+
+    std::vector<Resource> resources_;
+    std::vector<Pass> passes_;
+    std::vector<VkImageMemoryBarrier2> finalBarriers_;
+    std::vector<TransientBlock> blocks_; // Per frame in flight
+    uint32_t frameIndex_ = 0;
+    Stats stats_;
+};
+} // spectra
+
+#endif //SPECTRA_RENDERGRAPH_H
@@ -4,183 +4,566 @@
 
 #include "Renderer.h"
 
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <format>
+#include <future>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
 #include <utility>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_vulkan.h>
+#include <glm/gtc/type_ptr.hpp>
 
 #define TINYGLTF_IMPLEMENTATION
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 
+#include "Gltf.h"
+#include "Trace.h"
 #include "vk/Error.h"
-#include "Utilities.h"
 
 namespace spectra {
-Renderer::Renderer(std::shared_ptr<vk::Context> pCtx, vkb::Swapchain swapchain, std::vector<VkImageView> swapchainImgViews)
-    : pCtx_(pCtx), device_(pCtx->device), vkbSwapchain_(swapchain), swapchainImageViews_(std::move(swapchainImgViews))
+namespace {
+// World-space AABB of a transformed box, projecting the extent onto each world axis (Arvo)
+void transformBounds(const glm::mat4& transform, const glm::vec3& min, const glm::vec3& max,
+                     glm::vec3& worldMin, glm::vec3& worldMax)
 {
-    frames_.resize(MAX_FRAMES_IN_FLIGHT);
+    const glm::vec3 center = glm::vec3(transform * glm::vec4((min + max) * 0.5f, 1.0f));
+    const glm::vec3 extent = (max - min) * 0.5f;
+    const glm::vec3 worldExtent = glm::abs(glm::vec3(transform[0])) * extent.x +
+                                  glm::abs(glm::vec3(transform[1])) * extent.y +
+                                  glm::abs(glm::vec3(transform[2])) * extent.z;
+    worldMin = center - worldExtent;
+    worldMax = center + worldExtent;
+}
 
-    swapchainImages_ = swapchain.get_images().value();
+// World size of a mesh unit, the largest axis scale so LOD errors are never underestimated
+float maxScale(const glm::mat4& transform)
+{
+    return std::max({ glm::length(glm::vec3(transform[0])), glm::length(glm::vec3(transform[1])),
+                      glm::length(glm::vec3(transform[2])) });
+}
 
-    // Connect with the Slang API
-    slang::createGlobalSession(slangGlobalSession_.writeRef());
+// Coarsest LOD whose error stays within the threshold once projected, mirrors shaders/cull.slang
+uint32_t selectLod(std::span<const GpuScene::Lod> lods, float pixelsPerMeshUnit, float errorThreshold)
+{
+    uint32_t lod = 0;
+    while (lod + 1 < lods.size() && lods[lod + 1].error * pixelsPerMeshUnit <= errorThreshold)
+    {
+        lod++;
+    }
+    return lod;
+}
+}
 
-    utils::vk::createTemporaryCommandPool(
-        device_, pCtx_->vkbDevice.get_queue_index(vkb::QueueType::graphics).value(), temporaryCmdPool_);
+Renderer::Renderer(std::shared_ptr<vk::Context> pCtx, std::unique_ptr<vk::Swapchain> pSwapchain,
+                   uint32_t framesInFlight)
+    : pCtx_(pCtx), device_(pCtx->device), pSwapchain_(std::move(pSwapchain)),
+      frameCount_(std::max(framesInFlight, 1U))
+{
+    extent_ = pSwapchain_->extent();
+    colorFormat_ = pSwapchain_->format();
+    targetImages_ = pSwapchain_->images();
+    targetImageViews_ = pSwapchain_->imageViews();
 
-    initVma();
-    createBuffers();
-    createGraphicsPipeline();
-    allocateCommandBuffers(device_);
-    createSyncObjects(device_);
+    init();
 }
 
-Renderer::~Renderer()
+Renderer::Renderer(std::shared_ptr<vk::Context> pCtx, VkExtent2D extent, VkFormat format, uint32_t framesInFlight)
+    : pCtx_(pCtx), device_(pCtx->device), headless_(true), extent_(extent), colorFormat_(format),
+      frameCount_(std::max(framesInFlight, 1U))
 {
-    vmaDestroyBuffer(allocator_, stagingBuffer_, stagingAlloc_);
-    vmaDestroyBuffer(allocator_, vertBuffer_, vertAlloc_);
+    init();
+}
 
-    vmaDestroyAllocator(allocator_);
+void Renderer::init()
+{
+    const auto start = std::chrono::steady_clock::now();
 
-    vkDestroyCommandPool(device_, temporaryCmdPool_, nullptr);
+    frames_.resize(frameCount_);
 
-    for (const auto& semaphore : availableSemaphores_)
+    pPipelineCompiler_ = std::make_unique<PipelineCompiler>(device_, pCtx_->pPipelineCache->handle(), shaderCompiler_,
+                                                            frameCount_);
+    if (!headless_)
     {
-        vkDestroySemaphore(device_, semaphore, VK_NULL_HANDLE);
+        // Benchmarks and captures render the shaders they started with
+        pShaderWatcher_ = std::make_unique<ShaderWatcher>("shaders");
     }
-    for (const auto& fence : inFlightFences_)
+
+    initVma();
+    pUploadManager_ = std::make_unique<UploadManager>(pCtx_, allocator_);
+    pGpuScene_ = std::make_unique<GpuScene>(device_, allocator_, *pUploadManager_, frameCount_);
+    pDepthPyramid_ = std::make_unique<DepthPyramid>(device_, allocator_, frameCount_);
+    pBindlessHeap_ = std::make_unique<BindlessHeap>(pCtx_, frameCount_);
+    createDefaultSampler();
+    pTextureStreamer_ = std::make_unique<TextureStreamer>(pCtx_, allocator_, *pUploadManager_, *pBindlessHeap_,
+                                                          frameCount_);
+    pFrameAllocator_ = std::make_unique<FrameAllocator>(
+        device_, allocator_, pCtx_->physicalDeviceProperties.limits, frameCount_);
+    if (headless_)
     {
-        vkDestroyFence(device_, fence, VK_NULL_HANDLE);
+        // One offscreen target per frame in flight, nothing waits on a presentation engine to release them
+        createOffscreenTargets(frameCount_);
     }
+    createGraphicsPipeline();
+    createGpuDrivenPipelines();
+    allocateCommandBuffers(device_);
+    createRecordPools();
+    createSyncObjects(device_);
+    pGpuProfiler_ = std::make_unique<GpuProfiler>(pCtx_, frameCount_);
+    pRenderGraph_ = std::make_unique<RenderGraph>(device_, allocator_, frameCount_);
+
+    startupTimeMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::clog << std::format("Renderer startup: {:.2f} ms\n", startupTimeMs_);
+}
 
-    for (const auto& semaphore : finishedSemaphores_)
+Renderer::~Renderer()
+{
+    pRenderGraph_.reset();
+    pTextureStreamer_.reset();
+    pGpuScene_.reset();
+    pDepthPyramid_.reset();
+    pUploadManager_.reset();
+    pFrameAllocator_.reset();
+    pGeometryPool_.reset();
+    if (materialBuffer_ != VK_NULL_HANDLE)
     {
-        vkDestroySemaphore(device_, semaphore, VK_NULL_HANDLE);
-        // swapchainImgFences_ aliases inFlightFences_ and is not owned; no need to destroy it here
+        vmaDestroyBuffer(allocator_, materialBuffer_, materialAlloc_);
     }
 
-    // TODO: Have a separate class for pipelines and handle lifecycles from there
-    vkDestroyPipeline(device_, graphicsPipeline_, nullptr);
+    for (size_t i = 0; i < offscreenAllocs_.size(); i++)
+    {
+        vkDestroyImageView(device_, targetImageViews_[i], nullptr);
+        vmaDestroyImage(allocator_, targetImages_[i], offscreenAllocs_[i]);
+    }
+
+    vmaDestroyAllocator(allocator_);
+
+    vkDestroySemaphore(device_, frameTimeline_, VK_NULL_HANDLE);
+
+    pShaderWatcher_.reset();
+    // Waits for in-flight compiles and destroys every pipeline it created
+    pPipelineCompiler_.reset();
     vkDestroyPipelineLayout(device_, graphicsPipelineLayout_, nullptr);
+    vkDestroyPipelineLayout(device_, cullPipelineLayout_, nullptr);
+    vkDestroyPipelineLayout(device_, pyramidPipelineLayout_, nullptr);
+    pBindlessHeap_.reset();
+    vkDestroySampler(device_, defaultSampler_, nullptr);
 
+    destroyRecordPools();
     for (const auto& frame : frames_)
     {
         vkDestroyCommandPool(device_, frame.cmdPool, nullptr);
+        vkDestroySemaphore(device_, frame.acquireSemaphore, nullptr);
     }
+
+    pGpuProfiler_.reset();
 }
 
-void Renderer::loadScene(const std::string& scenePath)
+bool Renderer::loadScene(const std::string& scenePath)
 {
-    tinygltf::TinyGLTF loader;
-    std::string err;
-    std::string warn;
+    SPECTRA_TRACE_SCOPE("Load scene");
+    const auto start = std::chrono::steady_clock::now();
 
-    // bool ret = loader.LoadASCIIFromFile(&model, &err, &warn, modelPath);
-    const bool ret = loader.LoadBinaryFromFile(&model_, &err, &warn, scenePath);
-
-    if (!warn.empty())
+    // Cooked packages are mapped as they are, glTF files are parsed and converted first
+    std::optional<SceneAsset> asset;
+    if (scenePath.ends_with(".spk"))
     {
-        printf("Warn: %s\n", warn.c_str());
+        SPECTRA_TRACE_SCOPE("Map package");
+        asset = SceneAsset::loadPackage(scenePath);
     }
-
-    if (!err.empty())
+    else
+    {
+        SPECTRA_TRACE_SCOPE("Parse glTF");
+        tinygltf::Model model;
+        if (gltf::loadModel(scenePath, model))
+        {
+            asset = SceneAsset::fromGltf(model);
+        }
+    }
+    if (!asset)
     {
-        printf("Err: %s\n", err.c_str());
+        return false;
     }
 
-    if (!ret)
+    if (!uploadScene(*asset))
     {
-        printf("Failed to parse glTF: %s\n", scenePath.c_str());
+        // The previous scene is gone already, draw nothing rather than instances of primitives that no longer exist
+        sceneGraph_ = {};
+        meshInstances_.clear();
+        cullObjects_.clear();
+        return false;
     }
+    buildMeshInstances(*asset);
+
+    sceneLoadTimeMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::clog << std::format("Loaded {} in {:.2f} ms\n", scenePath, sceneLoadTimeMs_);
+    return true;
 }
 
 void Renderer::render()
 {
-    if (model_.scenes.empty())
+    if (sceneGraph_.nodeCount() == 0)
     {
         return;
     }
 
-    vkWaitForFences(device_, 1, &inFlightFences_[currentFrame_], VK_TRUE, UINT64_MAX);
+    SPECTRA_TRACE_SCOPE("Render");
+
+    // Resizes and present mode changes swap in a new swapchain between frames, a minimized window draws nothing
+    if (pSwapchain_ && (swapchainOutdated_ || pSwapchain_->outdated()) && !recreateSwapchain())
+    {
+        return;
+    }
 
-    uint32_t imageIndex = 0;
-    VkResult result = vkAcquireNextImageKHR(
-        device_, vkbSwapchain_.swapchain, UINT64_MAX, availableSemaphores_[currentFrame_], VK_NULL_HANDLE, &imageIndex);
+    const uint64_t frame = frameNumber_ + 1;
+    currentFrame_ = static_cast<uint32_t>(frame % frameCount_);
+    if (frame > frameCount_)
+    {
+        SPECTRA_TRACE_SCOPE("Wait for frame slot");
+        // The slot was last used frameCount_ frames ago, everything it owns is free once that frame has finished
+        const uint64_t waitValue = frame - frameCount_;
+        const VkSemaphoreWaitInfo waitInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+            .semaphoreCount = 1,
+            .pSemaphores = &frameTimeline_,
+            .pValues = &waitValue,
+        };
+        CHECK_VK(vkWaitSemaphores(device_, &waitInfo, UINT64_MAX))
+    }
 
-    if (result == VK_ERROR_OUT_OF_DATE_KHR)
+    uint32_t imageIndex = currentFrame_;
+    if (pSwapchain_)
     {
-        // TODO: Recreate swapchain
+        SPECTRA_TRACE_SCOPE("Acquire image");
+        const VkResult result = vkAcquireNextImageKHR(device_, pSwapchain_->handle(), UINT64_MAX,
+                                                      frames_[currentFrame_].acquireSemaphore, VK_NULL_HANDLE,
+                                                      &imageIndex);
+        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            // Nothing was acquired or signaled, the next frame recreates the swapchain and takes this slot again
+            swapchainOutdated_ = true;
+            return;
+        }
+        if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+        {
+            std::cerr << "Failed to acquire swapchain image!\n";
+            CHECK_VK(result)
+        }
+
+        uint64_t finishedFrame = 0;
+        CHECK_VK(vkGetSemaphoreCounterValue(device_, frameTimeline_, &finishedFrame))
+        pSwapchain_->collectRetired(finishedFrame);
     }
-    else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+    pGpuProfiler_->collect(currentFrame_);
+
+    // The wait above guarantees the GPU is done with this frame's transient data
+    pFrameAllocator_->beginFrame(currentFrame_);
+    pGpuScene_->beginFrame(currentFrame_);
+    pBindlessHeap_->beginFrame();
+    if (pShaderWatcher_)
     {
-        std::cerr << "Failed to acquire swapchain image!\n";
-        CHECK_VK(result)
+        if (const auto changes = pShaderWatcher_->takeChanges(); !changes.empty())
+        {
+            pPipelineCompiler_->reload(changes);
+        }
     }
+    pPipelineCompiler_->beginFrame();
 
-    if (swapchainImgFences_[imageIndex] != VK_NULL_HANDLE)
     {
-        CHECK_VK(vkWaitForFences(device_, 1, &swapchainImgFences_[imageIndex], VK_TRUE, UINT64_MAX))
+        SPECTRA_TRACE_SCOPE("Update transforms");
+        // Bounds are rebuilt wholesale, moving anything is rare enough that tracking dirty objects is not worth it
+        if (sceneGraph_.update() > 0)
+        {
+            updateCullBounds();
+        }
     }
-    swapchainImgFences_[imageIndex] = inFlightFences_[currentFrame_];
 
-    CHECK_VK(vkResetFences(device_, 1, &inFlightFences_[currentFrame_]))
+    viewProjection_ = camera_.viewProjection(static_cast<float>(extent_.width) / static_cast<float>(extent_.height));
+    {
+        SPECTRA_TRACE_SCOPE("Stream textures");
+        updateTextureStreaming();
+    }
 
-    // Build ImGui frame and UI
-    ImGui_ImplGlfw_NewFrame();
-    ImGui_ImplVulkan_NewFrame();
-    ImGui::NewFrame();
+    // Texture slots change with residency, every frame reads the table as it was when it was recorded
+    const std::span<const uint32_t> textureSlots = pTextureStreamer_->slots();
+    const FrameConstants frameData {
+        .viewProjection = viewProjection_,
+        .frustumPlanes = Frustum::fromViewProjection(viewProjection_).planes,
+        .cameraPosition = glm::vec4(camera_.position, camera_.nearPlane),
+        .textureSlots = textureSlots.empty() ? 0 : pFrameAllocator_->push(textureSlots).address,
+        .materialBuffer = materialBufferHandle_,
+        .pixelsPerUnit = pixelsPerUnit(),
+        .lodErrorThreshold = lodErrorThreshold_,
+    };
+    frameDataAddress_ = pFrameAllocator_->push(frameData).address;
 
-    ImGui::Begin("Stats");
-    ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
-    ImGui::End();
+    if (!headless_)
+    {
+        SPECTRA_TRACE_SCOPE("Build ImGui frame");
+        // Build ImGui frame and UI
+        ImGui_ImplGlfw_NewFrame();
+        ImGui_ImplVulkan_NewFrame();
+        ImGui::NewFrame();
+
+        ImGui::Begin("Stats");
+        ImGui::Text("FPS: %.1f", ImGui::GetIO().Framerate);
+        ImGui::Text("Swapchain: %ux%u, %u images, %u frames in flight", extent_.width, extent_.height,
+                    pSwapchain_->imageCount(), frameCount_);
+        // Applied by recreating the swapchain at the start of the next frame
+        const VkPresentModeKHR requestedMode = pSwapchain_->requestedPresentMode();
+        ImGui::Text("Present mode:");
+        for (const VkPresentModeKHR mode : { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_MAILBOX_KHR,
+                                             VK_PRESENT_MODE_IMMEDIATE_KHR })
+        {
+            ImGui::SameLine();
+            if (ImGui::RadioButton(vk::Swapchain::presentModeName(mode), requestedMode == mode))
+            {
+                pSwapchain_->setPresentMode(mode);
+            }
+        }
+        if (pGeometryPool_)
+        {
+            ImGui::Text("Primitives: %zu, instances: %zu", primitiveDraws_.size(), meshInstances_.size());
+            ImGui::Text("Scene nodes: %u, transforms updated: %u", sceneGraph_.nodeCount(),
+                        sceneGraph_.lastUpdateCount());
+            ImGui::Text("Geometry pool (%s vertices): %.2f / %.2f MiB", vertexFormatName(vertexFormat_),
+                        pGeometryPool_->usedBytes() / (1024.0 * 1024.0),
+                        pGeometryPool_->capacityBytes() / (1024.0 * 1024.0));
+        }
+        ImGui::Checkbox("GPU-driven rendering", &gpuDrivenEnabled_);
+        ImGui::Checkbox("Frustum culling", &cullingEnabled_);
+        ImGui::SliderFloat("LOD error (px)", &lodErrorThreshold_, 0.0f, 16.0f, "%.1f");
+        if (cullingEnabled_ && !lastFrameGpuDriven_)
+        {
+            const FrustumCuller::Stats& cullStats = frustumCuller_.stats();
+            ImGui::Text("Culling (%s): %u / %u visible in %.3f ms", FrustumCuller::kernelName(frustumCuller_.kernel()),
+                        cullStats.visible, cullStats.tested, cullStats.cullMs);
+        }
+        if (lastFrameGpuDriven_)
+        {
+            ImGui::Text("GPU culling: %u objects in indirect draws, recorded in %.3f ms", pGpuScene_->objectCount(),
+                        lastRecordTimeMs_);
+            ImGui::Checkbox("Occlusion culling", &occlusionCullingEnabled_);
+            ImGui::Checkbox("Depth prepass", &depthPrepassEnabled_);
+        }
+        else
+        {
+            ImGui::Text("Draws: %zu, recorded in %.3f ms on %u thread(s)", drawList_.size(), lastRecordTimeMs_,
+                        recordThreadCount_);
+            ImGui::Checkbox("Sort and instance draws", &drawSortingEnabled_);
+            const DrawListBuilder::Stats& drawStats = drawListBuilder_.stats();
+            ImGui::Text("Draw calls: %u for %u primitives (%u saved) in %.3f ms", drawStats.drawCalls, drawStats.draws,
+                        drawStats.draws - drawStats.drawCalls, drawStats.buildMs);
+            ImGui::Text("Pipeline binds: %u (unsorted %u), material changes: %u (unsorted %u)", drawStats.pipelineBinds,
+                        drawStats.unsortedPipelineBinds, drawStats.materialBinds, drawStats.unsortedMaterialBinds);
+            ImGui::Text("Triangles: %.2f M (%.2f M at full detail)", lodStats_.triangles / 1e6,
+                        lodStats_.fullDetailTriangles / 1e6);
+        }
+        ImGui::Text("Frame allocator: %.1f / %.1f KiB (peak %.1f KiB)", pFrameAllocator_->usedBytes() / 1024.0,
+                    pFrameAllocator_->bytesPerFrame() / 1024.0, pFrameAllocator_->peakBytes() / 1024.0);
+        const BindlessHeap::Stats bindlessStats = pBindlessHeap_->stats();
+        ImGui::Text("Bindless: %u / %u images, %u / %u samplers, %u / %u buffers", bindlessStats.used[0],
+                    bindlessStats.capacity[0], bindlessStats.used[1], bindlessStats.capacity[1], bindlessStats.used[2],
+                    bindlessStats.capacity[2]);
+        const TextureStreamer::Stats textureStats = pTextureStreamer_->stats();
+        ImGui::Text("Textures (%s): %u, %.1f / %.1f MiB resident (all mips %.1f MiB), %u streaming",
+                    pTextureStreamer_->transcodeTargetName(), textureStats.textures,
+                    textureStats.residentBytes / (1024.0 * 1024.0), textureStats.budgetBytes / (1024.0 * 1024.0),
+                    textureStats.fullBytes / (1024.0 * 1024.0), textureStats.streaming);
+        ImGui::Text("Staging ring: %.2f / %.2f MiB in flight", pUploadManager_->ringBytesInFlight() / (1024.0 * 1024.0),
+                    pUploadManager_->ringSize() / (1024.0 * 1024.0));
+        const RenderGraph::Stats& graphStats = pRenderGraph_->stats();
+        ImGui::Text("Render graph: %u passes (%u culled), %u barriers in %u batches", graphStats.passes,
+                    graphStats.culledPasses, graphStats.imageBarriers + graphStats.bufferBarriers,
+                    graphStats.barrierBatches);
+        ImGui::Text("Transients: %u images, %.1f MiB in %.1f MiB of memory", graphStats.transientImages,
+                    graphStats.transientBytes / (1024.0 * 1024.0), graphStats.allocatedBytes / (1024.0 * 1024.0));
+        if (pGpuProfiler_->enabled() && ImGui::CollapsingHeader("GPU timings", ImGuiTreeNodeFlags_DefaultOpen))
+        {
+            if (ImGui::BeginTable("GpuTimings", 5, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit))
+            {
+                ImGui::TableSetupColumn("Scope");
+                ImGui::TableSetupColumn("Last ms");
+                ImGui::TableSetupColumn("Avg ms");
+                ImGui::TableSetupColumn("Min ms");
+                ImGui::TableSetupColumn("Max ms");
+                ImGui::TableHeadersRow();
+                for (const auto& scope : pGpuProfiler_->stats())
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(scope.name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", scope.lastMs);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", scope.avgMs);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", scope.minMs);
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", scope.maxMs);
+                }
+                ImGui::EndTable();
+            }
+            if (!pGpuProfiler_->isCapturing())
+            {
+                if (ImGui::Button("Capture to gpu_timings.csv"))
+                {
+                    pGpuProfiler_->startCsvCapture("gpu_timings.csv");
+                }
+            }
+            else if (ImGui::Button("Stop CSV capture"))
+            {
+                pGpuProfiler_->stopCsvCapture();
+            }
+        }
+        if (ImGui::CollapsingHeader("Pipelines"))
+        {
+            ImGui::Text("Hot reload: %s, %u reloads", pShaderWatcher_ && pShaderWatcher_->active() ? "on" : "off",
+                        pPipelineCompiler_->reloadCount());
+            ImGui::Checkbox("Vertex colors", &vertexColorsEnabled_);
+            ImGui::Text("Scene variants: %zu CPU-driven, %zu GPU-driven, %zu distinct pipelines",
+                        scenePermutations_.variantCount(), indirectPermutations_.variantCount(),
+                        pPipelineCompiler_->pipelineCount());
+            for (const auto& record : pPipelineCompiler_->records())
+            {
+                ImGui::Text("%s: %.2f ms (queued %.2f ms)%s", record.name.c_str(), record.compileMs, record.queuedMs,
+                            !record.succeeded ? " FAILED" : record.shared ? " shared" : "");
+            }
+        }
+        ImGui::End();
 
-    ImGui::Render();
+        ImGui::Render();
+    }
 
-    // Record commands for this image (includes triangle + ImGui)
-    recordCommandBuffer(frames_[imageIndex].cmdBuffer, imageIndex);
+    // Record commands for this image (includes scene + ImGui)
+    const auto recordStart = std::chrono::steady_clock::now();
+    {
+        SPECTRA_TRACE_SCOPE("Record commands");
+        recordCommandBuffer(frames_[currentFrame_].cmdBuffer, imageIndex, currentFrame_);
+    }
+    lastRecordTimeMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recordStart).count();
 
-    VkSemaphoreSubmitInfo waitSemaphoreInfo = {
-        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-        .semaphore = availableSemaphores_[currentFrame_],
-        .stageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-    };
+    std::vector<VkSemaphoreSubmitInfo> waitSemaphoreInfos;
+    // Offscreen targets are not shared with a presentation engine, the frame timeline is all the sync they need
+    if (pSwapchain_)
+    {
+        waitSemaphoreInfos.push_back({
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = frames_[currentFrame_].acquireSemaphore,
+            .stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+        });
+    }
+    if (uploadWait_)
+    {
+        waitSemaphoreInfos.push_back(*uploadWait_);
+    }
 
-    VkSemaphoreSubmitInfo signalSemaphoreInfo = {
-        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
-        .semaphore = finishedSemaphores_[imageIndex],
-        .stageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+    // The timeline value tells the CPU when this frame's slot is free again, presentation waits on the binary one
+    std::vector<VkSemaphoreSubmitInfo> signalSemaphoreInfos = {
+        {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = frameTimeline_,
+            .value = frame,
+            .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        },
     };
+    if (pSwapchain_)
+    {
+        signalSemaphoreInfos.push_back({
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+            .semaphore = pSwapchain_->presentSemaphore(imageIndex),
+            .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+        });
+    }
 
     VkCommandBufferSubmitInfo cmdSubmitInfo {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
-        .commandBuffer = frames_[imageIndex].cmdBuffer,
+        .commandBuffer = frames_[currentFrame_].cmdBuffer,
     };
 
     VkSubmitInfo2 submitInfo {
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
-        .waitSemaphoreInfoCount = 1,
-        .pWaitSemaphoreInfos = &waitSemaphoreInfo,
+        .waitSemaphoreInfoCount = static_cast<uint32_t>(waitSemaphoreInfos.size()),
+        .pWaitSemaphoreInfos = waitSemaphoreInfos.data(),
         .commandBufferInfoCount = 1,
         .pCommandBufferInfos = &cmdSubmitInfo,
-        .signalSemaphoreInfoCount = 1,
-        .pSignalSemaphoreInfos = &signalSemaphoreInfo,
+        .signalSemaphoreInfoCount = static_cast<uint32_t>(signalSemaphoreInfos.size()),
+        .pSignalSemaphoreInfos = signalSemaphoreInfos.data(),
     };
 
-    CHECK_VK(vkQueueSubmit2(pCtx_->graphicsQueue, 1, &submitInfo, inFlightFences_[currentFrame_]))
+    {
+        SPECTRA_TRACE_SCOPE("Submit");
+        pFrameAllocator_->endFrame();
+        CHECK_VK(vkQueueSubmit2(pCtx_->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE))
+        frameNumber_ = frame;
+    }
 
-    VkPresentInfoKHR presentInfo {
-        .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores = &finishedSemaphores_[imageIndex],
-        .swapchainCount = 1,
-        .pSwapchains = &vkbSwapchain_.swapchain,
-        .pImageIndices = &imageIndex,
-    };
+    if (pSwapchain_)
+    {
+        SPECTRA_TRACE_SCOPE("Present");
+        const VkSemaphore presentSemaphore = pSwapchain_->presentSemaphore(imageIndex);
+        const VkSwapchainKHR swapchain = pSwapchain_->handle();
+        const VkPresentInfoKHR presentInfo {
+            .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores = &presentSemaphore,
+            .swapchainCount = 1,
+            .pSwapchains = &swapchain,
+            .pImageIndices = &imageIndex,
+        };
+
+        // Suboptimal images are still presented, a size change is caught by the check at the start of the frame
+        const VkResult result = vkQueuePresentKHR(pCtx_->presentQueue, &presentInfo);
+        if (result == VK_ERROR_OUT_OF_DATE_KHR)
+        {
+            swapchainOutdated_ = true;
+        }
+        else if (result != VK_SUBOPTIMAL_KHR)
+        {
+            CHECK_VK(result)
+        }
+    }
+}
 
-    CHECK_VK(vkQueuePresentKHR(pCtx_->presentQueue, &presentInfo))
+void Renderer::setPresentMode(VkPresentModeKHR presentMode)
+{
+    if (pSwapchain_)
+    {
+        pSwapchain_->setPresentMode(presentMode);
+    }
+}
 
-    currentFrame_ = (currentFrame_ + 1) % MAX_FRAMES_IN_FLIGHT;
+VkPresentModeKHR Renderer::presentMode() const
+{
+    return pSwapchain_ ? pSwapchain_->presentMode() : VK_PRESENT_MODE_MAX_ENUM_KHR;
+}
+
+bool Renderer::recreateSwapchain()
+{
+    SPECTRA_TRACE_SCOPE("Recreate swapchain");
+    // Frames in flight keep presenting to the old swapchain, it is destroyed once the last of them has finished
+    if (!pSwapchain_->recreate(frameNumber_))
+    {
+        return false;
+    }
+    swapchainOutdated_ = false;
+
+    // The surface format does not depend on the size, so the pipelines stay valid
+    extent_ = pSwapchain_->extent();
+    targetImages_ = pSwapchain_->images();
+    targetImageViews_ = pSwapchain_->imageViews();
+    updateViewport();
+    return true;
+}
+
+std::optional<double> Renderer::consumeGpuFrameTimeMs()
+{
+    return pGpuProfiler_->consumeFrameTimeMs();
 }
 
 void Renderer::initVma()
@@ -204,218 +587,548 @@ void Renderer::initVma()
     CHECK_VK(vmaCreateAllocator(&allocatorCreateInfo, &allocator_));
 }
 
-void Renderer::createBuffers()
+void Renderer::createOffscreenTargets(uint32_t count)
 {
-    const std::vector<Vertex> vertices
+    targetImages_.resize(count);
+    targetImageViews_.resize(count);
+    offscreenAllocs_.resize(count);
+
+    for (uint32_t i = 0; i < count; i++)
     {
-        { glm::vec2( 0.0f, -0.5f), glm::vec3(1.0f, 0.0f, 0.0f) },
-        { glm::vec2( 0.5f,  0.5f), glm::vec3(0.0f, 1.0f, 0.0f) },
-        { glm::vec2(-0.5f,  0.5f), glm::vec3(0.0f, 0.0f, 1.0f) },
-    };
+        VkImageCreateInfo imageCreateInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = colorFormat_,
+            .extent = { extent_.width, extent_.height, 1 },
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            // Transfer source so frames can be read back for image comparisons
+            .usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        };
+        VmaAllocationCreateInfo allocCreateInfo
+        {
+            .flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT,
+            .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+        };
+        CHECK_VK(vmaCreateImage(allocator_, &imageCreateInfo, &allocCreateInfo, &targetImages_[i], &offscreenAllocs_[i], nullptr));
+
+        VkImageViewCreateInfo viewCreateInfo
+        {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+            .image = targetImages_[i],
+            .viewType = VK_IMAGE_VIEW_TYPE_2D,
+            .format = colorFormat_,
+            .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 },
+        };
+        CHECK_VK(vkCreateImageView(device_, &viewCreateInfo, nullptr, &targetImageViews_[i]));
+    }
+}
+
+bool Renderer::uploadScene(const SceneAsset& asset)
+{
+    SPECTRA_TRACE_SCOPE("Upload scene");
 
-    const VkDeviceSize vertBufSize = vertices.size() * sizeof(Vertex);
-    VkBufferCreateInfo vertBufferCreateInfo
+    // Reloading replaces the previous scene, its ranges may still be referenced by frames in flight
+    if (pGeometryPool_)
     {
-        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .size = vertBufSize,
-        .usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-    };
-    VmaAllocationCreateInfo vertAllocCreateInfo
+        vkDeviceWaitIdle(device_);
+        for (const auto& draw : primitiveDraws_)
+        {
+            pGeometryPool_->free(draw.geometry);
+        }
+        // Objects reference the old ranges, the GPU-driven path waits for the new scene's objects
+        pGpuScene_->setObjects({}, {});
+        pTextureStreamer_->clear();
+    }
+    primitiveDraws_.clear();
+    drawLods_.clear();
+    meshPrimitives_.clear();
+    for (const SceneAsset::Mesh& mesh : asset.meshes())
     {
-        .flags = 0,
-        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE
-    };
-    CHECK_VK(vmaCreateBuffer(allocator_, &vertBufferCreateInfo, &vertAllocCreateInfo, &vertBuffer_, &vertAlloc_, nullptr));
+        meshPrimitives_.push_back({ mesh.firstPrimitive, mesh.primitiveCount });
+    }
+
+    const std::span<const SceneAsset::Primitive> primitives = asset.primitives();
+    const uint64_t totalVertices = asset.vertices().size();
+    const uint64_t totalIndices = asset.indices().size();
+    const uint32_t stride = vertexSize(vertexFormat_);
+    sceneVertexBytes_ = totalVertices * stride;
+    sceneIndexBytes_ = totalIndices * sizeof(uint32_t);
 
-    VkBufferCreateInfo stagingBufferCreateInfo
+    if (primitives.empty())
+    {
+        return true;
+    }
+
+    // Pool offsets are 32-bit
+    constexpr uint64_t MAX_POOL_ELEMENTS = std::numeric_limits<uint32_t>::max();
+    if (totalVertices > MAX_POOL_ELEMENTS || totalIndices > MAX_POOL_ELEMENTS)
+    {
+        std::cerr << std::format("Scene does not fit the geometry pool: {} vertices, {} indices\n", totalVertices,
+                                 totalIndices);
+        return false;
+    }
+    // Sorted draws carry their LOD and material in the draw key, wider indices would merge unrelated draws. Material
+    // 0 is the default one, glTF materials follow it.
+    const uint64_t totalLods = std::accumulate(primitives.begin(), primitives.end(), uint64_t{ 0 },
+                                               [](uint64_t sum, const SceneAsset::Primitive& primitive)
+                                               {
+                                                   return sum + primitive.lodCount;
+                                               });
+    if (totalLods > (uint64_t{ 1 } << DrawListBuilder::MESH_BITS) ||
+        asset.materials().size() + 1 > (uint64_t{ 1 } << DrawListBuilder::MATERIAL_BITS))
+    {
+        std::cerr << std::format("Scene exceeds the draw key: {} LODs, {} materials\n", totalLods,
+                                 asset.materials().size());
+        return false;
+    }
+
+    // Vertices and indices live in separate ranges, either one running short needs a new pool. Size it with headroom
+    // so streaming in more meshes later does not immediately require a new buffer.
+    if (!pGeometryPool_ || pGeometryPool_->vertexStride() != stride || pGeometryPool_->freeVertices() < totalVertices ||
+        pGeometryPool_->freeIndices() < totalIndices)
+    {
+        const auto poolCapacity = [](uint64_t count, uint64_t minimum)
+        {
+            return static_cast<uint32_t>(std::min(std::bit_ceil(std::max(count, minimum)), MAX_POOL_ELEMENTS));
+        };
+        pGeometryPool_.reset();
+        pGeometryPool_ = std::make_unique<GeometryPool>(allocator_, stride, poolCapacity(totalVertices, 1 << 16),
+                                                        poolCapacity(totalIndices, 1 << 18));
+    }
+
+    // Copies go through the staging ring on the transfer queue, frames keep rendering until they land. Float
+    // vertices are uploaded straight from the asset, for a package that is the mapped file.
+    std::vector<QuantizedVertex> quantized;
+    for (const SceneAsset::Primitive& primitive : primitives)
+    {
+        const auto allocation = pGeometryPool_->allocate(primitive.vertexCount, primitive.indexCount);
+        if (!allocation)
+        {
+            // Only queued copies reference the ranges taken so far, they land before the next upload reuses them
+            std::cerr << std::format("Geometry pool is out of space after {} of {} primitives\n",
+                                     primitiveDraws_.size(), primitives.size());
+            for (const auto& draw : primitiveDraws_)
+            {
+                pGeometryPool_->free(draw.geometry);
+            }
+            primitiveDraws_.clear();
+            drawLods_.clear();
+            meshPrimitives_.clear();
+            return false;
+        }
+
+        const std::span<const Vertex> vertices = asset.vertices().subspan(primitive.firstVertex, primitive.vertexCount);
+        PrimitiveDraw draw { *allocation, static_cast<uint32_t>(drawLods_.size()), primitive.lodCount,
+                             primitive.material, primitive.boundsMin, primitive.boundsMax };
+        for (const SceneAsset::Lod& lod : asset.lods().subspan(primitive.firstLod, primitive.lodCount))
+        {
+            drawLods_.push_back({
+                .firstIndex = static_cast<uint32_t>(allocation->indices.offset) + lod.firstIndex,
+                .indexCount = lod.indexCount,
+                .error = lod.error,
+            });
+        }
+        const void* pVertexData = vertices.data();
+        if (vertexFormat_ == VertexFormat::Quantized)
+        {
+            quantized.resize(vertices.size());
+            quantizeVertices(vertices, primitive.boundsMin, primitive.boundsMax, quantized);
+            draw.dequantize = dequantizeMatrix(primitive.boundsMin, primitive.boundsMax);
+            pVertexData = quantized.data();
+        }
+
+        pUploadManager_->uploadBuffer(pGeometryPool_->vertexBuffer(), allocation->vertices.offset * stride,
+                                      pVertexData, static_cast<VkDeviceSize>(primitive.vertexCount) * stride);
+        pUploadManager_->uploadBuffer(pGeometryPool_->indexBuffer(), allocation->indices.offset * sizeof(uint32_t),
+                                      asset.indices().data() + primitive.firstIndex,
+                                      primitive.indexCount * sizeof(uint32_t));
+        primitiveDraws_.push_back(draw);
+    }
+    uploadMaterials(asset);
+    sceneUploadValue_ = pUploadManager_->flush();
+
+    std::clog << std::format("Uploaded {} primitives ({} {} vertices, {} indices, {:.2f} MiB) into the geometry pool\n",
+                             primitiveDraws_.size(), totalVertices, vertexFormatName(vertexFormat_), totalIndices,
+                             (sceneVertexBytes_ + sceneIndexBytes_) / (1024.0 * 1024.0));
+    return true;
+}
+
+void Renderer::uploadMaterials(const SceneAsset& asset)
+{
+    // A reload has already waited for the device, the old buffer is unused. Its slot is recycled after the frames in flight.
+    if (materialBuffer_ != VK_NULL_HANDLE)
+    {
+        pBindlessHeap_->release(BindlessHeap::Kind::StorageBuffer, materialBufferHandle_);
+        vmaDestroyBuffer(allocator_, materialBuffer_, materialAlloc_);
+    }
+
+    // The streamer keeps its own copy of the levels, the encoded images are not needed after this
+    std::vector<uint32_t> imageTextures(asset.imageCount());
+    for (uint32_t i = 0; i < asset.imageCount(); i++)
+    {
+        imageTextures[i] = pTextureStreamer_->addImage(asset.image(i));
+    }
+
+    std::vector<GpuMaterial> materials(asset.materials().size() + 1);
+    materialTextures_.assign(materials.size(), TextureStreamer::INVALID_TEXTURE);
+    for (size_t i = 0; i < asset.materials().size(); i++)
+    {
+        const SceneAsset::Material& source = asset.materials()[i];
+        GpuMaterial& material = materials[i + 1];
+        material.baseColorFactor = source.baseColorFactor;
+        if (source.baseColorImage != SceneAsset::NO_IMAGE)
+        {
+            material.baseColorTexture = imageTextures[source.baseColorImage];
+        }
+        material.baseColorSampler = defaultSamplerHandle_;
+        materialTextures_[i + 1] = material.baseColorTexture;
+    }
+
+    const TextureStreamer::Stats textureStats = pTextureStreamer_->stats();
+    std::clog << std::format("Loaded {} textures, {:.1f} MiB with every mip level\n", textureStats.textures,
+                             textureStats.fullBytes / (1024.0 * 1024.0));
+
+    VkBufferCreateInfo bufferCreateInfo
     {
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .size = vertBufSize,
-        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+        .size = materials.size() * sizeof(GpuMaterial),
+        .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
     };
-    VmaAllocationCreateInfo stagingAllocCreateInfo
+    VmaAllocationCreateInfo allocCreateInfo
     {
-        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
-        .usage = VMA_MEMORY_USAGE_AUTO,
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
     };
-    CHECK_VK(vmaCreateBuffer(allocator_, &stagingBufferCreateInfo, &stagingAllocCreateInfo, &stagingBuffer_, &stagingAlloc_, nullptr));
+    CHECK_VK(vmaCreateBuffer(allocator_, &bufferCreateInfo, &allocCreateInfo, &materialBuffer_, &materialAlloc_, nullptr));
 
-    void* mapped = nullptr;
-    CHECK_VK(vmaMapMemory(allocator_, stagingAlloc_, &mapped));
-    memcpy(mapped, vertices.data(), vertBufSize);
-    vmaUnmapMemory(allocator_, stagingAlloc_);
+    // Frames reach the buffer through its bindless slot, it becomes visible together with the scene geometry
+    pUploadManager_->uploadBuffer(materialBuffer_, 0, materials.data(), materials.size() * sizeof(GpuMaterial));
+    materialBufferHandle_ = pBindlessHeap_->registerStorageBuffer(materialBuffer_);
+}
 
-    CHECK_VK(vmaFlushAllocation(allocator_, stagingAlloc_, 0, vertBufSize));
+void Renderer::updateTextureStreaming()
+{
+    // On-screen sizes change slowly, every few frames the textured objects in view report the size they cover
+    if (framesUntilTextureRequests_ > 0)
+    {
+        framesUntilTextureRequests_--;
+    }
+    else if (!materialTextures_.empty())
+    {
+        framesUntilTextureRequests_ = TEXTURE_REQUEST_INTERVAL - 1;
+
+        const Frustum frustum = Frustum::fromViewProjection(viewProjection_);
+        const float pixelsPerUnit = this->pixelsPerUnit();
+        for (const GpuScene::Object& object : gpuObjects_)
+        {
+            const uint32_t texture = materialTextures_[object.material];
+            if (texture == TextureStreamer::INVALID_TEXTURE)
+            {
+                continue;
+            }
+
+            // Bounding sphere of the box, a coarse test is enough to keep off-screen objects from asking for detail
+            const glm::vec3 center(object.boundsCenter);
+            const float radius = glm::length(glm::vec3(object.boundsExtent));
+            const bool visible = std::ranges::all_of(frustum.planes, [&](const glm::vec4& plane)
+            {
+                return glm::dot(glm::vec3(plane), center) + plane.w >= -radius;
+            });
+            if (visible)
+            {
+                const float distance = std::max(glm::length(center - camera_.position) - radius, camera_.nearPlane);
+                pTextureStreamer_->request(texture, 2.0f * radius * pixelsPerUnit / distance);
+            }
+        }
+        pTextureStreamer_->commitRequests();
+    }
 
-    // Copy vertices to device on initialization
-    VkCommandBuffer cmd{};
-    utils::vk::beginOneTimeCommands(cmd, device_, temporaryCmdPool_);
+    pTextureStreamer_->update();
+}
 
-    const VkBufferCopy copyRegion
+void Renderer::createDefaultSampler()
+{
+    const VkSamplerCreateInfo samplerCreateInfo
     {
-        .srcOffset = 0,
-        .dstOffset = 0,
-        .size = vertBufSize
+        .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .magFilter = VK_FILTER_LINEAR,
+        .minFilter = VK_FILTER_LINEAR,
+        .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+        .addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+        .maxLod = VK_LOD_CLAMP_NONE,
     };
-    vkCmdCopyBuffer(cmd, stagingBuffer_, vertBuffer_, 1, &copyRegion);
+    CHECK_VK(vkCreateSampler(device_, &samplerCreateInfo, nullptr, &defaultSampler_));
+    defaultSamplerHandle_ = pBindlessHeap_->registerSampler(defaultSampler_);
+}
+
+void Renderer::buildMeshInstances(const SceneAsset& asset)
+{
+    sceneGraph_ = SceneGraph::fromNodes(asset.nodes());
+    sceneGraph_.update();
+    collectMeshInstances();
+
+    // Frame the scene using the primitive bounds
+    glm::vec3 sceneMin(std::numeric_limits<float>::max());
+    glm::vec3 sceneMax(std::numeric_limits<float>::lowest());
+    for (const auto& object : cullObjects_)
+    {
+        const PrimitiveDraw& draw = primitiveDraws_[object.draw];
+        glm::vec3 worldMin;
+        glm::vec3 worldMax;
+        transformBounds(sceneGraph_.worldMatrix(meshInstances_[object.instance].node), draw.boundsMin, draw.boundsMax,
+                        worldMin, worldMax);
+        sceneMin = glm::min(sceneMin, worldMin);
+        sceneMax = glm::max(sceneMax, worldMax);
+    }
 
-    utils::vk::endOneTimeCommands(cmd, device_, temporaryCmdPool_, pCtx_->graphicsQueue);
+    sceneMin_ = sceneMin;
+    sceneMax_ = sceneMax;
+    fitCamera(sceneMin_, sceneMax_);
 }
 
-void Renderer::createGraphicsPipeline()
+void Renderer::collectMeshInstances()
 {
-    Slang::ComPtr<slang::ISession> slangSession = setupSlangSession(slangGlobalSession_);
-    Slang::ComPtr<slang::IModule> slangModule = nullptr;
-    slangModule = slangSession->loadModuleFromSource("triangle", "shaders/triangle.slang", nullptr, nullptr);
-    Slang::ComPtr<ISlangBlob> spirv;
-    slangModule->getTargetCode(0, spirv.writeRef());
+    meshInstances_.clear();
+    cullObjects_.clear();
+    for (uint32_t node = 0; node < sceneGraph_.nodeCount(); node++)
+    {
+        const int32_t mesh = sceneGraph_.mesh(node);
+        if (mesh == SceneGraph::NO_MESH || mesh >= static_cast<int32_t>(meshPrimitives_.size()))
+        {
+            continue;
+        }
 
-    VkShaderModuleCreateInfo shaderModuleInfo {
-        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .codeSize = spirv->getBufferSize(),
-        .pCode = static_cast<const uint32_t*>(spirv->getBufferPointer()),
-    };
+        const auto instance = static_cast<uint32_t>(meshInstances_.size());
+        meshInstances_.push_back({ static_cast<uint32_t>(mesh), node });
 
-    VkShaderModule shaderModule;
-    CHECK_VK(vkCreateShaderModule(device_, &shaderModuleInfo, nullptr, &shaderModule));
+        const MeshPrimitives& primitives = meshPrimitives_[mesh];
+        for (uint32_t i = 0; i < primitives.drawCount; i++)
+        {
+            cullObjects_.push_back({ instance, primitives.firstDraw + i });
+        }
+    }
 
-    VkPipelineShaderStageCreateInfo vertStageInfo = {};
-    vertStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    vertStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-    vertStageInfo.module = shaderModule,
-    vertStageInfo.pName = "vertexMain";
+    frustumCuller_.resize(static_cast<uint32_t>(cullObjects_.size()));
+    updateCullBounds();
+}
 
-    VkPipelineShaderStageCreateInfo fragStageInfo = {};
-    fragStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    fragStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-    fragStageInfo.module = shaderModule,
-    fragStageInfo.pName = "fragmentMain";
+void Renderer::updateCullBounds()
+{
+    gpuObjects_.resize(cullObjects_.size());
+    for (uint32_t i = 0; i < cullObjects_.size(); i++)
+    {
+        const CullObject& object = cullObjects_[i];
+        const PrimitiveDraw& draw = primitiveDraws_[object.draw];
+        const glm::mat4& world = sceneGraph_.worldMatrix(meshInstances_[object.instance].node);
+        glm::vec3 worldMin;
+        glm::vec3 worldMax;
+        transformBounds(world, draw.boundsMin, draw.boundsMax, worldMin, worldMax);
+        frustumCuller_.setBounds(i, worldMin, worldMax);
+
+        gpuObjects_[i] = {
+            .world = world * draw.dequantize,
+            .boundsCenter = glm::vec4((worldMin + worldMax) * 0.5f, maxScale(world)),
+            .boundsExtent = glm::vec4((worldMax - worldMin) * 0.5f, 0.0f),
+            .firstLod = draw.firstLod,
+            .lodCount = draw.lodCount,
+            .vertexOffset = static_cast<int32_t>(draw.geometry.vertices.offset),
+            .material = draw.material,
+        };
+    }
 
-    VkPipelineShaderStageCreateInfo shaderStages[] = { vertStageInfo, fragStageInfo };
+    // The GPU keeps drawing the previous set until this one has uploaded
+    pGpuScene_->setObjects(gpuObjects_, drawLods_);
+}
 
-    VkVertexInputBindingDescription vertexBinding{};
-    vertexBinding.binding = 0;
-    vertexBinding.stride = sizeof(Vertex);
-    vertexBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+void Renderer::fitCamera(const glm::vec3& sceneMin, const glm::vec3& sceneMax)
+{
+    if (sceneMin.x <= sceneMax.x)
+    {
+        const glm::vec3 center = (sceneMin + sceneMax) * 0.5f;
+        const float radius = std::max(glm::length(sceneMax - sceneMin) * 0.5f, 0.01f);
+        camera_.target = center;
+        camera_.position = center + glm::normalize(glm::vec3(1.0f, 0.8f, 1.5f)) * radius * 2.5f;
+        camera_.nearPlane = radius * 0.01f;
+        camera_.farPlane = radius * 10.0f;
+    }
+}
 
-    std::vector<VkVertexInputAttributeDescription> vertexAttributes = {
-        {
-            .location = 0,
-            .binding = vertexBinding.binding,
-            .format = VK_FORMAT_R32G32_SFLOAT,
-            .offset = 0
-        },
-        {
-            .location = 1,
-            .binding = vertexBinding.binding,
-            .format = VK_FORMAT_R32G32B32_SFLOAT,
-            .offset = sizeof(Vertex::position)
-        }
-    };
+float Renderer::pixelsPerUnit() const
+{
+    return viewport_.height / (2.0f * std::tan(camera_.fovY * 0.5f));
+}
+
+void Renderer::setVertexFormat(VertexFormat format)
+{
+    if (format != vertexFormat_)
+    {
+        // The compiler keeps the previous pipelines alive, frames in flight may still be using them
+        vertexFormat_ = format;
+        createScenePipelines();
+    }
+}
+
+void Renderer::replicateScene(uint32_t copies)
+{
+    if (copies <= 1 || meshInstances_.empty() || sceneMin_.x > sceneMax_.x)
+    {
+        return;
+    }
+
+    // Copies are laid out on a cube grid with a gap of a fifth of the scene size between them. Each copy is a new
+    // root in the scene graph holding the original nodes.
+    const uint32_t originalNodes = sceneGraph_.nodeCount();
+    const glm::vec3 spacing = (sceneMax_ - sceneMin_) * 1.2f + glm::vec3(0.01f);
+    const auto gridSize = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(copies))));
 
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 1;
-    vertexInputInfo.pVertexBindingDescriptions = &vertexBinding;
-    vertexInputInfo.vertexAttributeDescriptionCount = vertexAttributes.size();
-    vertexInputInfo.pVertexAttributeDescriptions = vertexAttributes.data();
+    glm::vec3 gridMax = sceneMax_;
+    for (uint32_t copy = 1; copy < copies; copy++)
+    {
+        const glm::vec3 cell(copy % gridSize, (copy / gridSize) % gridSize, copy / (gridSize * gridSize));
+        const glm::vec3 offset = cell * spacing;
+        sceneGraph_.appendCopy(originalNodes, { .translation = offset });
+        gridMax = glm::max(gridMax, sceneMax_ + offset);
+    }
+    sceneGraph_.update();
+    collectMeshInstances();
+    fitCamera(sceneMin_, gridMax);
 
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
+    std::clog << std::format("Replicated the scene {} times, {} instances\n", copies, meshInstances_.size());
+}
 
+void Renderer::updateViewport()
+{
     viewport_.x = 0.0f;
     viewport_.y = 0.0f;
-    viewport_.width = (float)vkbSwapchain_.extent.width;
-    viewport_.height = (float)vkbSwapchain_.extent.height;
+    viewport_.width = (float)extent_.width;
+    viewport_.height = (float)extent_.height;
     viewport_.minDepth = 0.0f;
     viewport_.maxDepth = 1.0f;
 
     scissor_.offset = { 0, 0 };
-    scissor_.extent = vkbSwapchain_.extent;
-
-    VkPipelineViewportStateCreateInfo viewportState = {};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport_;
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor_;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer = {};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.depthClampEnable = VK_FALSE;
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-    rasterizer.depthBiasEnable = VK_FALSE;
-
-    VkPipelineMultisampleStateCreateInfo multisampling = {};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-
-    VkPipelineColorBlendAttachmentState colorBlendAttachment = {};
-    colorBlendAttachment.colorWriteMask =
-        VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
-
-    VkPipelineColorBlendStateCreateInfo colorBlendState = {};
-    colorBlendState.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlendState.logicOpEnable = VK_FALSE;
-    colorBlendState.logicOp = VK_LOGIC_OP_COPY;
-    colorBlendState.attachmentCount = 1;
-    colorBlendState.pAttachments = &colorBlendAttachment;
-    colorBlendState.blendConstants[0] = 0.0f;
-    colorBlendState.blendConstants[1] = 0.0f;
-    colorBlendState.blendConstants[2] = 0.0f;
-    colorBlendState.blendConstants[3] = 0.0f;
+    scissor_.extent = extent_;
+}
+
+void Renderer::createGraphicsPipeline()
+{
+    updateViewport();
+
+    const VkPushConstantRange pushConstantRange {
+        .stageFlags = DRAW_CONSTANT_STAGES,
+        .offset = 0,
+        .size = sizeof(DrawConstants),
+    };
+
+    // The bindless set is the only descriptor set, bound once per command buffer
+    const VkDescriptorSetLayout setLayout = pBindlessHeap_->setLayout();
 
     VkPipelineLayoutCreateInfo layoutCreateInfo = {};
     layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    layoutCreateInfo.setLayoutCount = 0;
-    layoutCreateInfo.pushConstantRangeCount = 0;
+    layoutCreateInfo.setLayoutCount = 1;
+    layoutCreateInfo.pSetLayouts = &setLayout;
+    layoutCreateInfo.pushConstantRangeCount = 1;
+    layoutCreateInfo.pPushConstantRanges = &pushConstantRange;
 
     // TODO: Name vulkan objects to identify them in validation messages
     CHECK_VK(vkCreatePipelineLayout(device_, &layoutCreateInfo, nullptr, &graphicsPipelineLayout_));
 
-    std::vector<VkDynamicState> dynamicStates = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
-
-    VkPipelineDynamicStateCreateInfo dynamicState = {};
-    dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
-    dynamicState.pDynamicStates = dynamicStates.data();
-
-    VkPipelineRenderingCreateInfo pipelineRenderingInfo = {};
-    pipelineRenderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
-    pipelineRenderingInfo.pNext = VK_NULL_HANDLE;
-    pipelineRenderingInfo.colorAttachmentCount = 1;
-    pipelineRenderingInfo.pColorAttachmentFormats = &vkbSwapchain_.image_format;
-    pipelineRenderingInfo.depthAttachmentFormat   = VK_FORMAT_UNDEFINED;
-    pipelineRenderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
-
-    VkGraphicsPipelineCreateInfo pipelineInfo = {};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = 2;
-    pipelineInfo.pStages = shaderStages;
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pColorBlendState = &colorBlendState;
-    pipelineInfo.pDynamicState = &dynamicState;
-    pipelineInfo.layout = graphicsPipelineLayout_;
-    pipelineInfo.renderPass = VK_NULL_HANDLE;
-    pipelineInfo.subpass = 0;
-    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
-    pipelineInfo.pNext = &pipelineRenderingInfo;
-
-    CHECK_VK(vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &pipelineInfo, VK_NULL_HANDLE, &graphicsPipeline_));
-
-    vkDestroyShaderModule(device_, shaderModule, nullptr);
+    createScenePipelines();
+}
+
+void Renderer::createScenePipelines()
+{
+    // Both scene pipelines read the geometry pool, so they share its vertex layout
+    const VertexInputLayout vertexInput = vertexInputLayout(vertexFormat_);
+
+    GraphicsPipelineDesc desc {
+        .name = "triangle",
+        .shaderModule = "triangle",
+        .shaderPath = "shaders/triangle.slang",
+        .vertexBindings = vertexInput.bindings,
+        .vertexAttributes = vertexInput.attributes,
+        .layout = graphicsPipelineLayout_,
+        .colorFormat = colorFormat_,
+        .depthFormat = DEPTH_FORMAT,
+        .cullMode = VK_CULL_MODE_BACK_BIT,
+        .frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE, // glTF winding, preserved by the Y-flipped projection
+    };
+    // Bit i of a feature mask sets feature i
+    const std::vector<PipelinePermutations::Feature> features = {
+        { .name = "TEXTURED" },
+        { .name = "VERTEX_COLOR", .constantId = 0 },
+    };
+
+    // Same vertex format and layout as the CPU-driven pipeline, only the transform comes from the object buffer.
+    // Depth writes are off when shading after the depth prepass.
+    GraphicsPipelineDesc indirectDesc = desc;
+    indirectDesc.name = "indirect";
+    indirectDesc.shaderModule = "indirect";
+    indirectDesc.shaderPath = "shaders/indirect.slang";
+    indirectDesc.dynamicDepthWrite = true;
+
+    // The features only change shading, the depth prepass runs the vertex stage alone
+    GraphicsPipelineDesc prepassDesc = indirectDesc;
+    prepassDesc.name = "indirect_depth";
+    prepassDesc.fragmentEntry.clear();
+    prepassDesc.colorFormat = VK_FORMAT_UNDEFINED;
+    prepassDesc.linkConstants = { { .name = "TEXTURED", .value = 1 } };
+    depthPrepassPipeline_ = pPipelineCompiler_->compileGraphics(std::move(prepassDesc));
+
+    scenePermutations_ = PipelinePermutations(*pPipelineCompiler_, std::move(desc), features);
+    indirectPermutations_ = PipelinePermutations(*pPipelineCompiler_, std::move(indirectDesc), features);
+
+    // Compiled in the background, frames render without the scene until the variants that stand in for the others
+    // are ready. The rest are compiled when a frame first needs them.
+    scenePermutations_.request(SCENE_ALL_FEATURES);
+    indirectPermutations_.request(SCENE_ALL_FEATURES);
+}
+
+void Renderer::createGpuDrivenPipelines()
+{
+    const VkPushConstantRange pushConstantRange {
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .offset = 0,
+        .size = sizeof(GpuScene::CullConstants),
+    };
+
+    // Compatible with the graphics layout for set 0, the scene shaders share their bindless declarations
+    const VkDescriptorSetLayout setLayout = pBindlessHeap_->setLayout();
+
+    VkPipelineLayoutCreateInfo layoutCreateInfo = {};
+    layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutCreateInfo.setLayoutCount = 1;
+    layoutCreateInfo.pSetLayouts = &setLayout;
+    layoutCreateInfo.pushConstantRangeCount = 1;
+    layoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+    CHECK_VK(vkCreatePipelineLayout(device_, &layoutCreateInfo, nullptr, &cullPipelineLayout_));
+
+    cullPipeline_ = pPipelineCompiler_->compileCompute({
+        .name = "cull",
+        .shaderModule = "cull",
+        .shaderPath = "shaders/cull.slang",
+        .layout = cullPipelineLayout_,
+    });
+
+    const VkPushConstantRange pyramidPushConstantRange {
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .offset = 0,
+        .size = sizeof(DepthPyramid::BuildConstants),
+    };
+    layoutCreateInfo.pPushConstantRanges = &pyramidPushConstantRange;
+    CHECK_VK(vkCreatePipelineLayout(device_, &layoutCreateInfo, nullptr, &pyramidPipelineLayout_));
+
+    pyramidPipeline_ = pPipelineCompiler_->compileCompute({
+        .name = "depth_pyramid",
+        .shaderModule = "depth_pyramid",
+        .shaderPath = "shaders/depth_pyramid.slang",
+        .layout = pyramidPipelineLayout_,
+    });
 }
 
 void Renderer::createCommandPool(VkCommandPool& commandPool)
@@ -430,7 +1143,7 @@ void Renderer::createCommandPool(VkCommandPool& commandPool)
 
 void Renderer::allocateCommandBuffers(VkDevice device)
 {
-    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    for (uint32_t i = 0; i < frameCount_; i++)
     {
         createCommandPool(frames_[i].cmdPool);
 
@@ -446,31 +1159,29 @@ void Renderer::allocateCommandBuffers(VkDevice device)
 
 void Renderer::createSyncObjects(VkDevice device)
 {
-    availableSemaphores_.resize(MAX_FRAMES_IN_FLIGHT);
-    finishedSemaphores_.resize(vkbSwapchain_.image_count);
-    inFlightFences_.resize(MAX_FRAMES_IN_FLIGHT);
-    swapchainImgFences_.assign(vkbSwapchain_.image_count, VK_NULL_HANDLE);
-
+    VkSemaphoreTypeCreateInfo timelineCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0,
+    };
     VkSemaphoreCreateInfo semaphoreCreateInfo = {};
     semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreCreateInfo.pNext = &timelineCreateInfo;
+    CHECK_VK(vkCreateSemaphore(device, &semaphoreCreateInfo, VK_NULL_HANDLE, &frameTimeline_))
 
-    VkFenceCreateInfo fenceCreateInfo = {};
-    fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-    fenceCreateInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-    for (uint32_t i = 0; i < vkbSwapchain_.image_count; i++)
-    {
-        CHECK_VK(vkCreateSemaphore(device, &semaphoreCreateInfo, VK_NULL_HANDLE, &finishedSemaphores_[i]))
-    }
-
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    // Acquisition signals binary semaphores only, one per frame slot. A slot's semaphore was waited on by the frame
+    // that last used the slot, which has finished before the slot is reused.
+    if (pSwapchain_)
     {
-        CHECK_VK(vkCreateSemaphore(device, &semaphoreCreateInfo, VK_NULL_HANDLE, &availableSemaphores_[i]))
-        CHECK_VK(vkCreateFence(device, &fenceCreateInfo, VK_NULL_HANDLE, &inFlightFences_[i]))
+        semaphoreCreateInfo.pNext = nullptr;
+        for (FrameData& frame : frames_)
+        {
+            CHECK_VK(vkCreateSemaphore(device, &semaphoreCreateInfo, VK_NULL_HANDLE, &frame.acquireSemaphore))
+        }
     }
 }
 
-void Renderer::recordCommandBuffer(VkCommandBuffer cb, const uint32_t imgIndex) const
+void Renderer::recordCommandBuffer(VkCommandBuffer cb, const uint32_t imgIndex, const uint32_t frameIndex)
 {
     CHECK_VK(vkResetCommandBuffer(cb, 0))
 
@@ -481,15 +1192,274 @@ void Renderer::recordCommandBuffer(VkCommandBuffer cb, const uint32_t imgIndex)
 
     CHECK_VK(vkBeginCommandBuffer(cb, &beginInfo))
 
-    VkClearValue clearColor{ { { 0.0f, 0.0f, 0.0f, 1.0f } } };
+    pGpuProfiler_->beginFrame(cb, frameIndex);
+
+    vkCmdSetViewport(cb, 0, 1, &viewport_);
+    vkCmdSetScissor(cb, 0, 1, &scissor_);
+
+    {
+        GpuProfiler::Scope scope(*pGpuProfiler_, cb, "Upload acquires");
+        // Take ownership of finished uploads before anything reads them
+        uploadWait_ = pUploadManager_->recordAcquires(cb);
+    }
+
+    // Draws whose pipeline is still compiling or whose geometry is still uploading are skipped for this frame
+    const bool sceneResident = pGeometryPool_ && pUploadManager_->isAvailable(sceneUploadValue_);
+
+    // The GPU-driven path takes over once its pipelines and object buffer are ready, the CPU path covers until then
+    const uint32_t vertexColor = vertexColorsEnabled_ ? SCENE_VERTEX_COLOR : 0;
+    const VkPipeline cullPipeline = cullPipeline_.get();
+    const VkPipeline indirectPipeline = indirectPermutations_.get(SCENE_TEXTURED | vertexColor, SCENE_ALL_FEATURES);
+    const bool gpuDriven = gpuDrivenEnabled_ && sceneResident && pGpuScene_->ready() &&
+                           cullPipeline != VK_NULL_HANDLE && indirectPipeline != VK_NULL_HANDLE;
+    lastFrameGpuDriven_ = gpuDriven;
+
+    // Every CPU-driven draw can fall back to the variant with all features
+    const bool cpuDriven = sceneResident && !gpuDriven &&
+                           scenePermutations_.request(SCENE_ALL_FEATURES).get() != VK_NULL_HANDLE;
+    drawList_.clear();
+    if (cpuDriven)
+    {
+        buildDrawList();
+    }
+
+    RenderGraph& graph = *pRenderGraph_;
+    graph.reset(frameIndex);
+
+    // Targets are cleared every frame, so their previous contents are discarded. Swapchain images are handed over
+    // by the acquire semaphore wait at the color attachment stage, offscreen targets are left ready for readback.
+    const VkImageLayout restingLayout = headless_ ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    const uint32_t target = graph.importImage("Target", targetImages_[imgIndex], targetImageViews_[imgIndex],
+                                              { .format = colorFormat_, .extent = extent_ }, VK_IMAGE_LAYOUT_UNDEFINED,
+                                              VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, restingLayout);
+    // Sampled by the depth pyramid build
+    const uint32_t depth = graph.createImage("Depth", {
+        .format = DEPTH_FORMAT,
+        .extent = extent_,
+        .usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+    });
+
+    if (gpuDriven)
+    {
+        addGpuDrivenPasses(graph, target, depth, cullPipeline, indirectPipeline);
+    }
+    else
+    {
+        const uint32_t scenePass = graph.addPass("Scene", [&](VkCommandBuffer passCb)
+        {
+            recordScenePass(passCb, frameIndex, graph.imageView(target), graph.imageView(depth));
+        });
+        graph.write(scenePass, target, RenderGraph::Usage::ColorAttachment);
+        graph.write(scenePass, depth, RenderGraph::Usage::DepthAttachment);
+    }
+
+    // ImGui draws over the scene without depth, in a rendering scope of its own
+    if (!headless_)
+    {
+        const uint32_t imguiPass = graph.addPass("ImGui", [&](VkCommandBuffer passCb)
+        {
+            GpuProfiler::Scope scope(*pGpuProfiler_, passCb, "ImGui pass");
+            const VkRenderingAttachmentInfo colorAttachment {
+                .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+                .imageView = graph.imageView(target),
+                .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+                .loadOp = VK_ATTACHMENT_LOAD_OP_LOAD,
+                .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            };
+            const VkRenderingInfo renderingInfo {
+                .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+                .renderArea = scissor_,
+                .layerCount = 1,
+                .colorAttachmentCount = 1,
+                .pColorAttachments = &colorAttachment,
+            };
+            vkCmdBeginRendering(passCb, &renderingInfo);
+            ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), passCb, VK_NULL_HANDLE);
+            vkCmdEndRendering(passCb);
+        });
+        graph.read(imguiPass, target, RenderGraph::Usage::ColorAttachment);
+        graph.write(imguiPass, target, RenderGraph::Usage::ColorAttachment);
+    }
+
+    graph.compile();
+    graph.execute(cb);
+
+    pGpuProfiler_->endFrame(cb);
+
+    CHECK_VK(vkEndCommandBuffer(cb))
+}
 
-    VkRenderingAttachmentInfo renderingAttachmentInfo {
+void Renderer::addGpuDrivenPasses(RenderGraph& graph, uint32_t target, uint32_t depth, VkPipeline cullPipeline,
+                                  VkPipeline indirectPipeline)
+{
+    using Phase = GpuScene::CullPhase;
+
+    // While their pipelines compile, occlusion culling falls back to frustum culling and the prepass to one scene pass
+    const VkPipeline pyramidPipeline = pyramidPipeline_.get();
+    const VkPipeline prepassPipeline = depthPrepassPipeline_.get();
+    const bool occlusion = occlusionCullingEnabled_ && pyramidPipeline != VK_NULL_HANDLE;
+    const bool prepass = depthPrepassEnabled_ && prepassPipeline != VK_NULL_HANDLE;
+    const Phase firstPhase = occlusion ? Phase::Early : Phase::All;
+
+    // Passes execute within recordCommandBuffer(), after this function has returned
+    const auto addCullPass = [&](const char* name, Phase phase)
+    {
+        return graph.addPass(name, [=, this](VkCommandBuffer passCb)
+        {
+            GpuProfiler::Scope scope(*pGpuProfiler_, passCb, name);
+            pBindlessHeap_->bind(passCb, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipelineLayout_);
+            pGpuScene_->recordCull(passCb, cullPipeline, cullPipelineLayout_, frameDataAddress_, phase, cullingEnabled_,
+                                   phase == Phase::Late ? pDepthPyramid_->address() : 0);
+        });
+    };
+    const auto addScenePass = [&](const char* name, const IndirectPass& pass)
+    {
+        return graph.addPass(name, [=, this, &graph](VkCommandBuffer passCb)
+        {
+            GpuProfiler::Scope scope(*pGpuProfiler_, passCb, name);
+            recordIndirectPass(passCb, graph.imageView(target), graph.imageView(depth), pass);
+        });
+    };
+
+    const uint32_t drawBuffer = graph.importBuffer("Draw commands", pGpuScene_->drawBuffer());
+    // The late cull phase of the previous frame wrote the visibility the early phase reads
+    uint32_t objects = RenderGraph::INVALID_RESOURCE;
+    if (occlusion)
+    {
+        objects = graph.importBuffer("Objects", pGpuScene_->objectBuffer(), VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                                     VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
+        graph.markOutput(objects);
+    }
+
+    const uint32_t earlyCull = addCullPass(occlusion ? "Early cull" : "GPU cull", firstPhase);
+    graph.write(earlyCull, drawBuffer, RenderGraph::Usage::StorageCompute);
+    if (occlusion)
+    {
+        graph.read(earlyCull, objects, RenderGraph::Usage::StorageCompute);
+    }
+
+    // Without the prepass the early phase shades right away, the late phase continues its attachments
+    const uint32_t earlyDraw = addScenePass(prepass ? "Depth prepass" : "Scene pass", {
+        .pipeline = prepass ? prepassPipeline : indirectPipeline,
+        .phases = { firstPhase },
+        .color = !prepass,
+        .storeDepth = occlusion || prepass,
+    });
+    if (!prepass)
+    {
+        graph.write(earlyDraw, target, RenderGraph::Usage::ColorAttachment);
+    }
+    graph.write(earlyDraw, depth, RenderGraph::Usage::DepthAttachment);
+    graph.read(earlyDraw, drawBuffer, RenderGraph::Usage::IndirectCommand);
+
+    if (occlusion)
+    {
+        pDepthPyramid_->beginFrame(currentFrame_, extent_);
+        const uint32_t pyramid = graph.importBuffer("Depth pyramid", pDepthPyramid_->buffer());
+        const uint32_t pyramidPass = graph.addPass("Depth pyramid", [=, this, &graph](VkCommandBuffer passCb)
+        {
+            GpuProfiler::Scope scope(*pGpuProfiler_, passCb, "Depth pyramid");
+            // The transient depth view only exists within the frame, its slot is recycled once the frame retires
+            const uint32_t depthTexture = pBindlessHeap_->registerImage(graph.imageView(depth));
+            pBindlessHeap_->bind(passCb, VK_PIPELINE_BIND_POINT_COMPUTE, pyramidPipelineLayout_);
+            pDepthPyramid_->recordBuild(passCb, pyramidPipeline, pyramidPipelineLayout_, depthTexture);
+            pBindlessHeap_->release(BindlessHeap::Kind::SampledImage, depthTexture);
+        });
+        graph.read(pyramidPass, depth, RenderGraph::Usage::SampledCompute);
+        graph.write(pyramidPass, pyramid, RenderGraph::Usage::StorageCompute);
+
+        // Appends behind the early draws, which the prepass color pass still needs
+        const uint32_t lateCull = addCullPass("Late cull", Phase::Late);
+        graph.read(lateCull, pyramid, RenderGraph::Usage::StorageCompute);
+        graph.read(lateCull, objects, RenderGraph::Usage::StorageCompute);
+        graph.write(lateCull, objects, RenderGraph::Usage::StorageCompute);
+        graph.read(lateCull, drawBuffer, RenderGraph::Usage::StorageCompute);
+        graph.write(lateCull, drawBuffer, RenderGraph::Usage::StorageCompute);
+
+        const uint32_t lateDraw = addScenePass(prepass ? "Late depth prepass" : "Late scene pass", {
+            .pipeline = prepass ? prepassPipeline : indirectPipeline,
+            .phases = { Phase::Late },
+            .color = !prepass,
+            .loadColor = true,
+            .loadDepth = true,
+            .storeDepth = prepass,
+        });
+        if (!prepass)
+        {
+            graph.read(lateDraw, target, RenderGraph::Usage::ColorAttachment);
+            graph.write(lateDraw, target, RenderGraph::Usage::ColorAttachment);
+        }
+        graph.read(lateDraw, depth, RenderGraph::Usage::DepthAttachment);
+        graph.write(lateDraw, depth, RenderGraph::Usage::DepthAttachment);
+        graph.read(lateDraw, drawBuffer, RenderGraph::Usage::IndirectCommand);
+    }
+
+    // Shades every draw of the frame once more, only the fragments on the prepass depth survive the test
+    if (prepass)
+    {
+        const uint32_t colorPass = addScenePass("Scene pass", {
+            .pipeline = indirectPipeline,
+            .phases = occlusion ? std::vector{ Phase::Early, Phase::Late } : std::vector{ Phase::All },
+            .loadDepth = true,
+            .depthReadOnly = true,
+        });
+        graph.write(colorPass, target, RenderGraph::Usage::ColorAttachment);
+        graph.read(colorPass, depth, RenderGraph::Usage::DepthAttachment);
+        graph.read(colorPass, drawBuffer, RenderGraph::Usage::IndirectCommand);
+    }
+}
+
+void Renderer::recordIndirectPass(VkCommandBuffer cb, VkImageView target, VkImageView depth,
+                                  const IndirectPass& pass) const
+{
+    const VkRenderingAttachmentInfo colorAttachment {
         .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
-        .imageView = swapchainImageViews_[imgIndex],
+        .imageView = target,
+        .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+        .loadOp = pass.loadColor ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+        .clearValue = { .color = { { 0.0f, 0.0f, 0.0f, 1.0f } } },
+    };
+    const VkRenderingAttachmentInfo depthAttachment {
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+        .imageView = depth,
+        .imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+        .loadOp = pass.loadDepth ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = pass.storeDepth ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .clearValue = { .depthStencil = { 1.0f, 0 } },
+    };
+    const VkRenderingInfo renderingInfo {
+        .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
+        .renderArea = scissor_,
+        .layerCount = 1,
+        .colorAttachmentCount = pass.color ? 1U : 0U,
+        .pColorAttachments = pass.color ? &colorAttachment : nullptr,
+        .pDepthAttachment = &depthAttachment,
+    };
+
+    vkCmdBeginRendering(cb, &renderingInfo);
+    recordIndirectDraws(cb, pass);
+    vkCmdEndRendering(cb);
+}
+
+void Renderer::recordScenePass(VkCommandBuffer cb, uint32_t frameIndex, VkImageView target, VkImageView depth)
+{
+    const VkRenderingAttachmentInfo colorAttachment {
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+        .imageView = target,
         .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
         .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
         .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-        .clearValue = clearColor,
+        .clearValue = { .color = { { 0.0f, 0.0f, 0.0f, 1.0f } } },
+    };
+    // Depth is only needed while drawing the scene
+    const VkRenderingAttachmentInfo depthAttachment {
+        .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO,
+        .imageView = depth,
+        .imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
+        .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .clearValue = { .depthStencil = { 1.0f, 0 } },
     };
 
     VkRenderingInfo renderingInfo = {};
@@ -497,73 +1467,313 @@ void Renderer::recordCommandBuffer(VkCommandBuffer cb, const uint32_t imgIndex)
     renderingInfo.renderArea = scissor_;
     renderingInfo.layerCount = 1;
     renderingInfo.colorAttachmentCount = 1;
-    renderingInfo.pColorAttachments = &renderingAttachmentInfo;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    renderingInfo.pDepthAttachment = &depthAttachment;
 
-    vkCmdSetViewport(cb, 0, 1, &viewport_);
-    vkCmdSetScissor(cb, 0, 1, &scissor_);
+    // Small draw lists are cheaper to record inline than to fan out to workers
+    const bool parallel = recordThreadCount_ > 1 && drawList_.size() >= PARALLEL_RECORD_MIN_DRAWS;
+    GpuProfiler::Scope scope(*pGpuProfiler_, cb, "Scene pass");
+    if (parallel)
+    {
+        const std::vector<VkCommandBuffer> secondaries = recordSecondaries(frameIndex);
 
-    utils::vk::transitionImageLayout(cb,
-                                     swapchainImages_[imgIndex],
-                                     VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-                                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                                     VK_PIPELINE_STAGE_2_NONE,
-                                     VK_ACCESS_NONE,
-                                     VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-                                     VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
-    );
+        renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+        vkCmdBeginRendering(cb, &renderingInfo);
+        vkCmdExecuteCommands(cb, static_cast<uint32_t>(secondaries.size()), secondaries.data());
+        vkCmdEndRendering(cb);
+        return;
+    }
 
     vkCmdBeginRendering(cb, &renderingInfo);
+    recordSceneDraws(cb, 0, drawList_.size());
+    vkCmdEndRendering(cb);
+}
 
-    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline_);
+void Renderer::buildDrawList()
+{
+    if (cullingEnabled_)
+    {
+        SPECTRA_TRACE_SCOPE("Frustum cull");
+        // The recording workers are idle until the draw list exists, so culling borrows them
+        frustumCuller_.cull(Frustum::fromViewProjection(viewProjection_), visibleObjects_, pRecordThreadPool_.get());
+    }
+    else
+    {
+        visibleObjects_.resize(cullObjects_.size());
+        std::iota(visibleObjects_.begin(), visibleObjects_.end(), 0U);
+    }
 
-    VkDeviceSize vertOffset = 0;
-    vkCmdBindVertexBuffers(cb, 0, 1, &vertBuffer_, &vertOffset);
+    SPECTRA_TRACE_SCOPE("Build draw list");
+
+    // Key every visible primitive at its LOD and with the shader variant of its material; the mesh is the LOD, so only
+    // instances at the same level are merged. Variants still compiling draw with the one that has every feature.
+    drawListBuilder_.begin();
+    drawPipelines_.clear();
+    std::array<uint32_t, SCENE_ALL_FEATURES + 1> pipelineIndices{};
+    pipelineIndices.fill(~0U);
+    const uint32_t vertexColor = vertexColorsEnabled_ ? SCENE_VERTEX_COLOR : 0;
+    lodStats_ = {};
+    const glm::vec3 viewDirection = glm::normalize(camera_.target - camera_.position);
+    const float depthScale = 1.0f / (camera_.farPlane - camera_.nearPlane);
+    const float pixelsPerUnit = this->pixelsPerUnit();
+    for (const uint32_t objectIndex : visibleObjects_)
+    {
+        const CullObject& object = cullObjects_[objectIndex];
+        const PrimitiveDraw& draw = primitiveDraws_[object.draw];
+        const glm::vec3 position(sceneGraph_.worldMatrix(meshInstances_[object.instance].node)[3]);
+        const float depth = (glm::dot(position - camera_.position, viewDirection) - camera_.nearPlane) * depthScale;
+
+        // Bounding sphere of the world box, the error is projected at its nearest point
+        const GpuScene::Object& bounds = gpuObjects_[objectIndex];
+        const glm::vec3 center(bounds.boundsCenter);
+        const float radius = glm::length(glm::vec3(bounds.boundsExtent));
+        const float distance = std::max(glm::length(center - camera_.position) - radius, camera_.nearPlane);
+        const std::span<const GpuScene::Lod> lods(drawLods_.data() + draw.firstLod, draw.lodCount);
+        const uint32_t lod = draw.firstLod +
+                             selectLod(lods, bounds.boundsCenter.w * pixelsPerUnit / distance, lodErrorThreshold_);
+
+        lodStats_.triangles += drawLods_[lod].indexCount / 3;
+        lodStats_.fullDetailTriangles += lods.front().indexCount / 3;
+        const bool textured = materialTextures_[draw.material] != TextureStreamer::INVALID_TEXTURE;
+        const uint32_t features = (textured ? SCENE_TEXTURED : 0) | vertexColor;
+        uint32_t& pipelineIndex = pipelineIndices[features];
+        if (pipelineIndex == ~0U)
+        {
+            const VkPipeline pipeline = scenePermutations_.get(features, SCENE_ALL_FEATURES);
+            const auto it = std::ranges::find(drawPipelines_, pipeline);
+            pipelineIndex = static_cast<uint32_t>(it - drawPipelines_.begin());
+            if (it == drawPipelines_.end())
+            {
+                drawPipelines_.push_back(pipeline);
+            }
+        }
+        drawListBuilder_.add(DrawListBuilder::makeKey(pipelineIndex, draw.material, lod, depth), objectIndex);
+    }
+    drawListBuilder_.build(drawSortingEnabled_);
 
-    vkCmdDraw(cb, 3, 1, 0, 0);
+    // Per-draw data is a bump in the frame allocator. Transforms are written in batch order, so every batch reads its
+    // instances from one contiguous range.
+    const std::span<const uint32_t> instances = drawListBuilder_.instances();
+    if (instances.empty())
+    {
+        return;
+    }
+    const FrameAllocator::Allocation transforms = pFrameAllocator_->allocate(instances.size() * sizeof(glm::mat4));
+    auto* pTransforms = static_cast<glm::mat4*>(transforms.pData);
+    for (size_t i = 0; i < instances.size(); i++)
+    {
+        const CullObject& object = cullObjects_[instances[i]];
+        pTransforms[i] = sceneGraph_.worldMatrix(meshInstances_[object.instance].node);
+        if (vertexFormat_ == VertexFormat::Quantized)
+        {
+            pTransforms[i] = pTransforms[i] * primitiveDraws_[object.draw].dequantize;
+        }
+    }
 
-    // Render ImGui draw data within the same rendering scope
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), cb, VK_NULL_HANDLE);
+    for (const DrawListBuilder::Batch& batch : drawListBuilder_.batches())
+    {
+        // Instances of a batch share the LOD and with it the primitive
+        const PrimitiveDraw& draw = primitiveDraws_[cullObjects_[instances[batch.firstInstance]].draw];
+        const GpuScene::Lod& lod = drawLods_[DrawListBuilder::keyMesh(batch.key)];
+        drawList_.push_back({
+            .transforms = transforms.address + batch.firstInstance * sizeof(glm::mat4),
+            .indexCount = lod.indexCount,
+            .instanceCount = batch.instanceCount,
+            .firstIndex = lod.firstIndex,
+            .vertexOffset = static_cast<int32_t>(draw.geometry.vertices.offset),
+            .material = draw.material,
+            .pipeline = drawPipelines_[DrawListBuilder::keyPipeline(batch.key)],
+        });
+    }
+}
 
-    vkCmdEndRendering(cb);
+void Renderer::recordSceneDraws(VkCommandBuffer cb, size_t first, size_t last) const
+{
+    if (first == last)
+    {
+        return;
+    }
+
+    // The whole scene lives in one vertex and one index buffer, draws only differ in their ranges
+    const VkBuffer vertexBuffer = pGeometryPool_->vertexBuffer();
+    VkDeviceSize vertOffset = 0;
+    vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, &vertOffset);
+    vkCmdBindIndexBuffer(cb, pGeometryPool_->indexBuffer(), 0, VK_INDEX_TYPE_UINT32);
 
-    utils::vk::transitionImageLayout(cb,
-                                     swapchainImages_[imgIndex],
-                                     VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-                                     VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-                                     VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
-                                     VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
-                                     VK_PIPELINE_STAGE_2_NONE,
-                                     VK_ACCESS_NONE
-    );
+    pBindlessHeap_->bind(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipelineLayout_);
+    vkCmdPushConstants(cb, graphicsPipelineLayout_, DRAW_CONSTANT_STAGES,
+                       offsetof(DrawConstants, frameData), sizeof(VkDeviceAddress), &frameDataAddress_);
 
-    CHECK_VK(vkEndCommandBuffer(cb))
+    // The variants share the layout, so the constants pushed above survive pipeline changes
+    VkPipeline boundPipeline = VK_NULL_HANDLE;
+    uint32_t boundMaterial = ~0U;
+    for (size_t i = first; i < last; i++)
+    {
+        // Every batch reads its instances from its own range of transforms
+        const DrawItem& draw = drawList_[i];
+        if (draw.pipeline != boundPipeline)
+        {
+            vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, draw.pipeline);
+            boundPipeline = draw.pipeline;
+        }
+        vkCmdPushConstants(cb, graphicsPipelineLayout_, DRAW_CONSTANT_STAGES,
+                           offsetof(DrawConstants, instanceData), sizeof(VkDeviceAddress), &draw.transforms);
+        // Materials are an index into the bindless material buffer, sorted draws change it rarely
+        if (draw.material != boundMaterial)
+        {
+            vkCmdPushConstants(cb, graphicsPipelineLayout_, DRAW_CONSTANT_STAGES,
+                               offsetof(DrawConstants, material), sizeof(uint32_t), &draw.material);
+            boundMaterial = draw.material;
+        }
+        vkCmdDrawIndexed(cb, draw.indexCount, draw.instanceCount, draw.firstIndex, draw.vertexOffset, 0);
+    }
 }
 
-Slang::ComPtr<slang::ISession> Renderer::setupSlangSession(const Slang::ComPtr<slang::IGlobalSession>& globalSession) const
+void Renderer::recordIndirectDraws(VkCommandBuffer cb, const IndirectPass& pass) const
 {
-    slang::TargetDesc target_desc {
-        .format = SLANG_SPIRV,
-        .profile = globalSession->findProfile("spirv_1_4")
+    vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pass.pipeline);
+    vkCmdSetDepthWriteEnable(cb, pass.depthReadOnly ? VK_FALSE : VK_TRUE);
+
+    const VkBuffer vertexBuffer = pGeometryPool_->vertexBuffer();
+    VkDeviceSize vertOffset = 0;
+    vkCmdBindVertexBuffers(cb, 0, 1, &vertexBuffer, &vertOffset);
+    vkCmdBindIndexBuffer(cb, pGeometryPool_->indexBuffer(), 0, VK_INDEX_TYPE_UINT32);
+
+    pBindlessHeap_->bind(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipelineLayout_);
+    const DrawConstants constants {
+        .frameData = frameDataAddress_,
+        .instanceData = pGpuScene_->objectsAddress(),
     };
+    vkCmdPushConstants(cb, graphicsPipelineLayout_, DRAW_CONSTANT_STAGES, 0, sizeof(DrawConstants), &constants);
+
+    for (const GpuScene::CullPhase phase : pass.phases)
+    {
+        pGpuScene_->recordDraws(cb, phase);
+    }
+}
 
-    std::array<slang::CompilerOptionEntry, 1> options = {
+std::vector<VkCommandBuffer> Renderer::recordSecondaries(uint32_t frameIndex)
+{
+    const FrameData& frame = frames_[frameIndex];
+    const size_t workerCount = frame.workerCmdBuffers.size();
+    const size_t drawsPerWorker = (drawList_.size() + workerCount - 1) / workerCount;
+
+    std::vector<VkCommandBuffer> secondaries;
+    std::vector<std::future<void>> jobs;
+    for (size_t worker = 0; worker < workerCount; worker++)
+    {
+        const size_t first = worker * drawsPerWorker;
+        const size_t last = std::min(first + drawsPerWorker, drawList_.size());
+        if (first >= last)
         {
-            slang::CompilerOptionName::EmitSpirvDirectly,
-            {slang::CompilerOptionValueKind::Int, 1, 0, nullptr, nullptr}
+            break;
         }
-    };
 
-    slang::SessionDesc sessionDesc {
-        .targets = &target_desc,
-        .targetCount = 1,
-        .defaultMatrixLayoutMode = SLANG_MATRIX_LAYOUT_COLUMN_MAJOR,
-        .compilerOptionEntries = options.data(),
-        .compilerOptionEntryCount = static_cast<uint32_t>(options.size()),
-    };
+        // Each job owns one pool of this frame, so no command pool is ever touched by two threads
+        const VkCommandPool pool = frame.workerPools[worker];
+        const VkCommandBuffer cb = frame.workerCmdBuffers[worker];
+        secondaries.push_back(cb);
+
+        jobs.push_back(pRecordThreadPool_->submit([this, pool, cb, first, last]
+        {
+            SPECTRA_TRACE_SCOPE("Record secondary");
+            CHECK_VK(vkResetCommandPool(device_, pool, 0))
+
+            const VkCommandBufferInheritanceRenderingInfo inheritanceRenderingInfo {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+                .colorAttachmentCount = 1,
+                .pColorAttachmentFormats = &colorFormat_,
+                .depthAttachmentFormat = DEPTH_FORMAT,
+                .stencilAttachmentFormat = VK_FORMAT_UNDEFINED,
+                .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
+            };
+            const VkCommandBufferInheritanceInfo inheritanceInfo {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+                .pNext = &inheritanceRenderingInfo,
+            };
+            const VkCommandBufferBeginInfo beginInfo {
+                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+                .pInheritanceInfo = &inheritanceInfo,
+            };
+            CHECK_VK(vkBeginCommandBuffer(cb, &beginInfo))
+
+            // Dynamic state is not inherited from the primary
+            vkCmdSetViewport(cb, 0, 1, &viewport_);
+            vkCmdSetScissor(cb, 0, 1, &scissor_);
+            recordSceneDraws(cb, first, last);
+
+            CHECK_VK(vkEndCommandBuffer(cb))
+        }));
+    }
+
+    for (auto& job : jobs)
+    {
+        job.get();
+    }
+
+    return secondaries;
+}
 
-    Slang::ComPtr<slang::ISession> session;
-    globalSession->createSession(sessionDesc, session.writeRef());
+void Renderer::setRecordThreadCount(uint32_t count)
+{
+    count = std::max(count, 1U);
+    if (count == recordThreadCount_ && pRecordThreadPool_)
+    {
+        return;
+    }
 
-    return session;
+    vkDeviceWaitIdle(device_);
+    destroyRecordPools();
+    recordThreadCount_ = count;
+    createRecordPools();
+}
+
+void Renderer::createRecordPools()
+{
+    if (recordThreadCount_ <= 1)
+    {
+        return;
+    }
+
+    pRecordThreadPool_ = std::make_unique<ThreadPool>(recordThreadCount_, "Record worker");
+
+    for (auto& frame : frames_)
+    {
+        frame.workerPools.resize(recordThreadCount_);
+        frame.workerCmdBuffers.resize(recordThreadCount_);
+
+        for (uint32_t i = 0; i < recordThreadCount_; i++)
+        {
+            // Pools are reset wholesale every frame instead of per command buffer
+            VkCommandPoolCreateInfo createInfo = {};
+            createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            createInfo.queueFamilyIndex = pCtx_->graphicsQueueFamily;
+            CHECK_VK(vkCreateCommandPool(device_, &createInfo, VK_NULL_HANDLE, &frame.workerPools[i]))
+
+            VkCommandBufferAllocateInfo cbAllocInfo = {};
+            cbAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            cbAllocInfo.commandPool = frame.workerPools[i];
+            cbAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            cbAllocInfo.commandBufferCount = 1;
+            CHECK_VK(vkAllocateCommandBuffers(device_, &cbAllocInfo, &frame.workerCmdBuffers[i]))
+        }
+    }
+}
+
+void Renderer::destroyRecordPools()
+{
+    pRecordThreadPool_.reset();
+
+    for (auto& frame : frames_)
+    {
+        for (const auto& pool : frame.workerPools)
+        {
+            vkDestroyCommandPool(device_, pool, nullptr);
+        }
+        frame.workerPools.clear();
+        frame.workerCmdBuffers.clear();
+    }
 }
-} // spectra
\ No newline at end of file
+} // spectra
@@ -5,81 +5,388 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <algorithm>
+#include <array>
 #include <memory>
-#include <tiny_gltf.h>
-#include <slang/slang-com-ptr.h>
-#include <slang/slang.h>
+#include <optional>
+#include <thread>
 #include <vk_mem_alloc.h>
 #include <glm/glm.hpp>
 
+#include "BindlessHeap.h"
+#include "Camera.h"
+#include "DepthPyramid.h"
+#include "FrameAllocator.h"
+#include "FrustumCuller.h"
+#include "GeometryPool.h"
+#include "DrawListBuilder.h"
+#include "GpuProfiler.h"
+#include "GpuScene.h"
+#include "PipelineCompiler.h"
+#include "PipelinePermutations.h"
+#include "RenderGraph.h"
+#include "SceneAsset.h"
+#include "SceneGraph.h"
+#include "UploadManager.h"
+#include "ShaderCompiler.h"
+#include "ShaderWatcher.h"
+#include "TextureStreamer.h"
+#include "ThreadPool.h"
+#include "VertexFormat.h"
 #include "vk/Context.h"
+#include "vk/Swapchain.h"
 
 namespace spectra {
 class Renderer {
 public:
-    Renderer(std::shared_ptr<vk::Context> pCtx, vkb::Swapchain swapchain, std::vector<VkImageView> swapchainImgViews);
+    static constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 3;
+
+    // Frames in flight is how many frames the CPU may run ahead of the GPU, at least 1
+    Renderer(std::shared_ptr<vk::Context> pCtx, std::unique_ptr<vk::Swapchain> pSwapchain,
+             uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT);
+    // Headless renderer drawing into its own offscreen images instead of a swapchain
+    Renderer(std::shared_ptr<vk::Context> pCtx, VkExtent2D extent, VkFormat format,
+             uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT);
     ~Renderer();
 
-    void loadScene(const std::string& scenePath);
+    // Loads a .glb/.gltf file, or a package cooked by spectra-cook (.spk) which is mapped instead of parsed
+    bool loadScene(const std::string& scenePath);
+    // Skips the frame while the window is minimized or the swapchain is being recreated
     void render();
 
+    [[nodiscard]] uint32_t framesInFlight() const { return frameCount_; }
+    // Takes effect at the next frame by recreating the swapchain, no-op when headless
+    void setPresentMode(VkPresentModeKHR presentMode);
+    [[nodiscard]] VkPresentModeKHR presentMode() const;
+
+    // GPU time of the most recently retired frame, empty if no new measurement is available since the last call
+    std::optional<double> consumeGpuFrameTimeMs();
+    // Rolling GPU timings of the named scopes of recent frames
+    [[nodiscard]] std::vector<GpuProfiler::ScopeStats> gpuScopeStats() const { return pGpuProfiler_->stats(); }
+    // Writes the timing of every GPU scope of every following frame to a CSV file
+    bool startGpuTimingCapture(const std::string& csvPath) { return pGpuProfiler_->startCsvCapture(csvPath); }
+    void stopGpuTimingCapture() { pGpuProfiler_->stopCsvCapture(); }
+
+    // Threads recording scene draws into secondary command buffers, 1 records everything inline. Waits for the
+    // device to go idle, so only call it between frames.
+    void setRecordThreadCount(uint32_t count);
+    [[nodiscard]] uint32_t recordThreadCount() const { return recordThreadCount_; }
+    [[nodiscard]] double lastRecordTimeMs() const { return lastRecordTimeMs_; }
+
+    // Sorting merges draws of the same mesh and state into instanced draws on the CPU-driven path
+    void setDrawSorting(bool enabled) { drawSortingEnabled_ = enabled; }
+    [[nodiscard]] const DrawListBuilder::Stats& drawListStats() const { return drawListBuilder_.stats(); }
+
+    // Passes, barriers and transient memory of the last frame graph
+    [[nodiscard]] const RenderGraph::Stats& renderGraphStats() const { return pRenderGraph_->stats(); }
+
+    // GPU-driven rendering culls and builds the draws in a compute pass, otherwise the CPU records every draw
+    void setGpuDriven(bool enabled) { gpuDrivenEnabled_ = enabled; }
+    [[nodiscard]] bool gpuDriven() const { return gpuDrivenEnabled_; }
+
+    // GPU-driven path only. Occlusion culling draws the objects visible last frame, builds a depth pyramid from them
+    // and then draws the rest of the objects it does not hide.
+    void setOcclusionCulling(bool enabled) { occlusionCullingEnabled_ = enabled; }
+    [[nodiscard]] bool occlusionCulling() const { return occlusionCullingEnabled_; }
+    // GPU-driven path only. Draws the scene's depth first so shading only runs for the visible surface.
+    void setDepthPrepass(bool enabled) { depthPrepassEnabled_ = enabled; }
+    [[nodiscard]] bool depthPrepass() const { return depthPrepassEnabled_; }
+
+    // Vertex colors tint the base color. Switching selects other shader variants, compiled on first use.
+    void setVertexColors(bool enabled) { vertexColorsEnabled_ = enabled; }
+    [[nodiscard]] bool vertexColors() const { return vertexColorsEnabled_; }
+
+    // Vertex layout of the geometry pool. Recompiles the scene pipelines when it changes and applies to scenes
+    // loaded afterwards, so call it before loadScene().
+    void setVertexFormat(VertexFormat format);
+    [[nodiscard]] VertexFormat vertexFormat() const { return vertexFormat_; }
+    // Scene geometry as stored in the geometry pool
+    [[nodiscard]] VkDeviceSize sceneVertexBytes() const { return sceneVertexBytes_; }
+    [[nodiscard]] VkDeviceSize sceneIndexBytes() const { return sceneIndexBytes_; }
+
+    struct LodStats
+    {
+        uint64_t triangles = 0;
+        uint64_t fullDetailTriangles = 0; // What the same draws would have cost without LODs
+    };
+
+    // Screen-space error in pixels a LOD may introduce, the global trade of triangles for quality. 0 draws every
+    // object at full detail.
+    void setLodErrorThreshold(float pixels) { lodErrorThreshold_ = std::max(pixels, 0.0f); }
+    [[nodiscard]] float lodErrorThreshold() const { return lodErrorThreshold_; }
+    // Triangles of the last CPU-driven frame, the GPU-driven path selects LODs without reporting back
+    [[nodiscard]] const LodStats& lodStats() const { return lodStats_; }
+
+    // Texture memory the streamer may keep resident, detail beyond it is streamed out
+    void setTextureBudget(VkDeviceSize bytes) { pTextureStreamer_->setBudget(bytes); }
+    [[nodiscard]] TextureStreamer::Stats textureStats() const { return pTextureStreamer_->stats(); }
+
+    // Repeats the loaded scene on a grid, for stress testing with many draws
+    void replicateScene(uint32_t copies);
+
+    [[nodiscard]] ShaderCompiler::Stats shaderCompilerStats() const { return shaderCompiler_.stats(); }
+    [[nodiscard]] double startupTimeMs() const { return startupTimeMs_; }
+    // CPU time of the last loadScene(), until every upload was queued
+    [[nodiscard]] double sceneLoadTimeMs() const { return sceneLoadTimeMs_; }
+    [[nodiscard]] std::vector<PipelineCompiler::CompileRecord> pipelineCompileRecords() const
+    {
+        return pPipelineCompiler_->records();
+    }
+    // Blocks until every requested pipeline has compiled and the scene upload has completed
+    void waitUntilReady() const
+    {
+        scenePermutations_.wait();
+        indirectPermutations_.wait();
+        cullPipeline_.wait();
+        pyramidPipeline_.wait();
+        depthPrepassPipeline_.wait();
+        pUploadManager_->wait(std::max(sceneUploadValue_, pGpuScene_->uploadValue()));
+    }
+
 private:
+    // Scene depth, a transient of the frame graph
+    static constexpr VkFormat DEPTH_FORMAT = VK_FORMAT_D32_SFLOAT;
+
+    void init();
     void initVma();
-    void createBuffers();
+    // False when the scene does not fit the geometry pool, nothing of it is uploaded then
+    bool uploadScene(const SceneAsset& asset);
+    void uploadMaterials(const SceneAsset& asset);
+    void updateTextureStreaming();
+    void createDefaultSampler();
+    void buildMeshInstances(const SceneAsset& asset);
+    void collectMeshInstances();
+    void updateCullBounds();
+    void createGpuDrivenPipelines();
+    void createOffscreenTargets(uint32_t count);
     void createGraphicsPipeline();
+    void createScenePipelines();
     void createCommandPool(VkCommandPool& commandPool);
     void allocateCommandBuffers(VkDevice device);
     void createSyncObjects(VkDevice device);
-    void recordCommandBuffer(VkCommandBuffer cb, uint32_t imgIndex) const;
-    Slang::ComPtr<slang::ISession> setupSlangSession(const Slang::ComPtr<slang::IGlobalSession>& globalSession) const;
+    // Swaps in a swapchain matching the window, the old one is retired once the frames using it have finished
+    bool recreateSwapchain(); // False while the window is minimized
+    void updateViewport();
+    void recordCommandBuffer(VkCommandBuffer cb, uint32_t imgIndex, uint32_t frameIndex);
+    void recordScenePass(VkCommandBuffer cb, uint32_t frameIndex, VkImageView target, VkImageView depth);
+
+    // A rendering scope of the GPU-driven path, drawing what the given cull phases appended
+    struct IndirectPass
+    {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        std::vector<GpuScene::CullPhase> phases;
+        bool color = true; // Depth only otherwise
+        // Continue the attachments of an earlier pass of the frame instead of clearing them
+        bool loadColor = false;
+        bool loadDepth = false;
+        bool storeDepth = false; // Later passes of the frame read the depth
+        bool depthReadOnly = false; // Tests against the depth prepass without writing
+    };
+    // Adds the cull, pyramid and scene passes of the GPU-driven path to the frame graph
+    void addGpuDrivenPasses(RenderGraph& graph, uint32_t target, uint32_t depth, VkPipeline cullPipeline,
+                            VkPipeline indirectPipeline);
+    void recordIndirectPass(VkCommandBuffer cb, VkImageView target, VkImageView depth, const IndirectPass& pass) const;
+    void buildDrawList();
+    void recordSceneDraws(VkCommandBuffer cb, size_t first, size_t last) const;
+    void recordIndirectDraws(VkCommandBuffer cb, const IndirectPass& pass) const;
+    std::vector<VkCommandBuffer> recordSecondaries(uint32_t frameIndex);
+    void createRecordPools();
+    void destroyRecordPools();
+    void fitCamera(const glm::vec3& sceneMin, const glm::vec3& sceneMax);
+    // Pixels an object of world size 1 at distance 1 covers on screen
+    [[nodiscard]] float pixelsPerUnit() const;
 
     std::shared_ptr<vk::Context>        pCtx_;
     VkDevice                            device_ = VK_NULL_HANDLE;
+    bool                                headless_ = false;
 
     VmaAllocator                        allocator_ = VK_NULL_HANDLE;
 
-    Slang::ComPtr<slang::IGlobalSession> slangGlobalSession_{};
+    ShaderCompiler shaderCompiler_{};
+    std::unique_ptr<PipelineCompiler> pPipelineCompiler_;
+    std::unique_ptr<ShaderWatcher> pShaderWatcher_; // Null when headless
+    double startupTimeMs_ = 0.0;
+    double sceneLoadTimeMs_ = 0.0;
+
+    std::unique_ptr<BindlessHeap> pBindlessHeap_;
+    VkSampler defaultSampler_ = VK_NULL_HANDLE;
+    uint32_t defaultSamplerHandle_ = BindlessHeap::INVALID_HANDLE;
+
+    // Feature bits of the scene shader variants, in the order of their permutation features
+    static constexpr uint32_t SCENE_TEXTURED = 1U << 0;
+    static constexpr uint32_t SCENE_VERTEX_COLOR = 1U << 1;
+    static constexpr uint32_t SCENE_ALL_FEATURES = SCENE_TEXTURED | SCENE_VERTEX_COLOR; // Stands in while others compile
 
     VkPipelineLayout graphicsPipelineLayout_ = VK_NULL_HANDLE;
-    VkPipeline graphicsPipeline_ = VK_NULL_HANDLE;
+    PipelinePermutations scenePermutations_;
+    // GPU-driven path, the indirect pipelines share the graphics layout
+    PipelinePermutations indirectPermutations_;
+    bool vertexColorsEnabled_ = true;
+    VkPipelineLayout cullPipelineLayout_ = VK_NULL_HANDLE;
+    PipelineHandle cullPipeline_{};
+    VkPipelineLayout pyramidPipelineLayout_ = VK_NULL_HANDLE;
+    PipelineHandle pyramidPipeline_{};
+    PipelineHandle depthPrepassPipeline_{}; // Vertex-only variant of the indirect pipeline
 
     VkViewport viewport_{};
     VkRect2D scissor_{};
 
-    vkb::Swapchain vkbSwapchain_{};
-    std::vector<VkImage> swapchainImages_;
-    std::vector<VkImageView> swapchainImageViews_;
+    std::unique_ptr<vk::Swapchain> pSwapchain_; // Null when headless
+    VkExtent2D extent_{};
+    VkFormat colorFormat_ = VK_FORMAT_UNDEFINED;
+    // Swapchain images when presenting, VMA-allocated offscreen images when headless
+    std::vector<VkImage> targetImages_;
+    std::vector<VkImageView> targetImageViews_;
+    std::vector<VmaAllocation> offscreenAllocs_;
 
-    std::vector<VkSemaphore> availableSemaphores_;
-    std::vector<VkSemaphore> finishedSemaphores_;
-    std::vector<VkFence> inFlightFences_; // Per frame
-    std::vector<VkFence> swapchainImgFences_; // Per swapchain image
+    // Frame n signals n when its submission finishes, so waiting for frame n - frameCount_ frees the slot of frame n
+    VkSemaphore frameTimeline_ = VK_NULL_HANDLE;
+    uint64_t frameNumber_ = 0; // Frames submitted so far
+    bool swapchainOutdated_ = false; // Acquire or present reported VK_ERROR_OUT_OF_DATE_KHR
+    uint32_t frameCount_ = DEFAULT_FRAMES_IN_FLIGHT;
 
     VkDescriptorPool imguiDescriptorPool_ = VK_NULL_HANDLE;
 
-    uint32_t currentFrame_ = 0;
+    uint32_t currentFrame_ = 0; // Slot of the frame being recorded, frame number modulo frameCount_
+
+    std::unique_ptr<GpuProfiler> pGpuProfiler_;
+    std::unique_ptr<RenderGraph> pRenderGraph_;
 
     struct FrameData
     {
         VkCommandPool cmdPool = VK_NULL_HANDLE;
         VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+        VkSemaphore acquireSemaphore = VK_NULL_HANDLE; // Signaled when the acquired swapchain image is free
+        // One pool and secondary command buffer per recording thread
+        std::vector<VkCommandPool> workerPools;
+        std::vector<VkCommandBuffer> workerCmdBuffers;
     };
     std::vector<FrameData> frames_{};
 
-    tinygltf::Model model_;
+    static constexpr size_t PARALLEL_RECORD_MIN_DRAWS = 512;
+    uint32_t recordThreadCount_ = std::clamp(std::thread::hardware_concurrency(), 1U, 8U);
+    std::unique_ptr<ThreadPool> pRecordThreadPool_;
+    double lastRecordTimeMs_ = 0.0;
+
+    // One draw per scene primitive, all referencing ranges of the shared geometry pool
+    struct PrimitiveDraw
+    {
+        GeometryPool::Allocation geometry;
+        uint32_t firstLod = 0; // Into drawLods_, full detail first
+        uint32_t lodCount = 0;
+        uint32_t material = 0; // Scene material + 1, 0 when the primitive has none
+        glm::vec3 boundsMin{ 0.0f }; // Mesh space
+        glm::vec3 boundsMax{ 0.0f };
+        glm::mat4 dequantize{ 1.0f }; // Maps stored positions to mesh space, identity for float vertices
+    };
+
+    struct MeshInstance
+    {
+        uint32_t mesh = 0;
+        uint32_t node = 0; // World matrix lives in the scene graph
+    };
+
+    struct MeshPrimitives
+    {
+        uint32_t firstDraw = 0;
+        uint32_t drawCount = 0;
+    };
+
+    // Per-frame shader data (FrameData in the shaders), lives in the frame allocator and is read through a device address
+    struct FrameConstants
+    {
+        glm::mat4 viewProjection;
+        std::array<glm::vec4, 6> frustumPlanes; // For GPU culling
+        glm::vec4 cameraPosition{ 0.0f }; // For GPU LOD selection, w is the near plane distance
+        VkDeviceAddress textureSlots = 0; // Bindless image slot per streamed texture, in the frame allocator
+        uint32_t materialBuffer = BindlessHeap::INVALID_HANDLE;
+        float pixelsPerUnit = 0.0f;
+        float lodErrorThreshold = 0.0f; // Pixels
+    };
+
+    // GpuMaterial in the shaders, indexed by PrimitiveDraw::material
+    struct GpuMaterial
+    {
+        glm::vec4 baseColorFactor{ 1.0f };
+        uint32_t baseColorTexture = TextureStreamer::INVALID_TEXTURE; // Streamed texture, resolved through textureSlots
+        uint32_t baseColorSampler = BindlessHeap::INVALID_HANDLE;
+        uint32_t padding[2]{};
+    };
+
+    struct DrawConstants
+    {
+        VkDeviceAddress frameData;
+        VkDeviceAddress instanceData; // Per-instance transforms of the draw, the object buffer on the GPU-driven path
+        uint32_t material;            // CPU-driven path only, GPU-driven draws take it from their object
+        uint32_t padding;
+    };
+    static constexpr VkShaderStageFlags DRAW_CONSTANT_STAGES = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    std::unique_ptr<UploadManager> pUploadManager_;
+    uint64_t sceneUploadValue_ = 0;
+    std::optional<VkSemaphoreSubmitInfo> uploadWait_; // Added to the submission of the frame being recorded
+
+    std::unique_ptr<GeometryPool> pGeometryPool_;
+    VertexFormat vertexFormat_ = VertexFormat::Float;
+    VkDeviceSize sceneVertexBytes_ = 0;
+    VkDeviceSize sceneIndexBytes_ = 0;
+    std::vector<PrimitiveDraw> primitiveDraws_;
+    std::vector<GpuScene::Lod> drawLods_; // Index ranges in the geometry pool, shared with the GPU-driven path
+    float lodErrorThreshold_ = 1.0f;
+    LodStats lodStats_{};
+    // Material 0 is the default, scene material i is i + 1
+    VkBuffer materialBuffer_ = VK_NULL_HANDLE;
+    VmaAllocation materialAlloc_{};
+    uint32_t materialBufferHandle_ = BindlessHeap::INVALID_HANDLE;
+    std::unique_ptr<TextureStreamer> pTextureStreamer_;
+    std::vector<uint32_t> materialTextures_; // Base color texture per material, for streaming requests
+    static constexpr uint32_t TEXTURE_REQUEST_INTERVAL = 8; // Frames between on-screen size estimates
+    uint32_t framesUntilTextureRequests_ = 0;
+    std::vector<MeshPrimitives> meshPrimitives_; // Indexed by scene mesh
+    SceneGraph sceneGraph_;
+    std::vector<MeshInstance> meshInstances_; // One per scene graph node with a mesh
+
+    // Culling works per primitive of every instance
+    struct CullObject
+    {
+        uint32_t instance = 0;
+        uint32_t draw = 0; // Index into primitiveDraws_
+    };
+    std::vector<CullObject> cullObjects_;
+    FrustumCuller frustumCuller_;
+    std::vector<uint32_t> visibleObjects_;
+    bool cullingEnabled_ = true;
+    glm::mat4 viewProjection_{ 1.0f };
+    glm::vec3 sceneMin_{ 0.0f };
+    glm::vec3 sceneMax_{ 0.0f };
 
-    struct Vertex
+    struct DrawItem
     {
-        glm::vec2 position;
-        glm::vec3 color;
+        VkDeviceAddress transforms = 0; // instanceCount world matrices in the frame allocator
+        uint32_t indexCount = 0;
+        uint32_t instanceCount = 0;
+        uint32_t firstIndex = 0;
+        int32_t vertexOffset = 0;
+        uint32_t material = 0;
+        VkPipeline pipeline = VK_NULL_HANDLE; // Variant for the material
     };
+    std::vector<DrawItem> drawList_; // Rebuilt every frame
+    std::vector<VkPipeline> drawPipelines_; // By the pipeline index of the draw keys, rebuilt every frame
+    DrawListBuilder drawListBuilder_;
+    bool drawSortingEnabled_ = true;
 
-    VkBuffer vertBuffer_ = VK_NULL_HANDLE;
-    VmaAllocation vertAlloc_{};
-    VkBuffer stagingBuffer_ = VK_NULL_HANDLE;
-    VmaAllocation stagingAlloc_{};
+    // GPU-driven path, one object per cull object
+    std::unique_ptr<GpuScene> pGpuScene_;
+    std::vector<GpuScene::Object> gpuObjects_;
+    bool gpuDrivenEnabled_ = true;
+    bool lastFrameGpuDriven_ = false;
+    std::unique_ptr<DepthPyramid> pDepthPyramid_;
+    bool occlusionCullingEnabled_ = true;
+    bool depthPrepassEnabled_ = false;
 
-    VkCommandPool temporaryCmdPool_ = VK_NULL_HANDLE;
+    Camera camera_{};
+    std::unique_ptr<FrameAllocator> pFrameAllocator_;
+    VkDeviceAddress frameDataAddress_ = 0;
 };
 } // spectra
 
@@ -0,0 +1,533 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "SceneAsset.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "GeometryOptimizer.h"
+#include "Gltf.h"
+#include "ScenePackage.h"
+
+namespace spectra {
+namespace {
+// Image index of a texture, following KHR_texture_basisu to its KTX2 image. -1 when there is none.
+int textureSource(const tinygltf::Model& model, int textureIndex)
+{
+    if (textureIndex < 0 || textureIndex >= static_cast<int>(model.textures.size()))
+    {
+        return -1;
+    }
+
+    // The core source is only a fallback for viewers without the extension
+    const tinygltf::Texture& texture = model.textures[textureIndex];
+    int source = texture.source;
+    if (const auto it = texture.extensions.find("KHR_texture_basisu");
+        it != texture.extensions.end() && it->second.Has("source"))
+    {
+        source = it->second.Get("source").GetNumberAsInt();
+    }
+    if (source < 0 || source >= static_cast<int>(model.images.size()) || model.images[source].image.empty())
+    {
+        return -1;
+    }
+    return source;
+}
+
+template <typename T>
+bool sectionSpan(std::span<const uint8_t> file, const package::SectionRange& range, std::span<const T>& out)
+{
+    if (range.offset % package::ALIGNMENT != 0 || range.size % sizeof(T) != 0 || range.offset > file.size() ||
+        range.size > file.size() - range.offset)
+    {
+        return false;
+    }
+    // The mapping is page aligned and section offsets are multiples of ALIGNMENT, so the cast is aligned
+    out = { reinterpret_cast<const T*>(file.data() + range.offset), range.size / sizeof(T) };
+    return true;
+}
+
+template <typename T>
+std::span<const uint8_t> bytesOf(std::span<const T> values)
+{
+    return { reinterpret_cast<const uint8_t*>(values.data()), values.size_bytes() };
+}
+
+// Vertex cache metrics over several primitives. The ratios are recombined from the transformed vertex counts they
+// stand for, overdraw is averaged by triangle count.
+struct CacheMetricTotals
+{
+    double transformedBefore = 0.0;
+    double transformedAfter = 0.0;
+    double overdrawBefore = 0.0;
+    double overdrawAfter = 0.0;
+    size_t triangles = 0;
+    size_t verticesBefore = 0;
+    size_t verticesAfter = 0;
+
+    void add(const GeometryOptimizeResult& result, size_t triangleCount, size_t vertexCountBefore,
+             size_t vertexCountAfter)
+    {
+        transformedBefore += result.before.acmr * static_cast<double>(triangleCount);
+        transformedAfter += result.after.acmr * static_cast<double>(triangleCount);
+        overdrawBefore += result.before.overdraw * static_cast<double>(triangleCount);
+        overdrawAfter += result.after.overdraw * static_cast<double>(triangleCount);
+        triangles += triangleCount;
+        verticesBefore += vertexCountBefore;
+        verticesAfter += vertexCountAfter;
+    }
+
+    void add(const CacheMetricTotals& other)
+    {
+        transformedBefore += other.transformedBefore;
+        transformedAfter += other.transformedAfter;
+        overdrawBefore += other.overdrawBefore;
+        overdrawAfter += other.overdrawAfter;
+        triangles += other.triangles;
+        verticesBefore += other.verticesBefore;
+        verticesAfter += other.verticesAfter;
+    }
+
+    [[nodiscard]] std::string format(bool overdraw) const
+    {
+        const auto triangleCount = static_cast<double>(triangles);
+        std::string text = std::format("ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}", transformedBefore / triangleCount,
+                                       transformedAfter / triangleCount,
+                                       transformedBefore / static_cast<double>(verticesBefore),
+                                       transformedAfter / static_cast<double>(verticesAfter));
+        if (overdraw)
+        {
+            text += std::format(", overdraw {:.3f} -> {:.3f}", overdrawBefore / triangleCount,
+                                overdrawAfter / triangleCount);
+        }
+        return text;
+    }
+};
+
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+}
+
+SceneAsset SceneAsset::fromGltf(tinygltf::Model& model, const ImportOptions& options)
+{
+    SceneAsset asset;
+
+    // Images shared by several materials are stored once
+    std::vector<uint32_t> imageIndices(model.images.size(), NO_IMAGE);
+    std::vector<std::vector<uint8_t>> images;
+    asset.materialStorage_.resize(model.materials.size());
+    for (size_t i = 0; i < model.materials.size(); i++)
+    {
+        const auto& pbr = model.materials[i].pbrMetallicRoughness;
+        Material& material = asset.materialStorage_[i];
+        if (pbr.baseColorFactor.size() == 4)
+        {
+            material.baseColorFactor = glm::vec4(glm::make_vec4(pbr.baseColorFactor.data()));
+        }
+
+        const int source = textureSource(model, pbr.baseColorTexture.index);
+        if (source >= 0 && imageIndices[source] == NO_IMAGE)
+        {
+            imageIndices[source] = static_cast<uint32_t>(images.size());
+            images.push_back(std::move(model.images[source].image));
+        }
+        material.baseColorImage = source >= 0 ? imageIndices[source] : NO_IMAGE;
+    }
+    asset.setImages(images);
+
+    CacheMetricTotals sceneMetrics;
+    asset.meshStorage_.resize(model.meshes.size());
+    for (size_t meshIndex = 0; meshIndex < model.meshes.size(); meshIndex++)
+    {
+        asset.meshStorage_[meshIndex].firstPrimitive = static_cast<uint32_t>(asset.primitiveStorage_.size());
+        CacheMetricTotals meshMetrics;
+
+        for (const auto& gltfPrimitive : model.meshes[meshIndex].primitives)
+        {
+            const auto positionIt = gltfPrimitive.attributes.find("POSITION");
+            if (positionIt == gltfPrimitive.attributes.end() ||
+                (gltfPrimitive.mode != TINYGLTF_MODE_TRIANGLES && gltfPrimitive.mode != -1))
+            {
+                continue;
+            }
+
+            const std::vector<glm::vec3> positions = gltf::readVec3(model, positionIt->second);
+            if (positions.empty())
+            {
+                std::cerr << std::format("Skipping a primitive of mesh {}: unreadable positions\n", meshIndex);
+                continue;
+            }
+
+            // Vertex colors when present, otherwise visualize normals so geometry stays readable
+            std::vector<glm::vec3> colors(positions.size(), glm::vec3(1.0f));
+            if (const auto it = gltfPrimitive.attributes.find("COLOR_0"); it != gltfPrimitive.attributes.end())
+            {
+                colors = gltf::readVec3(model, it->second);
+            }
+            else if (const auto normalIt = gltfPrimitive.attributes.find("NORMAL"); normalIt != gltfPrimitive.attributes.end())
+            {
+                colors = gltf::readVec3(model, normalIt->second);
+                for (auto& color : colors)
+                {
+                    color = color * 0.5f + 0.5f;
+                }
+            }
+
+            std::vector<glm::vec2> uvs;
+            if (const auto it = gltfPrimitive.attributes.find("TEXCOORD_0"); it != gltfPrimitive.attributes.end())
+            {
+                uvs = gltf::readVec2(model, it->second);
+            }
+
+            Primitive primitive { .material = static_cast<uint32_t>(gltfPrimitive.material + 1) };
+
+            // glTF requires min/max on position accessors, positions are only scanned for files that omit them
+            const auto& positionAccessor = model.accessors[positionIt->second];
+            if (positionAccessor.minValues.size() == 3 && positionAccessor.maxValues.size() == 3)
+            {
+                primitive.boundsMin = glm::vec3(glm::make_vec3(positionAccessor.minValues.data()));
+                primitive.boundsMax = glm::vec3(glm::make_vec3(positionAccessor.maxValues.data()));
+            }
+            else if (!positions.empty())
+            {
+                primitive.boundsMin = primitive.boundsMax = positions.front();
+                for (const auto& position : positions)
+                {
+                    primitive.boundsMin = glm::min(primitive.boundsMin, position);
+                    primitive.boundsMax = glm::max(primitive.boundsMax, position);
+                }
+            }
+
+            std::vector<Vertex> vertices(positions.size());
+            for (size_t i = 0; i < positions.size(); i++)
+            {
+                vertices[i] = {
+                    positions[i],
+                    i < colors.size() ? colors[i] : glm::vec3(1.0f),
+                    i < uvs.size() ? uvs[i] : glm::vec2(0.0f),
+                };
+            }
+
+            std::vector<uint32_t> indices;
+            if (gltfPrimitive.indices >= 0)
+            {
+                indices = gltf::readIndices(model, gltfPrimitive.indices);
+            }
+            else
+            {
+                indices.resize(positions.size());
+                std::iota(indices.begin(), indices.end(), 0U);
+            }
+
+            const auto outOfRange = [&](uint32_t index) { return index >= vertices.size(); };
+            if (indices.empty() || std::ranges::any_of(indices, outOfRange))
+            {
+                std::cerr << std::format("Skipping a primitive of mesh {}: unreadable or out of range indices\n",
+                                         meshIndex);
+                continue;
+            }
+
+            // File order is whatever the exporter produced, reordering is cheap next to the draws it saves
+            const size_t vertexCountBefore = vertices.size();
+            const GeometryOptimizeResult optimized = optimizeGeometry(vertices, indices, options.geometry);
+            if (optimized.before.acmr > 0.0f)
+            {
+                meshMetrics.add(optimized, indices.size() / 3, vertexCountBefore, vertices.size());
+            }
+
+            if (options.meshlets)
+            {
+                primitive.firstMeshlet = static_cast<uint32_t>(asset.meshletStorage_.size());
+                buildMeshlets(vertices, indices, asset.meshletStorage_, asset.meshletVertexStorage_,
+                              asset.meshletTriangleStorage_);
+                primitive.meshletCount = static_cast<uint32_t>(asset.meshletStorage_.size()) - primitive.firstMeshlet;
+            }
+
+            // Coarser levels follow the full-detail indices and share the vertices
+            primitive.firstLod = static_cast<uint32_t>(asset.lodStorage_.size());
+            asset.lodStorage_.push_back({ .indexCount = static_cast<uint32_t>(indices.size()) });
+            if (options.lods)
+            {
+                for (const LodLevel& level : buildLods(vertices, indices))
+                {
+                    asset.lodStorage_.push_back({
+                        .firstIndex = static_cast<uint32_t>(indices.size()),
+                        .indexCount = static_cast<uint32_t>(level.indices.size()),
+                        .error = level.error,
+                    });
+                    indices.insert(indices.end(), level.indices.begin(), level.indices.end());
+                }
+            }
+            primitive.lodCount = static_cast<uint32_t>(asset.lodStorage_.size()) - primitive.firstLod;
+
+            primitive.firstVertex = static_cast<uint32_t>(asset.vertexStorage_.size());
+            primitive.vertexCount = static_cast<uint32_t>(vertices.size());
+            primitive.firstIndex = static_cast<uint32_t>(asset.indexStorage_.size());
+            primitive.indexCount = static_cast<uint32_t>(indices.size());
+            asset.vertexStorage_.insert(asset.vertexStorage_.end(), vertices.begin(), vertices.end());
+            asset.indexStorage_.insert(asset.indexStorage_.end(), indices.begin(), indices.end());
+
+            asset.primitiveStorage_.push_back(primitive);
+            asset.meshStorage_[meshIndex].primitiveCount++;
+        }
+
+        if (options.logMetrics && meshMetrics.triangles > 0)
+        {
+            std::clog << std::format("Mesh {} '{}': {}\n", meshIndex, model.meshes[meshIndex].name,
+                                     meshMetrics.format(options.geometry.overdraw));
+        }
+        sceneMetrics.add(meshMetrics);
+    }
+    if (sceneMetrics.triangles > 0)
+    {
+        std::clog << std::format("Geometry: {} triangles, {}{}, {} LODs for {} primitives\n", sceneMetrics.triangles,
+                                 sceneMetrics.format(options.geometry.overdraw),
+                                 options.geometry.optimize ? "" : " (not optimized)", asset.lodStorage_.size(),
+                                 asset.primitiveStorage_.size());
+    }
+
+    const int sceneIndex = model.defaultScene >= 0 ? model.defaultScene : 0;
+    const SceneGraph graph = SceneGraph::fromGltf(model, sceneIndex);
+    asset.nodeStorage_.reserve(graph.nodeCount());
+    for (uint32_t node = 0; node < graph.nodeCount(); node++)
+    {
+        asset.nodeStorage_.push_back(graph.nodeDesc(node));
+    }
+
+    asset.useStorage();
+    return asset;
+}
+
+std::optional<SceneAsset> SceneAsset::loadPackage(const std::string& path)
+{
+    std::optional<MappedFile> file = MappedFile::open(path);
+    if (!file)
+    {
+        return std::nullopt;
+    }
+
+    const auto fail = [&](const char* reason) -> std::optional<SceneAsset>
+    {
+        std::cerr << std::format("Invalid scene package {}: {}\n", path, reason);
+        return std::nullopt;
+    };
+
+    const std::span<const uint8_t> data = file->data();
+    package::Header header;
+    if (data.size() < sizeof(header))
+    {
+        return fail("truncated header");
+    }
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != package::MAGIC)
+    {
+        return fail("not a scene package");
+    }
+    if (header.version != package::VERSION || header.vertexSize != sizeof(Vertex) ||
+        header.primitiveSize != sizeof(Primitive) || header.lodSize != sizeof(Lod) ||
+        header.meshletSize != sizeof(Meshlet) || header.materialSize != sizeof(Material) ||
+        header.nodeSize != sizeof(SceneGraph::NodeDesc))
+    {
+        return fail("cooked by an incompatible version, cook it again");
+    }
+
+    SceneAsset asset;
+    const auto& sections = header.sections;
+    if (!sectionSpan(data, sections[package::VERTICES], asset.vertices_) ||
+        !sectionSpan(data, sections[package::INDICES], asset.indices_) ||
+        !sectionSpan(data, sections[package::PRIMITIVES], asset.primitives_) ||
+        !sectionSpan(data, sections[package::LODS], asset.lods_) ||
+        !sectionSpan(data, sections[package::MESHES], asset.meshes_) ||
+        !sectionSpan(data, sections[package::MATERIALS], asset.materials_) ||
+        !sectionSpan(data, sections[package::NODES], asset.nodes_) ||
+        !sectionSpan(data, sections[package::MESHLETS], asset.meshlets_) ||
+        !sectionSpan(data, sections[package::MESHLET_VERTICES], asset.meshletVertices_) ||
+        !sectionSpan(data, sections[package::MESHLET_TRIANGLES], asset.meshletTriangles_) ||
+        !sectionSpan(data, sections[package::IMAGES], asset.images_) ||
+        !sectionSpan(data, sections[package::IMAGE_DATA], asset.imageData_))
+    {
+        return fail("section out of range");
+    }
+
+    // Only the tables are checked, they are small. Index values are trusted, like those of a glTF file.
+    for (const Primitive& primitive : asset.primitives_)
+    {
+        if (primitive.firstVertex > asset.vertices_.size() ||
+            primitive.vertexCount > asset.vertices_.size() - primitive.firstVertex ||
+            primitive.firstIndex > asset.indices_.size() ||
+            primitive.indexCount > asset.indices_.size() - primitive.firstIndex ||
+            primitive.material > asset.materials_.size() || primitive.firstMeshlet > asset.meshlets_.size() ||
+            primitive.meshletCount > asset.meshlets_.size() - primitive.firstMeshlet ||
+            primitive.lodCount == 0 || primitive.firstLod > asset.lods_.size() ||
+            primitive.lodCount > asset.lods_.size() - primitive.firstLod)
+        {
+            return fail("primitive out of range");
+        }
+        for (const Lod& lod : asset.lods_.subspan(primitive.firstLod, primitive.lodCount))
+        {
+            if (lod.firstIndex > primitive.indexCount || lod.indexCount > primitive.indexCount - lod.firstIndex)
+            {
+                return fail("LOD out of range");
+            }
+        }
+    }
+    for (const Meshlet& meshlet : asset.meshlets_)
+    {
+        if (meshlet.vertexOffset > asset.meshletVertices_.size() ||
+            meshlet.vertexCount > asset.meshletVertices_.size() - meshlet.vertexOffset ||
+            meshlet.triangleOffset > asset.meshletTriangles_.size() ||
+            uint64_t{ meshlet.triangleCount } * 3 > asset.meshletTriangles_.size() - meshlet.triangleOffset)
+        {
+            return fail("meshlet out of range");
+        }
+    }
+    for (const Mesh& mesh : asset.meshes_)
+    {
+        if (mesh.firstPrimitive > asset.primitives_.size() ||
+            mesh.primitiveCount > asset.primitives_.size() - mesh.firstPrimitive)
+        {
+            return fail("mesh out of range");
+        }
+    }
+    for (const Material& material : asset.materials_)
+    {
+        if (material.baseColorImage != NO_IMAGE && material.baseColorImage >= asset.images_.size())
+        {
+            return fail("material image out of range");
+        }
+    }
+    // Subtrees are contiguous in depth-first order, a node's parent is on the path from the root to the node before it
+    std::vector<uint32_t> ancestors;
+    for (uint32_t i = 0; i < asset.nodes_.size(); i++)
+    {
+        const SceneGraph::NodeDesc& node = asset.nodes_[i];
+        while (!ancestors.empty() && ancestors.back() != node.parent)
+        {
+            ancestors.pop_back();
+        }
+        if ((node.parent != SceneGraph::NO_PARENT && ancestors.empty()) || node.mesh < SceneGraph::NO_MESH ||
+            node.mesh >= static_cast<int32_t>(asset.meshes_.size()))
+        {
+            return fail("node out of order or out of range");
+        }
+        ancestors.push_back(i);
+    }
+    for (const ImageRange& image : asset.images_)
+    {
+        if (image.offset > asset.imageData_.size() || image.size > asset.imageData_.size() - image.offset)
+        {
+            return fail("image out of range");
+        }
+    }
+
+    asset.file_ = std::move(*file);
+    return asset;
+}
+
+bool SceneAsset::writePackage(const std::string& path) const
+{
+    const std::array<std::span<const uint8_t>, package::SECTION_COUNT> sections = {
+        bytesOf(vertices_), bytesOf(indices_), bytesOf(primitives_), bytesOf(lods_), bytesOf(meshes_),
+        bytesOf(materials_), bytesOf(nodes_), bytesOf(meshlets_), bytesOf(meshletVertices_), meshletTriangles_,
+        bytesOf(images_), imageData_,
+    };
+
+    package::Header header {
+        .vertexSize = sizeof(Vertex),
+        .primitiveSize = sizeof(Primitive),
+        .lodSize = sizeof(Lod),
+        .meshletSize = sizeof(Meshlet),
+        .materialSize = sizeof(Material),
+        .nodeSize = sizeof(SceneGraph::NodeDesc),
+    };
+    uint64_t offset = sizeof(header);
+    for (uint32_t i = 0; i < package::SECTION_COUNT; i++)
+    {
+        offset = alignUp(offset, package::ALIGNMENT);
+        header.sections[i] = { offset, sections[i].size() };
+        offset += sections[i].size();
+    }
+
+    // Write next to the destination and rename over it, a failed cook must not replace a good package with a
+    // truncated one
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            std::cerr << std::format("Failed to open {} for writing\n", tmpPath);
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        constexpr std::array<char, package::ALIGNMENT> ZEROS{};
+        uint64_t written = sizeof(header);
+        for (uint32_t i = 0; i < package::SECTION_COUNT; i++)
+        {
+            file.write(ZEROS.data(), static_cast<std::streamsize>(header.sections[i].offset - written));
+            file.write(reinterpret_cast<const char*>(sections[i].data()),
+                       static_cast<std::streamsize>(sections[i].size()));
+            written = header.sections[i].offset + sections[i].size();
+        }
+
+        file.close();
+        if (!file)
+        {
+            std::cerr << std::format("Failed to write {}\n", tmpPath);
+            std::error_code ec;
+            std::filesystem::remove(tmpPath, ec);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        std::cerr << std::format("Failed to replace {}: {}\n", path, ec.message());
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+void SceneAsset::setImages(const std::vector<std::vector<uint8_t>>& images)
+{
+    imageStorage_.clear();
+    imageDataStorage_.clear();
+    for (const auto& image : images)
+    {
+        imageStorage_.push_back({ imageDataStorage_.size(), image.size() });
+        imageDataStorage_.insert(imageDataStorage_.end(), image.begin(), image.end());
+    }
+    images_ = imageStorage_;
+    imageData_ = imageDataStorage_;
+}
+
+void SceneAsset::useStorage()
+{
+    vertices_ = vertexStorage_;
+    indices_ = indexStorage_;
+    primitives_ = primitiveStorage_;
+    lods_ = lodStorage_;
+    meshes_ = meshStorage_;
+    materials_ = materialStorage_;
+    nodes_ = nodeStorage_;
+    meshlets_ = meshletStorage_;
+    meshletVertices_ = meshletVertexStorage_;
+    meshletTriangles_ = meshletTriangleStorage_;
+    images_ = imageStorage_;
+    imageData_ = imageDataStorage_;
+}
+} // spectra
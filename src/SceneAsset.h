@@ -0,0 +1,147 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_SCENEASSET_H
+#define SPECTRA_SCENEASSET_H
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include <tiny_gltf.h>
+#include <glm/glm.hpp>
+
+#include "GeometryOptimizer.h"
+#include "MappedFile.h"
+#include "SceneGraph.h"
+#include "VertexFormat.h"
+
+namespace spectra {
+// Scene data in the form the renderer uploads: one vertex and index array for the whole scene, primitives as
+// ranges of them with their bounds, LODs and meshlets, flattened nodes and encoded images. Built from a parsed glTF
+// model, or mapped from a package cooked by spectra-cook, in which case every array points straight into the mapped
+// file.
+class SceneAsset {
+public:
+    static constexpr uint32_t NO_IMAGE = ~0U;
+
+    // Triangles of one level of detail, indexing the vertices of its primitive
+    struct Lod
+    {
+        uint32_t firstIndex = 0; // Relative to the first index of the primitive
+        uint32_t indexCount = 0;
+        float error = 0.0f;      // How far the surface may have moved, in mesh units
+    };
+
+    struct Primitive
+    {
+        uint32_t firstVertex = 0;
+        uint32_t vertexCount = 0;
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0; // Indices of every LOD
+        uint32_t material = 0; // Material index + 1, 0 when the primitive has none
+        glm::vec3 boundsMin{ 0.0f }; // Mesh space
+        glm::vec3 boundsMax{ 0.0f };
+        uint32_t firstLod = 0;
+        uint32_t lodCount = 0;     // At least one, full detail first
+        uint32_t firstMeshlet = 0; // Meshlets cover full detail
+        uint32_t meshletCount = 0; // 0 when imported without meshlets
+    };
+
+    struct Mesh
+    {
+        uint32_t firstPrimitive = 0;
+        uint32_t primitiveCount = 0;
+    };
+
+    struct Material
+    {
+        glm::vec4 baseColorFactor{ 1.0f };
+        uint32_t baseColorImage = NO_IMAGE;
+        uint32_t padding[3]{};
+    };
+
+    struct ImageRange
+    {
+        uint64_t offset = 0; // Into the image data
+        uint64_t size = 0;
+    };
+
+    struct ImportOptions
+    {
+        GeometryOptimizeOptions geometry;
+        bool lods = true;
+        bool meshlets = false;   // The renderer does not draw by meshlet yet, only cooked packages carry them
+        bool logMetrics = false; // Vertex cache metrics of every mesh, the scene totals are always logged
+    };
+
+    SceneAsset() = default;
+    SceneAsset(SceneAsset&&) = default;
+    SceneAsset& operator=(SceneAsset&&) = default;
+    SceneAsset(const SceneAsset&) = delete;
+    SceneAsset& operator=(const SceneAsset&) = delete;
+
+    // Converts the triangle primitives and the default scene, reordering every primitive for the vertex cache and
+    // vertex fetch unless disabled and simplifying it into LODs. Encoded images are moved out of the model, only the ones base color textures
+    // reference are kept.
+    static SceneAsset fromGltf(tinygltf::Model& model, const ImportOptions& options = {});
+    // Maps a package and validates its ranges, nothing is copied
+    static std::optional<SceneAsset> loadPackage(const std::string& path);
+    bool writePackage(const std::string& path) const;
+
+    [[nodiscard]] std::span<const Vertex> vertices() const { return vertices_; }
+    [[nodiscard]] std::span<const uint32_t> indices() const { return indices_; }
+    [[nodiscard]] std::span<const Primitive> primitives() const { return primitives_; }
+    [[nodiscard]] std::span<const Lod> lods() const { return lods_; }
+    [[nodiscard]] std::span<const Mesh> meshes() const { return meshes_; }
+    [[nodiscard]] std::span<const Material> materials() const { return materials_; }
+    [[nodiscard]] std::span<const SceneGraph::NodeDesc> nodes() const { return nodes_; }
+    [[nodiscard]] std::span<const Meshlet> meshlets() const { return meshlets_; }
+    [[nodiscard]] std::span<const uint32_t> meshletVertices() const { return meshletVertices_; }
+    [[nodiscard]] std::span<const uint8_t> meshletTriangles() const { return meshletTriangles_; }
+    [[nodiscard]] uint32_t imageCount() const { return static_cast<uint32_t>(images_.size()); }
+    [[nodiscard]] std::span<const uint8_t> image(uint32_t index) const
+    {
+        return imageData_.subspan(images_[index].offset, images_[index].size);
+    }
+
+    // Replaces every encoded image, e.g. with their KTX2 versions when cooking
+    void setImages(const std::vector<std::vector<uint8_t>>& images);
+
+private:
+    // Points the spans at the owned arrays
+    void useStorage();
+
+    std::span<const Vertex> vertices_;
+    std::span<const uint32_t> indices_;
+    std::span<const Primitive> primitives_;
+    std::span<const Lod> lods_;
+    std::span<const Mesh> meshes_;
+    std::span<const Material> materials_;
+    std::span<const SceneGraph::NodeDesc> nodes_;
+    std::span<const Meshlet> meshlets_;
+    std::span<const uint32_t> meshletVertices_;
+    std::span<const uint8_t> meshletTriangles_;
+    std::span<const ImageRange> images_;
+    std::span<const uint8_t> imageData_;
+
+    // Backing storage of the spans, either the mapped package or arrays built from a glTF model
+    MappedFile file_;
+    std::vector<Vertex> vertexStorage_;
+    std::vector<uint32_t> indexStorage_;
+    std::vector<Primitive> primitiveStorage_;
+    std::vector<Lod> lodStorage_;
+    std::vector<Mesh> meshStorage_;
+    std::vector<Material> materialStorage_;
+    std::vector<SceneGraph::NodeDesc> nodeStorage_;
+    std::vector<Meshlet> meshletStorage_;
+    std::vector<uint32_t> meshletVertexStorage_;
+    std::vector<uint8_t> meshletTriangleStorage_;
+    std::vector<ImageRange> imageStorage_;
+    std::vector<uint8_t> imageDataStorage_;
+};
+} // spectra
+
+#endif //SPECTRA_SCENEASSET_H
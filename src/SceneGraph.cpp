@@ -0,0 +1,294 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "SceneGraph.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Gltf.h"
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define SPECTRA_SCENEGRAPH_SSE 1
+#endif
+
+namespace spectra {
+namespace {
+// Local matrices are composed in batches of this many nodes before being chained to their parents
+constexpr uint32_t UPDATE_BATCH_SIZE = 64;
+
+SceneGraph::Transform decompose(const glm::mat4& matrix)
+{
+    // glTF requires node matrices to be decomposable into TRS, so shear is not handled
+    SceneGraph::Transform transform;
+    transform.translation = glm::vec3(matrix[3]);
+    transform.scale = glm::vec3(glm::length(glm::vec3(matrix[0])),
+                                glm::length(glm::vec3(matrix[1])),
+                                glm::length(glm::vec3(matrix[2])));
+    if (glm::determinant(glm::mat3(matrix)) < 0.0f)
+    {
+        transform.scale.x = -transform.scale.x;
+    }
+
+    // A zero scale leaves its axis without a direction. With one such axis the other two still define the rotation,
+    // with more the node has collapsed to a line or point and any rotation will do.
+    glm::mat3 rotation(1.0f);
+    uint32_t degenerateAxis = 3;
+    uint32_t degenerateCount = 0;
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        if (std::abs(transform.scale[axis]) <= std::numeric_limits<float>::min())
+        {
+            degenerateAxis = axis;
+            degenerateCount++;
+            continue;
+        }
+        rotation[axis] = glm::vec3(matrix[axis]) / transform.scale[axis];
+    }
+    if (degenerateCount > 1)
+    {
+        return transform;
+    }
+    if (degenerateCount == 1)
+    {
+        rotation[degenerateAxis] = glm::cross(rotation[(degenerateAxis + 1) % 3], rotation[(degenerateAxis + 2) % 3]);
+    }
+    transform.rotation = glm::normalize(glm::quat_cast(rotation));
+    return transform;
+}
+
+SceneGraph::Transform nodeTransform(const tinygltf::Node& node)
+{
+    if (node.matrix.size() == 16)
+    {
+        return decompose(gltf::nodeLocalMatrix(node));
+    }
+
+    SceneGraph::Transform transform;
+    if (node.translation.size() == 3)
+    {
+        transform.translation = glm::vec3(glm::make_vec3(node.translation.data()));
+    }
+    if (node.rotation.size() == 4)
+    {
+        // glTF stores quaternions as xyzw, glm constructs them as wxyz
+        transform.rotation = glm::quat(static_cast<float>(node.rotation[3]), static_cast<float>(node.rotation[0]),
+                                       static_cast<float>(node.rotation[1]), static_cast<float>(node.rotation[2]));
+    }
+    if (node.scale.size() == 3)
+    {
+        transform.scale = glm::vec3(glm::make_vec3(node.scale.data()));
+    }
+    return transform;
+}
+
+// out = a * b, out must not alias b
+void multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& out)
+{
+#ifdef SPECTRA_SCENEGRAPH_SSE
+    // Each output column is a linear combination of the columns of a
+    const __m128 a0 = _mm_loadu_ps(glm::value_ptr(a[0]));
+    const __m128 a1 = _mm_loadu_ps(glm::value_ptr(a[1]));
+    const __m128 a2 = _mm_loadu_ps(glm::value_ptr(a[2]));
+    const __m128 a3 = _mm_loadu_ps(glm::value_ptr(a[3]));
+    for (int column = 0; column < 4; column++)
+    {
+        __m128 result = _mm_mul_ps(a0, _mm_set1_ps(b[column][0]));
+        result = _mm_add_ps(result, _mm_mul_ps(a1, _mm_set1_ps(b[column][1])));
+        result = _mm_add_ps(result, _mm_mul_ps(a2, _mm_set1_ps(b[column][2])));
+        result = _mm_add_ps(result, _mm_mul_ps(a3, _mm_set1_ps(b[column][3])));
+        _mm_storeu_ps(glm::value_ptr(out[column]), result);
+    }
+#else
+    out = a * b;
+#endif
+}
+}
+
+SceneGraph SceneGraph::fromGltf(const tinygltf::Model& model, int sceneIndex)
+{
+    SceneGraph graph;
+    if (sceneIndex < 0 || sceneIndex >= static_cast<int>(model.scenes.size()))
+    {
+        return graph;
+    }
+
+    // glTF nodes have at most one parent, so a node reached twice is shared or part of a cycle
+    graph.parents_.reserve(model.nodes.size());
+    std::vector<bool> visited(model.nodes.size(), false);
+    std::function<void(int, uint32_t)> visit = [&](int nodeIndex, uint32_t parent)
+    {
+        if (nodeIndex < 0 || nodeIndex >= static_cast<int>(model.nodes.size()) || visited[nodeIndex])
+        {
+            std::cerr << std::format("Skipping glTF node {}: out of range or already in the scene\n", nodeIndex);
+            return;
+        }
+        visited[nodeIndex] = true;
+
+        const tinygltf::Node& node = model.nodes[nodeIndex];
+        const uint32_t index = graph.addNode(parent, nodeTransform(node), node.mesh >= 0 ? node.mesh : NO_MESH);
+        for (const int child : node.children)
+        {
+            visit(child, index);
+        }
+        graph.subtreeEnds_[index] = graph.nodeCount();
+    };
+    for (const int root : model.scenes[sceneIndex].nodes)
+    {
+        visit(root, NO_PARENT);
+    }
+
+    graph.markRootsDirty();
+    return graph;
+}
+
+SceneGraph SceneGraph::fromNodes(std::span<const NodeDesc> nodes)
+{
+    SceneGraph graph;
+    graph.parents_.reserve(nodes.size());
+    for (const NodeDesc& node : nodes)
+    {
+        graph.addNode(node.parent, node.transform, node.mesh);
+    }
+
+    // Walking backwards, every subtree end is final before it is propagated to the parent
+    for (uint32_t node = graph.nodeCount(); node-- > 0;)
+    {
+        const uint32_t parent = graph.parents_[node];
+        if (parent != NO_PARENT)
+        {
+            graph.subtreeEnds_[parent] = std::max(graph.subtreeEnds_[parent], graph.subtreeEnds_[node]);
+        }
+    }
+
+    graph.markRootsDirty();
+    return graph;
+}
+
+void SceneGraph::appendCopy(uint32_t count, const Transform& rootTransform)
+{
+    count = std::min(count, nodeCount());
+
+    const uint32_t root = addNode(NO_PARENT, rootTransform, NO_MESH);
+    const uint32_t offset = root + 1;
+    for (uint32_t node = 0; node < count; node++)
+    {
+        const uint32_t parent = parents_[node] == NO_PARENT ? root : parents_[node] + offset;
+        addNode(parent, localTransform(node), meshes_[node]);
+        subtreeEnds_.back() = std::min(subtreeEnds_[node], count) + offset;
+    }
+    subtreeEnds_[root] = nodeCount();
+
+    markDirty(root);
+}
+
+void SceneGraph::setLocalTransform(uint32_t node, const Transform& transform)
+{
+    translations_[node] = transform.translation;
+    rotations_[node] = transform.rotation;
+    scales_[node] = transform.scale;
+    markDirty(node);
+}
+
+uint32_t SceneGraph::update()
+{
+    lastUpdateCount_ = 0;
+    if (dirtyRoots_.empty())
+    {
+        return 0;
+    }
+
+    // In depth-first order a dirty node inside an already updated subtree is covered by that subtree
+    std::ranges::sort(dirtyRoots_);
+    uint32_t coveredEnd = 0;
+    for (const uint32_t node : dirtyRoots_)
+    {
+        dirty_[node] = 0;
+        if (node < coveredEnd)
+        {
+            continue;
+        }
+
+        coveredEnd = subtreeEnds_[node];
+        updateRange(node, coveredEnd);
+        lastUpdateCount_ += coveredEnd - node;
+    }
+    dirtyRoots_.clear();
+
+    return lastUpdateCount_;
+}
+
+uint32_t SceneGraph::addNode(uint32_t parent, const Transform& transform, int32_t mesh)
+{
+    const auto index = static_cast<uint32_t>(parents_.size());
+    parents_.push_back(parent);
+    subtreeEnds_.push_back(index + 1);
+    meshes_.push_back(mesh);
+    translations_.push_back(transform.translation);
+    rotations_.push_back(transform.rotation);
+    scales_.push_back(transform.scale);
+    worldMatrices_.emplace_back(1.0f);
+    dirty_.push_back(0);
+    return index;
+}
+
+void SceneGraph::markDirty(uint32_t node)
+{
+    if (!dirty_[node])
+    {
+        dirty_[node] = 1;
+        dirtyRoots_.push_back(node);
+    }
+}
+
+void SceneGraph::markRootsDirty()
+{
+    // Marking every root dirty makes the first update compute the whole graph
+    for (uint32_t node = 0; node < nodeCount(); node = subtreeEnds_[node])
+    {
+        markDirty(node);
+    }
+}
+
+void SceneGraph::updateRange(uint32_t first, uint32_t last)
+{
+    std::array<glm::mat4, UPDATE_BATCH_SIZE> locals;
+    for (uint32_t batchBegin = first; batchBegin < last; batchBegin += UPDATE_BATCH_SIZE)
+    {
+        const uint32_t batchEnd = std::min(batchBegin + UPDATE_BATCH_SIZE, last);
+
+        // Composing TRS only reads the SoA arrays and has no dependencies between nodes
+        for (uint32_t node = batchBegin; node < batchEnd; node++)
+        {
+            const glm::mat3 rotation = glm::mat3_cast(rotations_[node]);
+            glm::mat4& local = locals[node - batchBegin];
+            local[0] = glm::vec4(rotation[0] * scales_[node].x, 0.0f);
+            local[1] = glm::vec4(rotation[1] * scales_[node].y, 0.0f);
+            local[2] = glm::vec4(rotation[2] * scales_[node].z, 0.0f);
+            local[3] = glm::vec4(translations_[node], 1.0f);
+        }
+
+        // Parents precede children, so every parent world matrix is final by the time a child reads it
+        for (uint32_t node = batchBegin; node < batchEnd; node++)
+        {
+            const glm::mat4& local = locals[node - batchBegin];
+            if (parents_[node] == NO_PARENT)
+            {
+                worldMatrices_[node] = local;
+            }
+            else
+            {
+                multiply(worldMatrices_[parents_[node]], local, worldMatrices_[node]);
+            }
+        }
+    }
+}
+} // spectra
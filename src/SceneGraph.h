@@ -0,0 +1,93 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_SCENEGRAPH_H
+#define SPECTRA_SCENEGRAPH_H
+
+#include <span>
+#include <vector>
+#include <tiny_gltf.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace spectra {
+// Flattened node hierarchy stored as structure-of-arrays. Nodes are kept in depth-first order, so a parent always
+// precedes its children and every subtree is the contiguous range [node, subtreeEnd(node)). Changing a local
+// transform only marks the node dirty; update() then recomputes world matrices of the dirty subtrees alone, so the
+// per-frame cost follows what moved rather than the size of the scene.
+class SceneGraph {
+public:
+    static constexpr uint32_t NO_PARENT = ~0U;
+    static constexpr int32_t NO_MESH = -1;
+
+    struct Transform
+    {
+        glm::vec3 translation{ 0.0f };
+        glm::quat rotation{ 1.0f, 0.0f, 0.0f, 0.0f };
+        glm::vec3 scale{ 1.0f };
+    };
+
+    // A node in flattened form, as stored in scene packages
+    struct NodeDesc
+    {
+        uint32_t parent = NO_PARENT;
+        int32_t mesh = NO_MESH;
+        Transform transform;
+    };
+
+    SceneGraph() = default;
+
+    // Flattens the nodes reachable from the scene's roots, matrices are decomposed into TRS
+    static SceneGraph fromGltf(const tinygltf::Model& model, int sceneIndex);
+    // Builds a graph from nodes already in depth-first order, every parent must precede its children
+    static SceneGraph fromNodes(std::span<const NodeDesc> nodes);
+
+    // Appends a new root with the given transform, holding a copy of the first `count` nodes. Copies are dirty
+    // until the next update().
+    void appendCopy(uint32_t count, const Transform& rootTransform);
+
+    void setLocalTransform(uint32_t node, const Transform& transform);
+
+    // Recomputes world matrices below every node changed since the last call, returns the number of nodes updated
+    uint32_t update();
+
+    [[nodiscard]] uint32_t nodeCount() const { return static_cast<uint32_t>(parents_.size()); }
+    [[nodiscard]] uint32_t parent(uint32_t node) const { return parents_[node]; }
+    [[nodiscard]] uint32_t subtreeEnd(uint32_t node) const { return subtreeEnds_[node]; }
+    [[nodiscard]] int32_t mesh(uint32_t node) const { return meshes_[node]; }
+    [[nodiscard]] Transform localTransform(uint32_t node) const
+    {
+        return { translations_[node], rotations_[node], scales_[node] };
+    }
+    [[nodiscard]] NodeDesc nodeDesc(uint32_t node) const { return { parents_[node], meshes_[node], localTransform(node) }; }
+    [[nodiscard]] const glm::mat4& worldMatrix(uint32_t node) const { return worldMatrices_[node]; }
+    [[nodiscard]] std::span<const glm::mat4> worldMatrices() const { return worldMatrices_; }
+    // Nodes recomputed by the most recent update()
+    [[nodiscard]] uint32_t lastUpdateCount() const { return lastUpdateCount_; }
+
+private:
+    uint32_t addNode(uint32_t parent, const Transform& transform, int32_t mesh);
+    void markDirty(uint32_t node);
+    void markRootsDirty();
+    void updateRange(uint32_t first, uint32_t last);
+
+    // Hierarchy
+    std::vector<uint32_t> parents_;
+    std::vector<uint32_t> subtreeEnds_;
+    std::vector<int32_t> meshes_;
+
+    // Local transforms
+    std::vector<glm::vec3> translations_;
+    std::vector<glm::quat> rotations_;
+    std::vector<glm::vec3> scales_;
+
+    std::vector<glm::mat4> worldMatrices_;
+
+    std::vector<uint8_t> dirty_;
+    std::vector<uint32_t> dirtyRoots_; // Nodes whose local transform changed since the last update
+    uint32_t lastUpdateCount_ = 0;
+};
+} // spectra
+
+#endif //SPECTRA_SCENEGRAPH_H
@@ -0,0 +1,60 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_SCENEPACKAGE_H
+#define SPECTRA_SCENEPACKAGE_H
+
+#include <array>
+#include <cstdint>
+
+// On-disk layout of a cooked scene (.spk), written by spectra-cook and mapped by SceneAsset::loadPackage. The file
+// is a Header followed by sections, each an array of the corresponding SceneAsset struct stored exactly as it is
+// laid out in memory, so loading only validates ranges and points into the mapping. Little-endian only.
+namespace spectra::package {
+constexpr std::array<char, 8> MAGIC = { 'S', 'P', 'E', 'C', 'T', 'P', 'K', 'G' };
+// Bumped on any change to the header, a section or one of the structs stored in them
+constexpr uint32_t VERSION = 3;
+// Every section starts at a multiple of this, enough for the vec4 members of the stored structs
+constexpr uint64_t ALIGNMENT = 16;
+
+enum Section : uint32_t
+{
+    VERTICES,          // Vertex, full precision
+    INDICES,           // uint32_t, relative to the first vertex of their primitive
+    PRIMITIVES,        // SceneAsset::Primitive
+    LODS,              // SceneAsset::Lod, ranges of them per primitive
+    MESHES,            // SceneAsset::Mesh
+    MATERIALS,         // SceneAsset::Material
+    NODES,             // SceneGraph::NodeDesc in depth-first order
+    MESHLETS,          // Meshlet, ranges of them per primitive
+    MESHLET_VERTICES,  // uint32_t, relative to the first vertex of their primitive
+    MESHLET_TRIANGLES, // uint8_t triplets into the meshlet vertices
+    IMAGES,            // SceneAsset::ImageRange, into IMAGE_DATA
+    IMAGE_DATA,        // Encoded images, KTX2 when cooked
+    SECTION_COUNT,
+};
+
+struct SectionRange
+{
+    uint64_t offset = 0; // From the start of the file
+    uint64_t size = 0;   // In bytes
+};
+
+struct Header
+{
+    std::array<char, 8> magic = MAGIC;
+    uint32_t version = VERSION;
+    // Sizes of the stored structs, a mismatch means the file was cooked by a build with a different layout
+    uint32_t vertexSize = 0;
+    uint32_t primitiveSize = 0;
+    uint32_t lodSize = 0;
+    uint32_t meshletSize = 0;
+    uint32_t materialSize = 0;
+    uint32_t nodeSize = 0;
+    uint32_t padding = 0;
+    std::array<SectionRange, SECTION_COUNT> sections{};
+};
+} // spectra::package
+
+#endif //SPECTRA_SCENEPACKAGE_H
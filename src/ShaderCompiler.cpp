@@ -0,0 +1,300 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "ShaderCompiler.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "Hash.h"
+#include "Trace.h"
+
+namespace spectra {
+namespace {
+// Everything that influences the generated code lives here, so session setup and the cache key cannot drift apart
+constexpr const char* SPIRV_PROFILE = "spirv_1_4";
+constexpr int EMIT_SPIRV_DIRECTLY = 1;
+constexpr SlangMatrixLayoutMode MATRIX_LAYOUT = SLANG_MATRIX_LAYOUT_COLUMN_MAJOR;
+
+// Bump when the cache file layout or key derivation changes
+constexpr uint32_t CACHE_VERSION = 3;
+constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+
+bool readFile(const std::filesystem::path& path, std::string& contents)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    contents = ss.str();
+    return true;
+}
+
+// Slang resolves `import a.b_c;` to a/b-c.slang (or a/b_c.slang) next to the importing file
+std::filesystem::path resolveImport(const std::filesystem::path& dir, std::string moduleName)
+{
+    std::ranges::replace(moduleName, '.', '/');
+    std::filesystem::path candidate = dir / (moduleName + ".slang");
+    if (std::filesystem::exists(candidate))
+    {
+        return candidate;
+    }
+    std::ranges::replace(moduleName, '_', '-');
+    return dir / (moduleName + ".slang");
+}
+
+// `import "dir/file.slang";` names the file itself, the extension may be left out
+std::filesystem::path resolveImportPath(const std::filesystem::path& dir, const std::string& importPath)
+{
+    std::filesystem::path candidate = dir / importPath;
+    if (!candidate.has_extension())
+    {
+        candidate += ".slang";
+    }
+    return candidate;
+}
+
+void hashSourceTree(const std::filesystem::path& path, std::set<std::filesystem::path>& visited, uint64_t& hash)
+{
+    const auto canonical = std::filesystem::weakly_canonical(path);
+    if (!visited.insert(canonical).second)
+    {
+        return;
+    }
+
+    std::string source;
+    if (!readFile(path, source))
+    {
+        // A missing import still changes the key, Slang will report the actual error on compile
+        hash = fnv1a(path.generic_string(), hash);
+        return;
+    }
+    hash = fnv1a(path.filename().generic_string(), hash);
+    hash = fnv1a(source, hash);
+
+    // Either a module name or, quoted, a path relative to the importing file
+    static const std::regex importRegex(R"re(^\s*(?:__)?import\s+(?:([A-Za-z0-9_.\-]+)|"([^"]+)")\s*;)re",
+                                        std::regex::multiline);
+    for (auto it = std::sregex_iterator(source.begin(), source.end(), importRegex); it != std::sregex_iterator(); ++it)
+    {
+        const std::filesystem::path imported = (*it)[1].matched
+                                                   ? resolveImport(path.parent_path(), (*it)[1].str())
+                                                   : resolveImportPath(path.parent_path(), (*it)[2].str());
+        hashSourceTree(imported, visited, hash);
+    }
+}
+} // namespace
+
+ShaderCompiler::ShaderCompiler(std::filesystem::path cacheDir) : cacheDir_(std::move(cacheDir))
+{
+}
+
+std::vector<uint32_t> ShaderCompiler::compile(const std::string& moduleName, const std::filesystem::path& sourcePath,
+                                              const std::vector<LinkConstant>& constants)
+{
+    SPECTRA_TRACE_SCOPE("Compile shader");
+    const auto start = std::chrono::steady_clock::now();
+
+    const auto cachePath = cacheDir_ / std::format("{:016x}.spv", computeCacheKey(sourcePath, constants));
+
+    std::vector<uint32_t> spirv;
+    std::string cached;
+    if (readFile(cachePath, cached) && cached.size() >= sizeof(uint32_t) && cached.size() % sizeof(uint32_t) == 0)
+    {
+        spirv.resize(cached.size() / sizeof(uint32_t));
+        memcpy(spirv.data(), cached.data(), cached.size());
+        if (spirv[0] != SPIRV_MAGIC)
+        {
+            spirv.clear();
+        }
+    }
+
+    const bool cacheHit = !spirv.empty();
+    if (!cacheHit)
+    {
+        {
+            std::lock_guard lock(slangMutex_);
+            spirv = compileWithSlang(moduleName, sourcePath, constants);
+        }
+
+        if (!spirv.empty())
+        {
+            // Write to a temporary file and rename, so a concurrent reader never sees a partial entry
+            std::error_code ec;
+            std::filesystem::create_directories(cacheDir_, ec);
+            auto tmpPath = cachePath;
+            tmpPath += std::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            {
+                std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<const char*>(spirv.data()),
+                           static_cast<std::streamsize>(spirv.size() * sizeof(uint32_t)));
+            }
+            std::filesystem::rename(tmpPath, cachePath, ec);
+            if (ec)
+            {
+                std::cerr << "Failed to write shader cache entry " << cachePath << ": " << ec.message() << "\n";
+            }
+        }
+    }
+
+    const double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    {
+        std::lock_guard lock(statsMutex_);
+        (cacheHit ? stats_.cacheHits : stats_.cacheMisses)++;
+        stats_.totalMs += elapsedMs;
+    }
+
+    return spirv;
+}
+
+ShaderCompiler::Stats ShaderCompiler::stats() const
+{
+    std::lock_guard lock(statsMutex_);
+    return stats_;
+}
+
+std::vector<std::filesystem::path> ShaderCompiler::sourceFiles(const std::filesystem::path& sourcePath)
+{
+    // The cache key walks exactly the files a change has to invalidate
+    std::set<std::filesystem::path> visited;
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hashSourceTree(sourcePath, visited, hash);
+    return { visited.begin(), visited.end() };
+}
+
+Slang::ComPtr<slang::ISession> ShaderCompiler::createSession()
+{
+    if (!globalSession_)
+    {
+        // Connect with the Slang API
+        slang::createGlobalSession(globalSession_.writeRef());
+    }
+
+    slang::TargetDesc target_desc {
+        .format = SLANG_SPIRV,
+        .profile = globalSession_->findProfile(SPIRV_PROFILE)
+    };
+
+    std::array<slang::CompilerOptionEntry, 1> options = {
+        {
+            slang::CompilerOptionName::EmitSpirvDirectly,
+            {slang::CompilerOptionValueKind::Int, EMIT_SPIRV_DIRECTLY, 0, nullptr, nullptr}
+        }
+    };
+
+    slang::SessionDesc sessionDesc {
+        .targets = &target_desc,
+        .targetCount = 1,
+        .defaultMatrixLayoutMode = MATRIX_LAYOUT,
+        .compilerOptionEntries = options.data(),
+        .compilerOptionEntryCount = static_cast<uint32_t>(options.size()),
+    };
+
+    Slang::ComPtr<slang::ISession> session;
+    globalSession_->createSession(sessionDesc, session.writeRef());
+
+    return session;
+}
+
+std::vector<uint32_t> ShaderCompiler::compileWithSlang(const std::string& moduleName, const std::filesystem::path& sourcePath,
+                                                      const std::vector<LinkConstant>& constants)
+{
+    SPECTRA_TRACE_SCOPE("Slang compile");
+    Slang::ComPtr<slang::ISession> session = createSession();
+
+    Slang::ComPtr<slang::IBlob> diagnostics;
+    Slang::ComPtr<slang::IModule> slangModule(
+        session->loadModuleFromSource(moduleName.c_str(), sourcePath.generic_string().c_str(), nullptr, diagnostics.writeRef()));
+    if (diagnostics)
+    {
+        std::cerr << static_cast<const char*>(diagnostics->getBufferPointer()) << "\n";
+    }
+    if (!slangModule)
+    {
+        std::cerr << "Failed to load shader module " << sourcePath << "\n";
+        return {};
+    }
+
+    // A linked program only contains the entry points it was composed with
+    std::vector<Slang::ComPtr<slang::IEntryPoint>> entryPoints(slangModule->getDefinedEntryPointCount());
+    std::vector<slang::IComponentType*> components = { slangModule };
+    for (size_t i = 0; i < entryPoints.size(); i++)
+    {
+        slangModule->getDefinedEntryPoint(static_cast<SlangInt32>(i), entryPoints[i].writeRef());
+        components.push_back(entryPoints[i]);
+    }
+
+    // The constants are exported by a generated module, linking resolves the module's extern declarations to them
+    Slang::ComPtr<slang::IModule> constantsModule;
+    if (!constants.empty())
+    {
+        std::string constantsSource;
+        for (const LinkConstant& constant : constants)
+        {
+            constantsSource += std::format("export static const int {} = {};\n", constant.name, constant.value);
+        }
+        const std::string constantsName = moduleName + "_constants";
+        constantsModule = session->loadModuleFromSourceString(constantsName.c_str(), (constantsName + ".slang").c_str(),
+                                                              constantsSource.c_str(), diagnostics.writeRef());
+        if (!constantsModule)
+        {
+            std::cerr << "Failed to load the link constants of " << sourcePath << "\n";
+            return {};
+        }
+        components.push_back(constantsModule);
+    }
+
+    Slang::ComPtr<slang::IComponentType> composite;
+    Slang::ComPtr<slang::IComponentType> program;
+    Slang::ComPtr<ISlangBlob> code;
+    if (SLANG_FAILED(session->createCompositeComponentType(components.data(), static_cast<SlangInt>(components.size()),
+                                                           composite.writeRef(), diagnostics.writeRef())) ||
+        SLANG_FAILED(composite->link(program.writeRef(), diagnostics.writeRef())) ||
+        SLANG_FAILED(program->getTargetCode(0, code.writeRef(), diagnostics.writeRef())) || !code)
+    {
+        if (diagnostics)
+        {
+            std::cerr << static_cast<const char*>(diagnostics->getBufferPointer()) << "\n";
+        }
+        std::cerr << "Failed to generate SPIR-V for " << sourcePath << "\n";
+        return {};
+    }
+
+    std::vector<uint32_t> spirv(code->getBufferSize() / sizeof(uint32_t));
+    memcpy(spirv.data(), code->getBufferPointer(), spirv.size() * sizeof(uint32_t));
+    return spirv;
+}
+
+uint64_t ShaderCompiler::computeCacheKey(const std::filesystem::path& sourcePath, const std::vector<LinkConstant>& constants)
+{
+    uint64_t hash = fnv1a(&CACHE_VERSION, sizeof(CACHE_VERSION));
+
+    // The compiler version matters too, a Slang upgrade must not serve stale code
+    hash = fnv1a(std::string(spGetBuildTagString()), hash);
+    hash = fnv1a(std::format("profile={};emitSpirvDirectly={};matrixLayout={}",
+                             SPIRV_PROFILE, EMIT_SPIRV_DIRECTLY, static_cast<int>(MATRIX_LAYOUT)), hash);
+
+    for (const LinkConstant& constant : constants)
+    {
+        hash = fnv1a(std::format("{}={};", constant.name, constant.value), hash);
+    }
+
+    std::set<std::filesystem::path> visited;
+    hashSourceTree(sourcePath, visited, hash);
+
+    return hash;
+}
+} // spectra
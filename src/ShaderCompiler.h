@@ -0,0 +1,65 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_SHADERCOMPILER_H
+#define SPECTRA_SHADERCOMPILER_H
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <slang/slang-com-ptr.h>
+#include <slang/slang.h>
+
+namespace spectra {
+// Compiles Slang modules to SPIR-V through a content-addressed on-disk cache. The Slang global session is only
+// created on the first cache miss, so a fully cached start never touches the compiler. Safe to call from multiple
+// threads; cache lookups run in parallel while Slang compiles are serialized on the global session.
+class ShaderCompiler {
+public:
+    struct Stats
+    {
+        uint32_t cacheHits = 0;
+        uint32_t cacheMisses = 0;
+        double totalMs = 0.0; // Wall time spent in compile(), including cache lookups
+    };
+
+    // Value of an `extern static const int` the module declares. It is linked in before code generation, so Slang
+    // removes the branches it disables instead of leaving them to the driver.
+    struct LinkConstant
+    {
+        std::string name;
+        int value = 0;
+    };
+
+    explicit ShaderCompiler(std::filesystem::path cacheDir = ".spectra-cache/spirv");
+
+    // Returns the SPIR-V of every entry point in the module, empty on failure
+    std::vector<uint32_t> compile(const std::string& moduleName, const std::filesystem::path& sourcePath,
+                                  const std::vector<LinkConstant>& constants = {});
+
+    [[nodiscard]] Stats stats() const;
+
+    // Canonical paths of the source and every file it transitively imports, as far as they resolve
+    static std::vector<std::filesystem::path> sourceFiles(const std::filesystem::path& sourcePath);
+
+private:
+    Slang::ComPtr<slang::ISession> createSession();
+    std::vector<uint32_t> compileWithSlang(const std::string& moduleName, const std::filesystem::path& sourcePath,
+                                           const std::vector<LinkConstant>& constants);
+
+    // Hash of the source, its transitive imports, the link constants, the target profile and compiler options
+    static uint64_t computeCacheKey(const std::filesystem::path& sourcePath, const std::vector<LinkConstant>& constants);
+
+    std::filesystem::path cacheDir_;
+    Slang::ComPtr<slang::IGlobalSession> globalSession_{};
+    std::mutex slangMutex_;
+
+    mutable std::mutex statsMutex_;
+    Stats stats_{};
+};
+} // spectra
+
+#endif //SPECTRA_SHADERCOMPILER_H
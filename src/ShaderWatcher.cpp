@@ -0,0 +1,174 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "ShaderWatcher.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <format>
+#include <iostream>
+
+#ifdef __linux__
+#include <poll.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#endif
+
+#include "Trace.h"
+
+namespace spectra {
+ShaderWatcher::ShaderWatcher(std::filesystem::path directory, std::chrono::milliseconds settleTime)
+    : directory_(std::move(directory)), settleTime_(settleTime)
+{
+#ifdef __linux__
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (inotifyFd_ < 0 || wakeFd_ < 0)
+    {
+        std::cerr << std::format("Shader hot reload disabled, inotify is unavailable: {}\n", std::strerror(errno));
+        return;
+    }
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory_, error))
+    {
+        std::cerr << std::format("Shader hot reload disabled, {} is not a directory\n", directory_.generic_string());
+        return;
+    }
+    watchTree(directory_);
+
+    thread_ = std::thread([this] { run(); });
+    std::clog << std::format("Watching {} for shader changes\n", directory_.generic_string());
+#else
+    std::clog << "Shader hot reload is only supported on Linux\n";
+#endif
+}
+
+ShaderWatcher::~ShaderWatcher()
+{
+#ifdef __linux__
+    if (thread_.joinable())
+    {
+        const uint64_t wake = 1;
+        [[maybe_unused]] const ssize_t written = write(wakeFd_, &wake, sizeof(wake));
+        thread_.join();
+    }
+    if (inotifyFd_ >= 0)
+    {
+        close(inotifyFd_);
+    }
+    if (wakeFd_ >= 0)
+    {
+        close(wakeFd_);
+    }
+#endif
+}
+
+std::vector<std::filesystem::path> ShaderWatcher::takeChanges()
+{
+    const auto settled = std::chrono::steady_clock::now() - settleTime_;
+
+    std::vector<std::filesystem::path> changes;
+    std::lock_guard lock(mutex_);
+    for (auto it = pending_.begin(); it != pending_.end();)
+    {
+        if (it->second <= settled)
+        {
+            changes.push_back(std::filesystem::weakly_canonical(it->first));
+            it = pending_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    return changes;
+}
+
+void ShaderWatcher::watchTree(const std::filesystem::path& directory)
+{
+#ifdef __linux__
+    // Saves that replace the file (write to a temporary, then rename) arrive as IN_MOVED_TO
+    constexpr uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_ONLYDIR;
+    const int wd = inotify_add_watch(inotifyFd_, directory.c_str(), mask);
+    if (wd < 0)
+    {
+        std::cerr << std::format("Failed to watch {}: {}\n", directory.generic_string(), std::strerror(errno));
+        return;
+    }
+    watches_[wd] = directory;
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+    {
+        if (entry.is_directory(error))
+        {
+            watchTree(entry.path());
+        }
+    }
+#endif
+}
+
+void ShaderWatcher::run()
+{
+#ifdef __linux__
+    SPECTRA_TRACE_THREAD("Shader watcher");
+
+    // Large enough for a burst of events, each one is followed by its file name
+    alignas(inotify_event) std::array<char, 16 * 1024> buffer{};
+    std::array<pollfd, 2> fds = { { { inotifyFd_, POLLIN, 0 }, { wakeFd_, POLLIN, 0 } } };
+    while (true)
+    {
+        if (poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << std::format("Shader watcher stopped: {}\n", std::strerror(errno));
+            return;
+        }
+        if (fds[1].revents & POLLIN)
+        {
+            return;
+        }
+
+        ssize_t length = 0;
+        while ((length = read(inotifyFd_, buffer.data(), buffer.size())) > 0)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const auto* pEvent = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + pEvent->len);
+
+                const auto watch = watches_.find(pEvent->wd);
+                if (pEvent->len == 0 || watch == watches_.end())
+                {
+                    continue;
+                }
+                const std::filesystem::path path = watch->second / pEvent->name;
+                if (pEvent->mask & IN_ISDIR)
+                {
+                    // Only the watcher thread touches the watches once it runs
+                    if (pEvent->mask & (IN_CREATE | IN_MOVED_TO))
+                    {
+                        watchTree(path);
+                    }
+                    continue;
+                }
+                // IN_CREATE alone is followed by IN_CLOSE_WRITE once the file has been written
+                if (path.extension() == ".slang" && (pEvent->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)))
+                {
+                    std::lock_guard lock(mutex_);
+                    pending_[path] = now;
+                }
+            }
+        }
+    }
+#endif
+}
+} // spectra
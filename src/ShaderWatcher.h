@@ -0,0 +1,49 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_SHADERWATCHER_H
+#define SPECTRA_SHADERWATCHER_H
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace spectra {
+// Watches a shader directory and its subdirectories for written Slang files on a background thread, using inotify
+// on Linux. Editors often save in several steps, so a file is only reported once it has been quiet for the settle
+// time. Elsewhere the watcher is inactive and never reports anything.
+class ShaderWatcher {
+public:
+    explicit ShaderWatcher(std::filesystem::path directory,
+                           std::chrono::milliseconds settleTime = std::chrono::milliseconds(100));
+    ~ShaderWatcher();
+
+    ShaderWatcher(const ShaderWatcher&) = delete;
+    ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+    // Canonical paths of the files that changed and settled since the last call, never blocks
+    std::vector<std::filesystem::path> takeChanges();
+
+    [[nodiscard]] bool active() const { return thread_.joinable(); }
+
+private:
+    void watchTree(const std::filesystem::path& directory);
+    void run();
+
+    std::filesystem::path directory_;
+    std::chrono::milliseconds settleTime_;
+    int inotifyFd_ = -1;
+    int wakeFd_ = -1; // Signaled to stop the thread
+    std::map<int, std::filesystem::path> watches_; // Watch descriptor to directory
+    std::thread thread_;
+
+    std::mutex mutex_;
+    std::map<std::filesystem::path, std::chrono::steady_clock::time_point> pending_; // Last write per file
+};
+} // spectra
+
+#endif //SPECTRA_SHADERWATCHER_H
@@ -0,0 +1,542 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "TextureStreamer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <ktx.h>
+#include <stb_image.h>
+
+#include "vk/Error.h"
+
+namespace spectra {
+namespace {
+constexpr std::array<uint8_t, 12> KTX2_IDENTIFIER = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+// Largest dimension of the level a texture starts with
+constexpr uint32_t BASE_LEVEL_SIZE = 64;
+// Upload volume of the residency changes started per update, bounds the transfer work added to one frame
+constexpr VkDeviceSize UPDATE_UPLOAD_BYTES = 16ULL << 20;
+
+// Texel block height, 0 for formats the streamer cannot upload. Block compressed formats up to ASTC 4x4 in
+// VkFormat order (BC, ETC2/EAC, ASTC 4x4) all use 4x4 blocks.
+uint32_t formatBlockHeight(VkFormat format)
+{
+    if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_ASTC_4x4_SRGB_BLOCK)
+    {
+        return 4;
+    }
+    if (format > VK_FORMAT_ASTC_4x4_SRGB_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK)
+    {
+        return 0;
+    }
+    return 1;
+}
+
+void destroyKtx(ktxTexture2* pTexture)
+{
+    ktxTexture2_Destroy(pTexture);
+}
+}
+
+TextureStreamer::TextureStreamer(std::shared_ptr<vk::Context> pCtx, VmaAllocator allocator, UploadManager& uploadManager,
+                                 BindlessHeap& bindlessHeap, uint32_t frameCount, VkDeviceSize budgetBytes)
+    : pCtx_(std::move(pCtx)), device_(pCtx_->device), allocator_(allocator), uploadManager_(uploadManager),
+      bindlessHeap_(bindlessHeap), frameCount_(frameCount), budgetBytes_(budgetBytes)
+{
+    if (supportsFormat(VK_FORMAT_BC7_SRGB_BLOCK))
+    {
+        transcodeTarget_ = TranscodeTarget::Bc7;
+    }
+    else if (supportsFormat(VK_FORMAT_ASTC_4x4_SRGB_BLOCK))
+    {
+        transcodeTarget_ = TranscodeTarget::Astc4x4;
+    }
+    else if (supportsFormat(VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK))
+    {
+        transcodeTarget_ = TranscodeTarget::Etc2;
+    }
+    std::clog << std::format("Texture streamer: Basis Universal transcodes to {}\n", transcodeTargetName());
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    clear();
+}
+
+uint32_t TextureStreamer::addImage(std::span<const uint8_t> encoded, bool srgb)
+{
+    Texture texture;
+    if (!(isKtx2(encoded) ? loadKtx2(encoded, texture) : decodeImage(encoded, srgb, texture)))
+    {
+        return INVALID_TEXTURE;
+    }
+
+    const auto index = static_cast<uint32_t>(textures_.size());
+    texture.wantedLevel = baseLevel(texture);
+    textures_.push_back(std::move(texture));
+    slots_.push_back(BindlessHeap::INVALID_HANDLE);
+
+    startResidency(index, textures_.back().wantedLevel);
+    return index;
+}
+
+void TextureStreamer::clear()
+{
+    // Queued copies may still target the images, they have to land before anything is destroyed
+    uploadManager_.wait(uploadManager_.flush());
+    unsubmitted_.clear();
+
+    for (Texture& texture : textures_)
+    {
+        for (auto* pResidency : { &texture.current, &texture.pending })
+        {
+            if (*pResidency)
+            {
+                bindlessHeap_.release(BindlessHeap::Kind::SampledImage, (*pResidency)->slot);
+                destroy(**pResidency);
+            }
+        }
+    }
+    for (RetiredImage& retired : retired_)
+    {
+        destroy(retired.residency);
+    }
+
+    textures_.clear();
+    slots_.clear();
+    retired_.clear();
+    residentBytes_ = 0;
+}
+
+void TextureStreamer::request(uint32_t texture, float pixels)
+{
+    if (texture < textures_.size())
+    {
+        textures_[texture].requestedPixels = std::max(textures_[texture].requestedPixels, pixels);
+    }
+}
+
+void TextureStreamer::commitRequests()
+{
+    for (Texture& texture : textures_)
+    {
+        // Textures nobody reported fall back to their base level. Otherwise a texel per pixel is enough, assuming
+        // the texture is mapped once across the surface.
+        const uint32_t coarsest = baseLevel(texture);
+        if (texture.requestedPixels < 1.0f)
+        {
+            texture.wantedLevel = coarsest;
+        }
+        else
+        {
+            const auto texels = static_cast<float>(std::max(texture.levels[0].width, texture.levels[0].height));
+            const float level = std::floor(std::log2(texels / texture.requestedPixels));
+            texture.wantedLevel = static_cast<uint32_t>(std::clamp(level, 0.0f, static_cast<float>(coarsest)));
+        }
+        texture.requestedPixels = 0.0f;
+    }
+}
+
+void TextureStreamer::update()
+{
+    frameNumber_++;
+
+    // Finished uploads replace the current image from this frame on
+    for (uint32_t i = 0; i < textures_.size(); i++)
+    {
+        Texture& texture = textures_[i];
+        if (!texture.pending || texture.pending->uploadValue == 0 ||
+            !uploadManager_.isAvailable(texture.pending->uploadValue))
+        {
+            continue;
+        }
+
+        texture.pending->slot = bindlessHeap_.registerImage(texture.pending->view);
+        if (texture.current)
+        {
+            retire(*texture.current);
+        }
+        texture.current = texture.pending;
+        texture.pending.reset();
+        slots_[i] = texture.current->slot;
+    }
+
+    const auto freed = std::ranges::remove_if(retired_, [this](RetiredImage& retired)
+    {
+        if (retired.freeFrame > frameNumber_)
+        {
+            return false;
+        }
+        destroy(retired.residency);
+        return true;
+    });
+    retired_.erase(freed.begin(), freed.end());
+
+    // Detail that is no longer wanted is given back first, dropping to a coarser tail is a small upload
+    for (uint32_t i = 0; i < textures_.size(); i++)
+    {
+        const Texture& texture = textures_[i];
+        if (!texture.pending && texture.current && texture.current->firstLevel < texture.wantedLevel)
+        {
+            startResidency(i, texture.wantedLevel);
+        }
+    }
+
+    // Still over budget, e.g. after lowering it: the textures holding the most memory lose their finest level
+    while (residentBytes_ > budgetBytes_)
+    {
+        uint32_t largest = INVALID_TEXTURE;
+        for (uint32_t i = 0; i < textures_.size(); i++)
+        {
+            const Texture& texture = textures_[i];
+            if (!texture.pending && texture.current && texture.current->firstLevel < baseLevel(texture) &&
+                (largest == INVALID_TEXTURE || texture.current->bytes > textures_[largest].current->bytes))
+            {
+                largest = i;
+            }
+        }
+        if (largest == INVALID_TEXTURE)
+        {
+            break;
+        }
+        startResidency(largest, textures_[largest].current->firstLevel + 1);
+    }
+
+    // Refine one level at a time, the textures furthest from the detail they are seen at go first
+    std::vector<uint32_t> candidates;
+    for (uint32_t i = 0; i < textures_.size(); i++)
+    {
+        const Texture& texture = textures_[i];
+        if (!texture.pending && texture.current && texture.current->firstLevel > texture.wantedLevel)
+        {
+            candidates.push_back(i);
+        }
+    }
+    std::ranges::sort(candidates, std::greater{}, [this](uint32_t i)
+    {
+        return textures_[i].current->firstLevel - textures_[i].wantedLevel;
+    });
+
+    VkDeviceSize uploadBytes = 0;
+    for (const uint32_t i : candidates)
+    {
+        const Texture& texture = textures_[i];
+        const uint32_t firstLevel = texture.current->firstLevel - 1;
+        const VkDeviceSize bytes = residencyBytes(texture, firstLevel);
+        if (residentBytes_ - texture.current->bytes + bytes > budgetBytes_)
+        {
+            continue;
+        }
+        if (uploadBytes > 0 && uploadBytes + bytes > UPDATE_UPLOAD_BYTES)
+        {
+            break;
+        }
+        startResidency(i, firstLevel);
+        uploadBytes += bytes;
+    }
+
+    // Everything started since the last update goes out in one submission
+    if (!unsubmitted_.empty())
+    {
+        const uint64_t uploadValue = uploadManager_.flush();
+        for (const uint32_t i : unsubmitted_)
+        {
+            textures_[i].pending->uploadValue = uploadValue;
+        }
+        unsubmitted_.clear();
+    }
+}
+
+TextureStreamer::Stats TextureStreamer::stats() const
+{
+    Stats stats {
+        .textures = static_cast<uint32_t>(textures_.size()),
+        .residentBytes = residentBytes_,
+        .budgetBytes = budgetBytes_,
+    };
+    for (const Texture& texture : textures_)
+    {
+        stats.streaming += texture.pending.has_value();
+        stats.fullBytes += residencyBytes(texture, 0);
+    }
+    return stats;
+}
+
+const char* TextureStreamer::transcodeTargetName() const
+{
+    switch (transcodeTarget_)
+    {
+    case TranscodeTarget::Bc7:
+        return "BC7";
+    case TranscodeTarget::Astc4x4:
+        return "ASTC 4x4";
+    case TranscodeTarget::Etc2:
+        return "ETC2";
+    case TranscodeTarget::Rgba8:
+        return "RGBA8";
+    }
+    return "unknown";
+}
+
+bool TextureStreamer::supportsFormat(VkFormat format) const
+{
+    // Block compressed families are device features, the format properties do not reflect whether they are enabled
+    const VkPhysicalDeviceFeatures& features = pCtx_->enabledFeatures;
+    if ((format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_BC7_SRGB_BLOCK && !features.textureCompressionBC) ||
+        (format >= VK_FORMAT_ETC2_R8G8B8_UNORM_BLOCK && format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK &&
+         !features.textureCompressionETC2) ||
+        (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK &&
+         !features.textureCompressionASTC_LDR) ||
+        formatBlockHeight(format) == 0)
+    {
+        return false;
+    }
+
+    VkFormatProperties properties{};
+    vkGetPhysicalDeviceFormatProperties(pCtx_->physicalDevice, format, &properties);
+    constexpr VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+    return (properties.optimalTilingFeatures & required) == required;
+}
+
+bool TextureStreamer::loadKtx2(std::span<const uint8_t> encoded, Texture& texture) const
+{
+    ktxTexture2* pKtxRaw = nullptr;
+    const ktx_error_code_e result = ktxTexture2_CreateFromMemory(encoded.data(), encoded.size(),
+                                                                 KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &pKtxRaw);
+    if (result != KTX_SUCCESS)
+    {
+        std::cerr << std::format("Failed to read KTX2 texture: {}\n", ktxErrorString(result));
+        return false;
+    }
+    const std::unique_ptr<ktxTexture2, decltype(&destroyKtx)> pKtx(pKtxRaw, &destroyKtx);
+
+    if (pKtx->numDimensions != 2 || pKtx->isArray || pKtx->isCubemap)
+    {
+        std::cerr << "Skipping KTX2 texture: only single 2D images are supported\n";
+        return false;
+    }
+
+    if (ktxTexture2_NeedsTranscoding(pKtx.get()))
+    {
+        constexpr std::array TARGET_FORMATS = {
+            KTX_TTF_BC7_RGBA, KTX_TTF_ASTC_4x4_RGBA, KTX_TTF_ETC2_RGBA, KTX_TTF_RGBA32,
+        };
+        const ktx_error_code_e transcodeResult = ktxTexture2_TranscodeBasis(
+            pKtx.get(), TARGET_FORMATS[static_cast<uint32_t>(transcodeTarget_)], 0);
+        if (transcodeResult != KTX_SUCCESS)
+        {
+            std::cerr << std::format("Failed to transcode KTX2 texture: {}\n", ktxErrorString(transcodeResult));
+            return false;
+        }
+    }
+
+    // Transcoding picks the sRGB variant itself from the transfer function in the file
+    texture.format = static_cast<VkFormat>(pKtx->vkFormat);
+    if (!supportsFormat(texture.format))
+    {
+        std::cerr << std::format("Skipping KTX2 texture: format {} is not supported by the device\n",
+                                 static_cast<uint32_t>(texture.format));
+        return false;
+    }
+    texture.blockHeight = formatBlockHeight(texture.format);
+
+    ktxTexture* pBase = ktxTexture(pKtx.get());
+    const uint8_t* pData = ktxTexture_GetData(pBase);
+    texture.data.assign(pData, pData + ktxTexture_GetDataSize(pBase));
+    for (uint32_t level = 0; level < pKtx->numLevels; level++)
+    {
+        ktx_size_t offset = 0;
+        ktxTexture_GetImageOffset(pBase, level, 0, 0, &offset);
+        texture.levels.push_back({
+            .offset = offset,
+            .size = ktxTexture_GetImageSize(pBase, level),
+            .width = std::max(pKtx->baseWidth >> level, 1U),
+            .height = std::max(pKtx->baseHeight >> level, 1U),
+        });
+    }
+
+    // Staging offsets are 16-byte aligned, which has to be a multiple of the texel size of uncompressed formats
+    if (texture.blockHeight == 1)
+    {
+        const Level& top = texture.levels.front();
+        const VkDeviceSize texelSize = top.size / (static_cast<VkDeviceSize>(top.width) * top.height);
+        if (texelSize == 0 || 16 % texelSize != 0)
+        {
+            std::cerr << std::format("Skipping KTX2 texture: {}-byte texels are not supported\n", texelSize);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TextureStreamer::decodeImage(std::span<const uint8_t> encoded, bool srgb, Texture& texture) const
+{
+    if (!decodeRgba8(encoded, texture.data, texture.levels))
+    {
+        return false;
+    }
+    texture.format = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    return true;
+}
+
+bool TextureStreamer::isKtx2(std::span<const uint8_t> encoded)
+{
+    return encoded.size() >= KTX2_IDENTIFIER.size() &&
+           std::equal(KTX2_IDENTIFIER.begin(), KTX2_IDENTIFIER.end(), encoded.begin());
+}
+
+bool TextureStreamer::decodeRgba8(std::span<const uint8_t> encoded, std::vector<uint8_t>& data,
+                                  std::vector<Level>& levels)
+{
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    stbi_uc* pPixels = stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height,
+                                             &channels, STBI_rgb_alpha);
+    if (pPixels == nullptr)
+    {
+        std::cerr << std::format("Failed to decode image: {}\n", stbi_failure_reason());
+        return false;
+    }
+
+    levels.assign(1, {
+        .size = static_cast<VkDeviceSize>(width) * height * 4,
+        .width = static_cast<uint32_t>(width),
+        .height = static_cast<uint32_t>(height),
+    });
+    data.assign(pPixels, pPixels + levels[0].size);
+    stbi_image_free(pPixels);
+
+    // Box filter, averaged in the stored encoding. Coarse levels only stand in until the detailed ones stream in.
+    while (levels.back().width > 1 || levels.back().height > 1)
+    {
+        const Level source = levels.back();
+        const Level level {
+            .offset = data.size(),
+            .size = static_cast<VkDeviceSize>(std::max(source.width / 2, 1U)) * std::max(source.height / 2, 1U) * 4,
+            .width = std::max(source.width / 2, 1U),
+            .height = std::max(source.height / 2, 1U),
+        };
+        data.resize(data.size() + level.size);
+
+        const uint8_t* pSource = data.data() + source.offset;
+        uint8_t* pLevel = data.data() + level.offset;
+        for (uint32_t y = 0; y < level.height; y++)
+        {
+            const uint32_t y0 = std::min(y * 2, source.height - 1);
+            const uint32_t y1 = std::min(y * 2 + 1, source.height - 1);
+            for (uint32_t x = 0; x < level.width; x++)
+            {
+                const uint32_t x0 = std::min(x * 2, source.width - 1);
+                const uint32_t x1 = std::min(x * 2 + 1, source.width - 1);
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    const uint32_t sum = pSource[(y0 * source.width + x0) * 4 + c] +
+                                         pSource[(y0 * source.width + x1) * 4 + c] +
+                                         pSource[(y1 * source.width + x0) * 4 + c] +
+                                         pSource[(y1 * source.width + x1) * 4 + c];
+                    pLevel[(y * level.width + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        levels.push_back(level);
+    }
+    return true;
+}
+
+uint32_t TextureStreamer::baseLevel(const Texture& texture)
+{
+    for (uint32_t level = 0; level < texture.levels.size(); level++)
+    {
+        if (std::max(texture.levels[level].width, texture.levels[level].height) <= BASE_LEVEL_SIZE)
+        {
+            return level;
+        }
+    }
+    return static_cast<uint32_t>(texture.levels.size()) - 1;
+}
+
+VkDeviceSize TextureStreamer::residencyBytes(const Texture& texture, uint32_t firstLevel)
+{
+    VkDeviceSize bytes = 0;
+    for (uint32_t level = firstLevel; level < texture.levels.size(); level++)
+    {
+        bytes += texture.levels[level].size;
+    }
+    return bytes;
+}
+
+void TextureStreamer::startResidency(uint32_t index, uint32_t firstLevel)
+{
+    Texture& texture = textures_[index];
+    const Level& top = texture.levels[firstLevel];
+    const auto levelCount = static_cast<uint32_t>(texture.levels.size()) - firstLevel;
+
+    Residency residency {
+        .firstLevel = firstLevel,
+        .bytes = residencyBytes(texture, firstLevel),
+    };
+
+    const VkImageCreateInfo imageCreateInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = texture.format,
+        .extent = { top.width, top.height, 1 },
+        .mipLevels = levelCount,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+    const VmaAllocationCreateInfo allocCreateInfo
+    {
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+    };
+    CHECK_VK(vmaCreateImage(allocator_, &imageCreateInfo, &allocCreateInfo, &residency.image, &residency.alloc, nullptr))
+
+    const VkImageViewCreateInfo viewCreateInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = residency.image,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = texture.format,
+        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, levelCount, 0, 1 },
+    };
+    CHECK_VK(vkCreateImageView(device_, &viewCreateInfo, nullptr, &residency.view))
+
+    std::vector<UploadManager::ImageLevel> levels;
+    for (uint32_t level = firstLevel; level < texture.levels.size(); level++)
+    {
+        const Level& source = texture.levels[level];
+        levels.push_back({ texture.data.data() + source.offset, source.size, source.width, source.height });
+    }
+    uploadManager_.uploadImage(residency.image, levels, texture.blockHeight);
+
+    residentBytes_ = residentBytes_ - (texture.current ? texture.current->bytes : 0) + residency.bytes;
+    texture.pending = residency;
+    unsubmitted_.push_back(index);
+}
+
+void TextureStreamer::retire(Residency& residency)
+{
+    // Frames recorded before this one may still sample it
+    bindlessHeap_.release(BindlessHeap::Kind::SampledImage, residency.slot);
+    retired_.push_back({ residency, frameNumber_ + frameCount_ - 1 });
+}
+
+void TextureStreamer::destroy(Residency& residency) const
+{
+    vkDestroyImageView(device_, residency.view, nullptr);
+    vmaDestroyImage(allocator_, residency.image, residency.alloc);
+    residency = {};
+}
+} // spectra
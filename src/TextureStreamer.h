@@ -0,0 +1,153 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_TEXTURESTREAMER_H
+#define SPECTRA_TEXTURESTREAMER_H
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+#include <vk_mem_alloc.h>
+
+#include "BindlessHeap.h"
+#include "UploadManager.h"
+#include "vk/Context.h"
+
+namespace spectra {
+// Keeps sampled textures resident at the detail they are seen at. KTX2 files are read with libktx, Basis Universal
+// payloads (KHR_texture_basisu) are transcoded once at load to the best block format the device samples: BC7, then
+// ASTC 4x4, then ETC2, with uncompressed RGBA8 as the last resort. PNG and JPEG images are decoded to RGBA8 with a
+// box-filtered mip chain. The CPU copy of every level is kept; the GPU holds a contiguous tail of the mip chain.
+//
+// A texture starts with only its smallest mips resident. Callers report the on-screen size of each texture and the
+// streamer refines residency one level at a time, largest deficit first, within a memory budget, evicting detail
+// that is no longer needed when over it. Changing residency uploads the new tail into a new image; the old image
+// keeps serving frames until the upload has landed and is freed once no frame in flight can sample it. Shaders
+// reach a texture through its bindless slot in slots(), which changes whenever its residency does. Not thread safe.
+class TextureStreamer {
+public:
+    static constexpr uint32_t INVALID_TEXTURE = ~0U;
+
+    struct Stats
+    {
+        uint32_t textures = 0;
+        uint32_t streaming = 0;        // Residency changes still uploading
+        VkDeviceSize residentBytes = 0; // Including uploads in flight
+        VkDeviceSize fullBytes = 0;     // With every level of every texture resident
+        VkDeviceSize budgetBytes = 0;
+    };
+
+    struct Level
+    {
+        size_t offset = 0; // Into the texture data
+        VkDeviceSize size = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    TextureStreamer(std::shared_ptr<vk::Context> pCtx, VmaAllocator allocator, UploadManager& uploadManager,
+                    BindlessHeap& bindlessHeap, uint32_t frameCount, VkDeviceSize budgetBytes = 256ULL << 20);
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Decodes or transcodes an encoded image, KTX2 is recognized by its identifier. Color textures use sRGB formats
+    // where the source does not say otherwise. Returns INVALID_TEXTURE when the image cannot be used.
+    uint32_t addImage(std::span<const uint8_t> encoded, bool srgb = true);
+    // Destroys every texture, the device must be idle
+    void clear();
+
+    // Reports that a texture covers about `pixels` pixels across on screen. The largest report since the last
+    // commitRequests() sets the mip level the texture should have resident.
+    void request(uint32_t texture, float pixels);
+    void commitRequests();
+
+    // Publishes finished uploads, frees retired images and starts new residency changes. Call once per frame
+    // after the frame slot wait.
+    void update();
+
+    // Bindless image slot per texture, BindlessHeap::INVALID_HANDLE until its first levels are resident
+    [[nodiscard]] std::span<const uint32_t> slots() const { return slots_; }
+
+    void setBudget(VkDeviceSize budgetBytes) { budgetBytes_ = budgetBytes; }
+    [[nodiscard]] Stats stats() const;
+    [[nodiscard]] const char* transcodeTargetName() const;
+
+    // Whether the data starts with the KTX2 file identifier
+    static bool isKtx2(std::span<const uint8_t> encoded);
+    // Decodes a PNG or JPEG image to RGBA8 followed by a box-filtered mip chain, level 0 first. Also used offline by
+    // spectra-cook.
+    static bool decodeRgba8(std::span<const uint8_t> encoded, std::vector<uint8_t>& data, std::vector<Level>& levels);
+
+private:
+    struct Residency
+    {
+        VkImage image = VK_NULL_HANDLE;
+        VmaAllocation alloc{};
+        VkImageView view = VK_NULL_HANDLE;
+        uint32_t slot = BindlessHeap::INVALID_HANDLE;
+        uint32_t firstLevel = 0; // The image holds levels [firstLevel, levels.size())
+        VkDeviceSize bytes = 0;
+        uint64_t uploadValue = 0;
+    };
+
+    struct Texture
+    {
+        VkFormat format = VK_FORMAT_UNDEFINED;
+        uint32_t blockHeight = 1;
+        std::vector<uint8_t> data;
+        std::vector<Level> levels; // Level 0 is the largest
+        std::optional<Residency> current;
+        std::optional<Residency> pending;
+        uint32_t wantedLevel = 0;
+        float requestedPixels = 0.0f;
+    };
+
+    struct RetiredImage
+    {
+        Residency residency;
+        uint64_t freeFrame = 0; // First frame number at which no submitted frame can still sample it
+    };
+
+    enum class TranscodeTarget
+    {
+        Bc7,
+        Astc4x4,
+        Etc2,
+        Rgba8,
+    };
+
+    bool supportsFormat(VkFormat format) const;
+    bool loadKtx2(std::span<const uint8_t> encoded, Texture& texture) const;
+    bool decodeImage(std::span<const uint8_t> encoded, bool srgb, Texture& texture) const;
+    // Coarsest level a texture starts with, and the finest one eviction goes back to
+    static uint32_t baseLevel(const Texture& texture);
+    static VkDeviceSize residencyBytes(const Texture& texture, uint32_t firstLevel);
+    // Queues the upload of a new image holding the levels from firstLevel on, submitted by the next update()
+    void startResidency(uint32_t index, uint32_t firstLevel);
+    void retire(Residency& residency);
+    void destroy(Residency& residency) const;
+
+    std::shared_ptr<vk::Context> pCtx_;
+    VkDevice device_ = VK_NULL_HANDLE;
+    VmaAllocator allocator_ = VK_NULL_HANDLE;
+    UploadManager& uploadManager_;
+    BindlessHeap& bindlessHeap_;
+    uint32_t frameCount_ = 0;
+    VkDeviceSize budgetBytes_ = 0;
+    TranscodeTarget transcodeTarget_ = TranscodeTarget::Rgba8;
+
+    std::vector<Texture> textures_;
+    std::vector<uint32_t> slots_;
+    std::vector<RetiredImage> retired_;
+    std::vector<uint32_t> unsubmitted_; // Textures whose pending residency has no upload value yet
+    VkDeviceSize residentBytes_ = 0;
+    uint64_t frameNumber_ = 0;
+};
+} // spectra
+
+#endif //SPECTRA_TEXTURESTREAMER_H
@@ -0,0 +1,56 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "ThreadPool.h"
+
+#include "Trace.h"
+
+namespace spectra {
+ThreadPool::ThreadPool(uint32_t threadCount, const char* name)
+{
+    workers_.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; i++)
+    {
+        workers_.emplace_back([this, name]
+        {
+            SPECTRA_TRACE_THREAD(name);
+            workerLoop();
+        });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+
+    // Workers drain the queue before exiting, so no submitted future is left broken
+    for (auto& worker : workers_)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+            if (jobs_.empty())
+            {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop();
+        }
+        job();
+    }
+}
+} // spectra
@@ -0,0 +1,57 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_THREADPOOL_H
+#define SPECTRA_THREADPOOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace spectra {
+class ThreadPool {
+public:
+    // Defaults to one worker per core minus the main thread. The name labels the workers in CPU traces.
+    explicit ThreadPool(uint32_t threadCount = std::max(2U, std::thread::hardware_concurrency()) - 1,
+                        const char* name = "Worker");
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& job) -> std::future<std::invoke_result_t<F>>
+    {
+        // std::function needs a copyable target, packaged_task is move-only
+        auto pTask = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(job));
+        auto future = pTask->get_future();
+        {
+            std::lock_guard lock(mutex_);
+            jobs_.emplace([pTask] { (*pTask)(); });
+        }
+        cv_.notify_one();
+        return future;
+    }
+
+    [[nodiscard]] uint32_t size() const { return static_cast<uint32_t>(workers_.size()); }
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> jobs_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_ = false;
+};
+} // spectra
+
+#endif //SPECTRA_THREADPOOL_H
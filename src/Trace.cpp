@@ -0,0 +1,136 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "Trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace spectra::trace {
+namespace {
+struct Event
+{
+    const char* name = nullptr;
+    uint64_t beginNs = 0;
+    uint64_t endNs = 0;
+};
+
+struct ThreadBuffer
+{
+    uint32_t tid = 0;
+    std::atomic<const char*> name{ nullptr };
+    // Only the owning thread writes, head is published with release so the exporter sees complete events
+    std::atomic<uint64_t> head{ 0 };
+    std::vector<Event> events = std::vector<Event>(EVENTS_PER_THREAD);
+};
+
+// Buffers are shared with the registry so zones of threads that have exited can still be exported
+std::mutex registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> registry;
+
+const auto traceStart = std::chrono::steady_clock::now();
+
+ThreadBuffer& threadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> pBuffer = []
+    {
+        auto pNew = std::make_shared<ThreadBuffer>();
+        std::lock_guard lock(registryMutex);
+        pNew->tid = static_cast<uint32_t>(registry.size()) + 1;
+        registry.push_back(pNew);
+        return pNew;
+    }();
+    return *pBuffer;
+}
+
+void writeEscaped(std::ostream& os, const char* str)
+{
+    for (; *str != '\0'; str++)
+    {
+        if (*str == '"' || *str == '\\')
+        {
+            os << '\\';
+        }
+        os << *str;
+    }
+}
+}
+
+uint64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceStart).count();
+}
+
+void record(const char* name, uint64_t beginNs, uint64_t endNs)
+{
+    ThreadBuffer& buffer = threadBuffer();
+    const uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % EVENTS_PER_THREAD] = { name, beginNs, endNs };
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void setThreadName(const char* name)
+{
+    threadBuffer().name.store(name, std::memory_order_relaxed);
+}
+
+bool writeChromeTrace(const std::string& path)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        std::cerr << "Failed to open " << path << " for the CPU trace\n";
+        return false;
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard lock(registryMutex);
+        buffers = registry;
+    }
+
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    size_t eventCount = 0;
+    for (const auto& pBuffer : buffers)
+    {
+        if (const char* name = pBuffer->name.load(std::memory_order_relaxed))
+        {
+            file << (first ? "" : ",\n") << R"({"ph":"M","name":"thread_name","pid":1,"tid":)" << pBuffer->tid
+                 << R"(,"args":{"name":")";
+            writeEscaped(file, name);
+            file << "\"}}";
+            first = false;
+        }
+
+        const uint64_t head = pBuffer->head.load(std::memory_order_acquire);
+        const uint64_t count = std::min<uint64_t>(head, EVENTS_PER_THREAD);
+        for (uint64_t i = head - count; i < head; i++)
+        {
+            const Event& event = pBuffer->events[i % EVENTS_PER_THREAD];
+            // Chrome trace timestamps are microseconds, fractions keep sub-microsecond zones visible
+            file << (first ? "" : ",\n") << R"({"ph":"X","pid":1,"tid":)" << pBuffer->tid
+                 << R"(,"ts":)" << static_cast<double>(event.beginNs) * 1e-3
+                 << R"(,"dur":)" << static_cast<double>(event.endNs - event.beginNs) * 1e-3
+                 << R"(,"name":")";
+            writeEscaped(file, event.name);
+            file << "\"}";
+            first = false;
+        }
+        eventCount += count;
+    }
+    file << "\n]}\n";
+
+    std::clog << "Wrote " << eventCount << " CPU trace events from " << buffers.size() << " threads to " << path << "\n";
+    return true;
+}
+} // spectra::trace
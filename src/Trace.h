@@ -0,0 +1,54 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_TRACE_H
+#define SPECTRA_TRACE_H
+
+#include <cstdint>
+#include <string>
+
+// CPU instrumentation zones. SPECTRA_TRACE_SCOPE("name") measures the enclosing scope on the calling thread and
+// SPECTRA_TRACE_THREAD("name") labels the calling thread. Both compile to nothing unless SPECTRA_ENABLE_TRACING is
+// defined (the SPECTRA_ENABLE_TRACING CMake option), so zones can stay in hot paths.
+//
+// Every thread records into its own fixed-size ring buffer, so recording takes no locks and only the most recent
+// zones of each thread are kept. writeChromeTrace() exports them as Chrome trace-event JSON for Perfetto or
+// chrome://tracing. Names must be string literals or otherwise outlive the capture.
+namespace spectra::trace {
+// Zones kept per thread, older zones are overwritten
+constexpr uint32_t EVENTS_PER_THREAD = 1U << 16;
+
+uint64_t nowNs();
+void record(const char* name, uint64_t beginNs, uint64_t endNs);
+void setThreadName(const char* name);
+
+// Writes the zones of every thread that has recorded so far. Meant to be called at a quiet point (between frames or
+// at exit), zones recorded concurrently by other threads may be missing from the capture.
+bool writeChromeTrace(const std::string& path);
+
+class Zone {
+public:
+    explicit Zone(const char* name) : name_(name), beginNs_(nowNs()) {}
+    ~Zone() { record(name_, beginNs_, nowNs()); }
+
+    Zone(const Zone&) = delete;
+    Zone& operator=(const Zone&) = delete;
+
+private:
+    const char* name_;
+    uint64_t beginNs_;
+};
+} // spectra::trace
+
+#ifdef SPECTRA_ENABLE_TRACING
+#define SPECTRA_TRACE_CONCAT_IMPL(a, b) a##b
+#define SPECTRA_TRACE_CONCAT(a, b) SPECTRA_TRACE_CONCAT_IMPL(a, b)
+#define SPECTRA_TRACE_SCOPE(name) const ::spectra::trace::Zone SPECTRA_TRACE_CONCAT(traceZone_, __LINE__)(name)
+#define SPECTRA_TRACE_THREAD(name) ::spectra::trace::setThreadName(name)
+#else
+#define SPECTRA_TRACE_SCOPE(name) static_cast<void>(0)
+#define SPECTRA_TRACE_THREAD(name) static_cast<void>(name)
+#endif
+
+#endif //SPECTRA_TRACE_H
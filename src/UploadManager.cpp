@@ -0,0 +1,474 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "UploadManager.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include "vk/Error.h"
+
+namespace spectra {
+namespace {
+// Also a multiple of every texel block size an image upload accepts
+constexpr VkDeviceSize STAGING_ALIGNMENT = 16;
+
+void pipelineBarrier(VkCommandBuffer cb, const std::vector<VkImageMemoryBarrier2>& barriers)
+{
+    if (barriers.empty())
+    {
+        return;
+    }
+
+    const VkDependencyInfo dependencyInfo {
+        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+        .imageMemoryBarrierCount = static_cast<uint32_t>(barriers.size()),
+        .pImageMemoryBarriers = barriers.data()
+    };
+    vkCmdPipelineBarrier2(cb, &dependencyInfo);
+}
+} // namespace
+
+UploadManager::UploadManager(std::shared_ptr<vk::Context> pCtx, VmaAllocator allocator, VkDeviceSize ringSize)
+    : pCtx_(std::move(pCtx)), device_(pCtx_->device), allocator_(allocator), ringSize_(ringSize)
+{
+    ownershipTransfer_ = pCtx_->transferQueueFamily != pCtx_->graphicsQueueFamily;
+
+    VkBufferCreateInfo ringCreateInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = ringSize_,
+        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+    };
+    VmaAllocationCreateInfo ringAllocCreateInfo
+    {
+        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO,
+    };
+    VmaAllocationInfo ringAllocInfo{};
+    CHECK_VK(vmaCreateBuffer(allocator_, &ringCreateInfo, &ringAllocCreateInfo, &ringBuffer_, &ringAlloc_, &ringAllocInfo));
+    pRingData_ = static_cast<uint8_t*>(ringAllocInfo.pMappedData);
+
+    const VkCommandPoolCreateInfo poolCreateInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = pCtx_->transferQueueFamily
+    };
+    CHECK_VK(vkCreateCommandPool(device_, &poolCreateInfo, nullptr, &cmdPool_))
+
+    VkSemaphoreTypeCreateInfo timelineCreateInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = 0,
+    };
+    VkSemaphoreCreateInfo semaphoreCreateInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &timelineCreateInfo,
+    };
+    CHECK_VK(vkCreateSemaphore(device_, &semaphoreCreateInfo, nullptr, &timeline_))
+}
+
+UploadManager::~UploadManager()
+{
+    wait(submittedValue_);
+
+    vkDestroySemaphore(device_, timeline_, nullptr);
+    vkDestroyCommandPool(device_, cmdPool_, nullptr);
+    vmaDestroyBuffer(allocator_, ringBuffer_, ringAlloc_);
+}
+
+void UploadManager::uploadBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void* pData, VkDeviceSize size)
+{
+    // Anything bigger than a quarter of the ring is split, so large uploads pipeline with their own retirement
+    const VkDeviceSize maxChunk = ringSize_ / 4;
+    const auto* pBytes = static_cast<const uint8_t*>(pData);
+
+    while (size > 0)
+    {
+        const VkDeviceSize chunk = std::min(size, maxChunk);
+        const VkDeviceSize stagingOffset = allocateStaging(chunk);
+        memcpy(pRingData_ + stagingOffset, pBytes, chunk);
+
+        pendingCopies_.push_back({ dst, { stagingOffset, dstOffset, chunk } });
+
+        pBytes += chunk;
+        dstOffset += chunk;
+        size -= chunk;
+    }
+}
+
+void UploadManager::uploadImage(VkImage dst, std::span<const ImageLevel> levels, uint32_t blockHeight)
+{
+    const VkDeviceSize maxChunk = ringSize_ / 4;
+    pendingImages_.push_back({ .image = dst, .levelCount = static_cast<uint32_t>(levels.size()) });
+
+    for (uint32_t level = 0; level < levels.size(); level++)
+    {
+        const ImageLevel& source = levels[level];
+        const auto* pBytes = static_cast<const uint8_t*>(source.pData);
+
+        // Chunks are whole rows of texel blocks, so every chunk is a rectangle of the level
+        const uint32_t blockRows = (source.height + blockHeight - 1) / blockHeight;
+        const VkDeviceSize rowSize = source.size / blockRows;
+        const uint32_t rowsPerChunk = static_cast<uint32_t>(std::max<VkDeviceSize>(maxChunk / rowSize, 1));
+
+        for (uint32_t row = 0; row < blockRows; row += rowsPerChunk)
+        {
+            const uint32_t rows = std::min(rowsPerChunk, blockRows - row);
+            const VkDeviceSize chunk = rows * rowSize;
+            const VkDeviceSize stagingOffset = allocateStaging(chunk);
+            memcpy(pRingData_ + stagingOffset, pBytes + row * rowSize, chunk);
+
+            const uint32_t y = row * blockHeight;
+            pendingImageCopies_.push_back({ dst, {
+                .bufferOffset = stagingOffset,
+                .imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 },
+                .imageOffset = { 0, static_cast<int32_t>(y), 0 },
+                .imageExtent = { source.width, std::min(rows * blockHeight, source.height - y), 1 },
+            } });
+        }
+    }
+
+    // A flush while staging may already have submitted part of the image, the entry is found again by handle
+    const auto it = std::ranges::find(pendingImages_, dst, &PendingImage::image);
+    assert(it != pendingImages_.end());
+    it->complete = true;
+}
+
+uint64_t UploadManager::flush()
+{
+    const bool finishesImages = std::ranges::any_of(pendingImages_, &PendingImage::complete);
+    if (pendingCopies_.empty() && pendingImageCopies_.empty() && !finishesImages)
+    {
+        return submittedValue_;
+    }
+
+    CHECK_VK(vmaFlushAllocation(allocator_, ringAlloc_, 0, VK_WHOLE_SIZE))
+
+    Batch batch{ .cb = acquireCommandBuffer() };
+
+    const VkCommandBufferBeginInfo beginInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+    CHECK_VK(vkBeginCommandBuffer(batch.cb, &beginInfo))
+
+    // One copy command per destination buffer with all its regions
+    std::ranges::stable_sort(pendingCopies_, {}, [](const PendingCopy& copy) { return copy.dst; });
+
+    std::vector<VkBufferCopy> regions;
+    std::vector<VkBufferMemoryBarrier2> releases;
+    for (size_t first = 0; first < pendingCopies_.size();)
+    {
+        const VkBuffer dst = pendingCopies_[first].dst;
+        VkDeviceSize rangeBegin = pendingCopies_[first].region.dstOffset;
+        VkDeviceSize rangeEnd = rangeBegin;
+
+        regions.clear();
+        size_t last = first;
+        for (; last < pendingCopies_.size() && pendingCopies_[last].dst == dst; last++)
+        {
+            const VkBufferCopy& region = pendingCopies_[last].region;
+            regions.push_back(region);
+            rangeBegin = std::min(rangeBegin, region.dstOffset);
+            rangeEnd = std::max(rangeEnd, region.dstOffset + region.size);
+        }
+        vkCmdCopyBuffer(batch.cb, ringBuffer_, dst, static_cast<uint32_t>(regions.size()), regions.data());
+
+        if (ownershipTransfer_)
+        {
+            VkBufferMemoryBarrier2 release {
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_2_NONE,
+                .dstAccessMask = VK_ACCESS_2_NONE,
+                .srcQueueFamilyIndex = pCtx_->transferQueueFamily,
+                .dstQueueFamilyIndex = pCtx_->graphicsQueueFamily,
+                .buffer = dst,
+                .offset = rangeBegin,
+                .size = rangeEnd - rangeBegin,
+            };
+            releases.push_back(release);
+
+            // The matching acquire is recorded on the graphics queue with identical ownership parameters
+            VkBufferMemoryBarrier2 acquire = release;
+            acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+            acquire.srcAccessMask = VK_ACCESS_2_NONE;
+            acquire.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            acquire.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+            batch.acquires.push_back(acquire);
+        }
+
+        first = last;
+    }
+
+    if (!releases.empty())
+    {
+        const VkDependencyInfo dependencyInfo {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .bufferMemoryBarrierCount = static_cast<uint32_t>(releases.size()),
+            .pBufferMemoryBarriers = releases.data()
+        };
+        vkCmdPipelineBarrier2(batch.cb, &dependencyInfo);
+    }
+
+    recordImageCopies(batch);
+
+    CHECK_VK(vkEndCommandBuffer(batch.cb))
+
+    batch.timelineValue = ++submittedValue_;
+    batch.ringEnd = ringHead_;
+
+    const VkCommandBufferSubmitInfo cmdSubmitInfo {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+        .commandBuffer = batch.cb,
+    };
+    const VkSemaphoreSubmitInfo signalInfo {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = timeline_,
+        .value = batch.timelineValue,
+        .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+    };
+    const VkSubmitInfo2 submitInfo {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+        .commandBufferInfoCount = 1,
+        .pCommandBufferInfos = &cmdSubmitInfo,
+        .signalSemaphoreInfoCount = 1,
+        .pSignalSemaphoreInfos = &signalInfo,
+    };
+    CHECK_VK(vkQueueSubmit2(pCtx_->transferQueue, 1, &submitInfo, VK_NULL_HANDLE))
+
+    pendingCopies_.clear();
+    inFlightBatches_.push_back(std::move(batch));
+
+    return submittedValue_;
+}
+
+bool UploadManager::isComplete(uint64_t value) const
+{
+    uint64_t completed = 0;
+    CHECK_VK(vkGetSemaphoreCounterValue(device_, timeline_, &completed))
+    return completed >= value;
+}
+
+void UploadManager::wait(uint64_t value) const
+{
+    if (value == 0)
+    {
+        return;
+    }
+
+    const VkSemaphoreWaitInfo waitInfo {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &timeline_,
+        .pValues = &value,
+    };
+    CHECK_VK(vkWaitSemaphores(device_, &waitInfo, UINT64_MAX))
+}
+
+std::optional<VkSemaphoreSubmitInfo> UploadManager::recordAcquires(VkCommandBuffer graphicsCb)
+{
+    retireCompletedBatches();
+    if (retiredValue_ <= acquiredValue_)
+    {
+        return std::nullopt;
+    }
+
+    if (!retiredAcquires_.empty() || !retiredImageAcquires_.empty())
+    {
+        const VkDependencyInfo dependencyInfo {
+            .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+            .bufferMemoryBarrierCount = static_cast<uint32_t>(retiredAcquires_.size()),
+            .pBufferMemoryBarriers = retiredAcquires_.data(),
+            .imageMemoryBarrierCount = static_cast<uint32_t>(retiredImageAcquires_.size()),
+            .pImageMemoryBarriers = retiredImageAcquires_.data()
+        };
+        vkCmdPipelineBarrier2(graphicsCb, &dependencyInfo);
+        retiredAcquires_.clear();
+        retiredImageAcquires_.clear();
+    }
+
+    acquiredValue_ = retiredValue_;
+
+    // Gives the graphics queue a memory dependency on the copies, which the same-family path relies on
+    return VkSemaphoreSubmitInfo {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = timeline_,
+        .value = acquiredValue_,
+        .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+    };
+}
+
+VkDeviceSize UploadManager::allocateStaging(VkDeviceSize size)
+{
+    size = (size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+    assert(size <= ringSize_);
+
+    while (true)
+    {
+        // Allocations never straddle the end of the ring, the tail end is skipped instead
+        const VkDeviceSize offset = ringHead_ % ringSize_;
+        const VkDeviceSize padding = offset + size > ringSize_ ? ringSize_ - offset : 0;
+        if (ringHead_ + padding + size - ringTail_ <= ringSize_)
+        {
+            ringHead_ += padding;
+            const VkDeviceSize allocationOffset = ringHead_ % ringSize_;
+            ringHead_ += size;
+            return allocationOffset;
+        }
+
+        retireCompletedBatches();
+        if (ringHead_ + padding + size - ringTail_ <= ringSize_)
+        {
+            continue;
+        }
+
+        // The ring is full of data the GPU still needs, submit what is pending and wait for the oldest batch
+        if (inFlightBatches_.empty())
+        {
+            flush();
+        }
+        wait(inFlightBatches_.front().timelineValue);
+        retireCompletedBatches();
+    }
+}
+
+void UploadManager::retireCompletedBatches()
+{
+    uint64_t completed = 0;
+    CHECK_VK(vkGetSemaphoreCounterValue(device_, timeline_, &completed))
+
+    while (!inFlightBatches_.empty() && inFlightBatches_.front().timelineValue <= completed)
+    {
+        Batch& batch = inFlightBatches_.front();
+        ringTail_ = batch.ringEnd;
+        retiredValue_ = batch.timelineValue;
+        freeCmdBuffers_.push_back(batch.cb);
+        retiredAcquires_.insert(retiredAcquires_.end(), batch.acquires.begin(), batch.acquires.end());
+        retiredImageAcquires_.insert(retiredImageAcquires_.end(), batch.imageAcquires.begin(), batch.imageAcquires.end());
+        inFlightBatches_.pop_front();
+    }
+
+    // Nothing in flight and nothing pending means the ring is empty, restart from its beginning
+    if (inFlightBatches_.empty() && pendingCopies_.empty() && pendingImageCopies_.empty())
+    {
+        ringHead_ = ringTail_ = 0;
+    }
+}
+
+void UploadManager::recordImageCopies(Batch& batch)
+{
+    if (pendingImages_.empty())
+    {
+        return;
+    }
+
+    const auto imageBarrier = [](const PendingImage& image, VkImageLayout oldLayout, VkImageLayout newLayout)
+    {
+        return VkImageMemoryBarrier2 {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+            .oldLayout = oldLayout,
+            .newLayout = newLayout,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = image.image,
+            .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, image.levelCount, 0, 1 },
+        };
+    };
+
+    // Images start out undefined, the first batch copying into one moves all of its levels to TRANSFER_DST
+    std::vector<VkImageMemoryBarrier2> barriers;
+    for (PendingImage& image : pendingImages_)
+    {
+        const bool copied = std::ranges::find(pendingImageCopies_, image.image, &PendingImageCopy::dst) !=
+                            pendingImageCopies_.end();
+        if (image.started || !copied)
+        {
+            continue;
+        }
+        VkImageMemoryBarrier2 barrier = imageBarrier(image, VK_IMAGE_LAYOUT_UNDEFINED,
+                                                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barriers.push_back(barrier);
+        image.started = true;
+    }
+    pipelineBarrier(batch.cb, barriers);
+
+    std::ranges::stable_sort(pendingImageCopies_, {}, [](const PendingImageCopy& copy) { return copy.dst; });
+    std::vector<VkBufferImageCopy> regions;
+    for (size_t first = 0; first < pendingImageCopies_.size();)
+    {
+        const VkImage dst = pendingImageCopies_[first].dst;
+        regions.clear();
+        size_t last = first;
+        for (; last < pendingImageCopies_.size() && pendingImageCopies_[last].dst == dst; last++)
+        {
+            regions.push_back(pendingImageCopies_[last].region);
+        }
+        vkCmdCopyBufferToImage(batch.cb, ringBuffer_, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               static_cast<uint32_t>(regions.size()), regions.data());
+        first = last;
+    }
+    pendingImageCopies_.clear();
+
+    // Completed images move to the shader layout. Across queue families the transition is part of the release and
+    // the acquire has to repeat it.
+    barriers.clear();
+    for (const PendingImage& image : pendingImages_)
+    {
+        if (!image.complete)
+        {
+            continue;
+        }
+        VkImageMemoryBarrier2 release = imageBarrier(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        release.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        release.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        if (ownershipTransfer_)
+        {
+            release.srcQueueFamilyIndex = pCtx_->transferQueueFamily;
+            release.dstQueueFamilyIndex = pCtx_->graphicsQueueFamily;
+
+            VkImageMemoryBarrier2 acquire = release;
+            acquire.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+            acquire.srcAccessMask = VK_ACCESS_2_NONE;
+            acquire.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            acquire.dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT;
+            batch.imageAcquires.push_back(acquire);
+        }
+        barriers.push_back(release);
+    }
+    pipelineBarrier(batch.cb, barriers);
+
+    std::erase_if(pendingImages_, [](const PendingImage& image) { return image.complete; });
+}
+
+VkCommandBuffer UploadManager::acquireCommandBuffer()
+{
+    VkCommandBuffer cb = VK_NULL_HANDLE;
+    if (!freeCmdBuffers_.empty())
+    {
+        cb = freeCmdBuffers_.back();
+        freeCmdBuffers_.pop_back();
+        CHECK_VK(vkResetCommandBuffer(cb, 0))
+        return cb;
+    }
+
+    const VkCommandBufferAllocateInfo allocInfo{
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool        = cmdPool_,
+        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+    CHECK_VK(vkAllocateCommandBuffers(device_, &allocInfo, &cb))
+    return cb;
+}
+} // spectra
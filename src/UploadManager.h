@@ -0,0 +1,132 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_UPLOADMANAGER_H
+#define SPECTRA_UPLOADMANAGER_H
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+#include <vk_mem_alloc.h>
+
+#include "vk/Context.h"
+
+namespace spectra {
+// Streams data to device-local buffers and images through a persistently mapped staging ring. Copies are batched and
+// submitted on the transfer queue, completion is tracked with a timeline semaphore and staging space is
+// recycled as batches retire. When the transfer queue belongs to another family, ownership of the written
+// ranges is released on the transfer queue and acquired by the graphics queue via recordAcquires().
+class UploadManager {
+public:
+    UploadManager(std::shared_ptr<vk::Context> pCtx, VmaAllocator allocator, VkDeviceSize ringSize = 32ULL << 20);
+    ~UploadManager();
+
+    UploadManager(const UploadManager&) = delete;
+    UploadManager& operator=(const UploadManager&) = delete;
+
+    // Copies the data into staging memory and queues a copy to dst. Only blocks when the ring is full of data
+    // the GPU has not consumed yet.
+    void uploadBuffer(VkBuffer dst, VkDeviceSize dstOffset, const void* pData, VkDeviceSize size);
+
+    struct ImageLevel
+    {
+        const void* pData = nullptr; // Tightly packed texel blocks
+        VkDeviceSize size = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    };
+
+    // Uploads every mip level of a freshly created single-layer color image, which ends up in
+    // SHADER_READ_ONLY_OPTIMAL. Levels larger than a quarter of the ring are split into rows of texel blocks,
+    // blockHeight being the block height of the image format.
+    void uploadImage(VkImage dst, std::span<const ImageLevel> levels, uint32_t blockHeight = 1);
+
+    // Submits all queued copies, returns the timeline value signaled once they have completed
+    uint64_t flush();
+
+    [[nodiscard]] bool isComplete(uint64_t value) const;
+    void wait(uint64_t value) const;
+
+    // Records ownership acquires for every retired batch into a graphics command buffer. The returned wait must be
+    // added to that command buffer's submission; it is already signaled, so it never stalls the graphics queue.
+    std::optional<VkSemaphoreSubmitInfo> recordAcquires(VkCommandBuffer graphicsCb);
+
+    // True once the uploads up to `value` are complete and visible to the graphics queue
+    [[nodiscard]] bool isAvailable(uint64_t value) const { return value <= acquiredValue_; }
+
+    [[nodiscard]] VkDeviceSize ringSize() const { return ringSize_; }
+    [[nodiscard]] VkDeviceSize ringBytesInFlight() const { return ringHead_ - ringTail_; }
+
+private:
+    struct PendingCopy
+    {
+        VkBuffer dst = VK_NULL_HANDLE;
+        VkBufferCopy region{};
+    };
+
+    struct PendingImageCopy
+    {
+        VkImage dst = VK_NULL_HANDLE;
+        VkBufferImageCopy region{};
+    };
+
+    // An image can be split across batches when the ring fills up mid-upload, it is only transitioned to its
+    // shader layout by the batch that follows its last copy
+    struct PendingImage
+    {
+        VkImage image = VK_NULL_HANDLE;
+        uint32_t levelCount = 0;
+        bool started = false;  // Already in TRANSFER_DST_OPTIMAL from an earlier batch
+        bool complete = false; // Every copy has been queued
+    };
+
+    struct Batch
+    {
+        VkCommandBuffer cb = VK_NULL_HANDLE;
+        uint64_t timelineValue = 0;
+        uint64_t ringEnd = 0; // Ring head when the batch was submitted, everything before it is freed on retire
+        std::vector<VkBufferMemoryBarrier2> acquires;
+        std::vector<VkImageMemoryBarrier2> imageAcquires;
+    };
+
+    // Returns the ring offset of `size` free bytes, retiring or flushing batches as needed
+    VkDeviceSize allocateStaging(VkDeviceSize size);
+    void retireCompletedBatches();
+    VkCommandBuffer acquireCommandBuffer();
+    // Layout transitions and copies of every pending image, plus the release of the images completed by the batch
+    void recordImageCopies(Batch& batch);
+
+    std::shared_ptr<vk::Context> pCtx_;
+    VkDevice device_ = VK_NULL_HANDLE;
+    VmaAllocator allocator_ = VK_NULL_HANDLE;
+    bool ownershipTransfer_ = false;
+
+    VkBuffer ringBuffer_ = VK_NULL_HANDLE;
+    VmaAllocation ringAlloc_{};
+    uint8_t* pRingData_ = nullptr;
+    VkDeviceSize ringSize_ = 0;
+    // Monotonic byte counters, the ring offset is counter % ringSize_
+    uint64_t ringHead_ = 0;
+    uint64_t ringTail_ = 0;
+
+    VkCommandPool cmdPool_ = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> freeCmdBuffers_;
+
+    VkSemaphore timeline_ = VK_NULL_HANDLE;
+    uint64_t submittedValue_ = 0;
+    uint64_t acquiredValue_ = 0;
+
+    std::vector<PendingCopy> pendingCopies_;
+    std::vector<PendingImageCopy> pendingImageCopies_;
+    std::vector<PendingImage> pendingImages_;
+    std::deque<Batch> inFlightBatches_;
+    std::vector<VkBufferMemoryBarrier2> retiredAcquires_;
+    std::vector<VkImageMemoryBarrier2> retiredImageAcquires_;
+    uint64_t retiredValue_ = 0;
+};
+} // spectra
+
+#endif //SPECTRA_UPLOADMANAGER_H
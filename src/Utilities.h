@@ -11,41 +11,6 @@
 namespace spectra::utils {
 namespace vk {
 
-static void transitionImageLayout(
-    VkCommandBuffer cb,
-    VkImage image,
-    VkImageLayout oldLayout,
-    VkImageLayout newLayout,
-    VkPipelineStageFlags2 srcStage,
-    VkAccessFlags2 srcAccess,
-    VkPipelineStageFlags2 dstStage,
-    VkAccessFlags2 dstAccess,
-    uint32_t srcQueueFamily = VK_QUEUE_FAMILY_IGNORED,
-    uint32_t dstQueueFamily = VK_QUEUE_FAMILY_IGNORED)
-{
-    VkImageMemoryBarrier2 imageBarrier {
-        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
-        .srcStageMask = srcStage,
-        .srcAccessMask = srcAccess,
-        .dstStageMask = dstStage,
-        .dstAccessMask = dstAccess,
-        .oldLayout = oldLayout,
-        .newLayout = newLayout,
-        .srcQueueFamilyIndex = srcQueueFamily,
-        .dstQueueFamilyIndex = dstQueueFamily,
-        .image = image,
-        .subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
-    };
-
-    VkDependencyInfo dependencyInfo {
-        .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-        .imageMemoryBarrierCount = 1,
-        .pImageMemoryBarriers = &imageBarrier
-    };
-
-    vkCmdPipelineBarrier2(cb, &dependencyInfo);
-}
-
 static void createTemporaryCommandPool(VkDevice device, uint32_t queueIndex, VkCommandPool& cmdPool)
 {
     const VkCommandPoolCreateInfo commandPoolCreateInfo{
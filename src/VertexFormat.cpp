@@ -0,0 +1,91 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "VertexFormat.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <glm/gtc/packing.hpp>
+
+namespace spectra {
+namespace {
+template <typename T>
+T quantizeUnorm(float value)
+{
+    constexpr float MAX = static_cast<float>(std::numeric_limits<T>::max());
+    return static_cast<T>(std::lround(std::clamp(value, 0.0f, 1.0f) * MAX));
+}
+}
+
+uint32_t vertexSize(VertexFormat format)
+{
+    return format == VertexFormat::Quantized ? sizeof(QuantizedVertex) : sizeof(Vertex);
+}
+
+const char* vertexFormatName(VertexFormat format)
+{
+    return format == VertexFormat::Quantized ? "quantized" : "float";
+}
+
+VertexInputLayout vertexInputLayout(VertexFormat format)
+{
+    VertexInputLayout layout;
+    layout.bindings.push_back({
+        .binding = 0,
+        .stride = vertexSize(format),
+        .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+    });
+
+    if (format == VertexFormat::Quantized)
+    {
+        layout.attributes = {
+            { 0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(QuantizedVertex, position) },
+            { 1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(QuantizedVertex, color) },
+            { 2, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(QuantizedVertex, uv) },
+        };
+    }
+    else
+    {
+        layout.attributes = {
+            { 0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position) },
+            { 1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color) },
+            { 2, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv) },
+        };
+    }
+    return layout;
+}
+
+void quantizeVertices(std::span<const Vertex> vertices, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                      std::span<QuantizedVertex> out)
+{
+    // Flat axes quantize to 0, the dequantize matrix collapses them back onto the bound
+    const glm::vec3 extent = boundsMax - boundsMin;
+    const glm::vec3 scale(extent.x > 0.0f ? 1.0f / extent.x : 0.0f, extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+                          extent.z > 0.0f ? 1.0f / extent.z : 0.0f);
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        const Vertex& vertex = vertices[i];
+        const glm::vec3 position = (vertex.position - boundsMin) * scale;
+        out[i] = {
+            .position = { quantizeUnorm<uint16_t>(position.x), quantizeUnorm<uint16_t>(position.y),
+                          quantizeUnorm<uint16_t>(position.z), 0 },
+            .color = { quantizeUnorm<uint8_t>(vertex.color.r), quantizeUnorm<uint8_t>(vertex.color.g),
+                       quantizeUnorm<uint8_t>(vertex.color.b), 255 },
+            .uv = { glm::packHalf1x16(vertex.uv.x), glm::packHalf1x16(vertex.uv.y) },
+        };
+    }
+}
+
+glm::mat4 dequantizeMatrix(const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+    glm::mat4 matrix(1.0f);
+    matrix[0][0] = boundsMax.x - boundsMin.x;
+    matrix[1][1] = boundsMax.y - boundsMin.y;
+    matrix[2][2] = boundsMax.z - boundsMin.z;
+    matrix[3] = glm::vec4(boundsMin, 1.0f);
+    return matrix;
+}
+} // spectra
@@ -0,0 +1,57 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_VERTEXFORMAT_H
+#define SPECTRA_VERTEXFORMAT_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+namespace spectra {
+// Vertex as loaded and cooked, full precision
+struct Vertex
+{
+    glm::vec3 position;
+    glm::vec3 color;
+    glm::vec2 uv{ 0.0f };
+};
+
+// Half the size of Vertex. Positions are normalized to the bounds of their primitive, the draw transform maps them
+// back (dequantizeMatrix), colors are 8-bit and UVs half floats. The vertex input unpacks every attribute to
+// floats, so the scene shaders read both formats unchanged.
+struct QuantizedVertex
+{
+    uint16_t position[4]; // UNORM within the primitive bounds, w unused
+    uint8_t color[4];     // UNORM, a unused
+    uint16_t uv[2];       // Half floats
+};
+
+// Layout of the vertices in the geometry pool
+enum class VertexFormat
+{
+    Float,
+    Quantized,
+};
+
+struct VertexInputLayout
+{
+    std::vector<VkVertexInputBindingDescription> bindings;
+    std::vector<VkVertexInputAttributeDescription> attributes; // Locations 0-2: position, color, uv
+};
+
+[[nodiscard]] uint32_t vertexSize(VertexFormat format);
+[[nodiscard]] const char* vertexFormatName(VertexFormat format);
+[[nodiscard]] VertexInputLayout vertexInputLayout(VertexFormat format);
+
+// Quantizes the vertices of one primitive against its mesh-space bounds
+void quantizeVertices(std::span<const Vertex> vertices, const glm::vec3& boundsMin, const glm::vec3& boundsMax,
+                      std::span<QuantizedVertex> out);
+// Maps quantized positions of a primitive back to mesh space, applied before the world transform
+[[nodiscard]] glm::mat4 dequantizeMatrix(const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+} // spectra
+
+#endif //SPECTRA_VERTEXFORMAT_H
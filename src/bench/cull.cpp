@@ -0,0 +1,158 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+// Frustum culling microbenchmark. Culls a large random set of boxes with every kernel the CPU supports, single
+// threaded and on a thread pool, and prints the timings as JSON. Needs no GPU.
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Camera.h"
+#include "FrustumCuller.h"
+#include "ThreadPool.h"
+
+namespace {
+// Far beyond any core count, larger values are typos
+constexpr uint32_t MAX_THREADS = 1024;
+
+struct CullBenchOptions
+{
+    uint32_t objects = 1'000'000;
+    uint32_t iterations = 50;
+    uint32_t threads = std::max(2U, std::thread::hardware_concurrency()) - 1;
+};
+
+// std::stoul accepts a sign and wraps negative values, a count must be plain digits that fit 32 bits
+uint32_t parseCount(const std::string& value)
+{
+    const unsigned long count = std::stoul(value);
+    if (value.find('-') != std::string::npos || count > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::out_of_range(value);
+    }
+    return static_cast<uint32_t>(count);
+}
+
+bool parseArgs(int argc, char** argv, CullBenchOptions& options)
+{
+    // Malformed numbers throw, they are reported like any other bad argument
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (arg == "--objects" && hasValue)
+            {
+                options.objects = parseCount(argv[++i]);
+            }
+            else if (arg == "--iterations" && hasValue)
+            {
+                options.iterations = parseCount(argv[++i]);
+            }
+            else if (arg == "--threads" && hasValue)
+            {
+                options.threads = parseCount(argv[++i]);
+            }
+            else
+            {
+                return false;
+            }
+        }
+    }
+    catch (const std::logic_error&)
+    {
+        return false;
+    }
+
+    return options.objects > 0 && options.iterations > 0 && options.threads <= MAX_THREADS;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    CullBenchOptions options;
+    if (!parseArgs(argc, argv, options))
+    {
+        std::cerr << "Usage: spectra-cull-bench [--objects N] [--iterations N] [--threads N]\n";
+        return EXIT_FAILURE;
+    }
+
+    // Boxes of varying size scattered through a cube, the camera sees roughly a sixth of them
+    spectra::FrustumCuller culler;
+    culler.resize(options.objects);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> halfSize(0.5f, 5.0f);
+    for (uint32_t i = 0; i < options.objects; i++)
+    {
+        const glm::vec3 center(position(rng), position(rng), position(rng));
+        const glm::vec3 extent(halfSize(rng), halfSize(rng), halfSize(rng));
+        culler.setBounds(i, center - extent, center + extent);
+    }
+
+    spectra::Camera camera;
+    camera.position = glm::vec3(0.0f, 0.0f, -500.0f);
+    camera.target = glm::vec3(0.0f);
+    camera.farPlane = 1500.0f;
+    const auto frustum = spectra::Frustum::fromViewProjection(camera.viewProjection(16.0f / 9.0f));
+
+    spectra::ThreadPool threadPool(std::max(options.threads, 1U));
+    std::vector<uint32_t> visible;
+    visible.reserve(options.objects);
+
+    std::cout << "{\n"
+              << "  \"objects\": " << options.objects << ",\n"
+              << "  \"iterations\": " << options.iterations << ",\n"
+              << "  \"threads\": " << threadPool.size() << ",\n"
+              << "  \"results\": [";
+
+    bool first = true;
+    for (const auto kernel : { spectra::FrustumCuller::Kernel::Scalar, spectra::FrustumCuller::Kernel::Sse,
+                               spectra::FrustumCuller::Kernel::Avx2 })
+    {
+        if (!spectra::FrustumCuller::isSupported(kernel))
+        {
+            continue;
+        }
+        culler.setKernel(kernel);
+
+        for (const bool parallel : { false, true })
+        {
+            // One untimed pass to fault in the output and warm the caches
+            culler.cull(frustum, visible, parallel ? &threadPool : nullptr);
+
+            std::vector<double> timesMs;
+            for (uint32_t i = 0; i < options.iterations; i++)
+            {
+                culler.cull(frustum, visible, parallel ? &threadPool : nullptr);
+                timesMs.push_back(culler.stats().cullMs);
+            }
+            std::ranges::sort(timesMs);
+            const double meanMs = std::accumulate(timesMs.begin(), timesMs.end(), 0.0) / static_cast<double>(timesMs.size());
+
+            std::cout << (first ? "\n" : ",\n")
+                      << "    { \"kernel\": \"" << spectra::FrustumCuller::kernelName(kernel) << "\""
+                      << ", \"parallel\": " << (parallel ? "true" : "false")
+                      << ", \"visible\": " << visible.size()
+                      << ", \"mean_ms\": " << meanMs
+                      << ", \"min_ms\": " << timesMs.front()
+                      << ", \"p50_ms\": " << timesMs[timesMs.size() / 2]
+                      << ", \"mobjects_per_s\": " << static_cast<double>(options.objects) / (meanMs * 1e3) << " }";
+            first = false;
+        }
+    }
+    std::cout << "\n  ]\n}\n";
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,478 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+// Headless frame-time benchmark. Renders N frames of a scene into offscreen targets and prints the CPU and GPU
+// frame time distribution as JSON so runs can be compared across builds. With --record-thread-sweep it also
+// measures how command buffer recording scales with the number of recording threads.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Renderer.h"
+#include "Trace.h"
+#include "vk/Context.h"
+
+namespace {
+struct BenchOptions
+{
+    std::string scenePath;
+    std::string outputPath;
+    std::string gpuCsvPath;
+    std::string tracePath;
+    uint32_t frames = 1000;
+    uint32_t warmupFrames = 100;
+    VkExtent2D extent = { 1920, 1080 };
+    uint32_t recordThreads = 0; // 0 keeps the renderer default
+    uint32_t replicate = 1;
+    uint32_t framesInFlight = spectra::Renderer::DEFAULT_FRAMES_IN_FLIGHT;
+    bool recordThreadSweep = false;
+    bool cpuDriven = false;
+    bool occlusionCulling = true;
+    bool depthPrepass = false;
+    bool drawSorting = true;
+    bool quantizeVertices = false;
+    uint32_t textureBudgetMiB = 0; // 0 keeps the renderer default
+    float lodError = -1.0f;        // Pixels, negative keeps the renderer default
+};
+
+struct FrameSamples
+{
+    std::vector<double> cpuFrameTimesMs;
+    std::vector<double> gpuFrameTimesMs;
+    std::vector<double> recordTimesMs;
+};
+
+void printUsage()
+{
+    std::cerr << "Usage: spectra-bench <scene.glb|scene.spk> [--frames N] [--warmup N] [--width W] [--height H] [--out file.json]\n"
+                 "                     [--record-threads N] [--replicate N] [--record-thread-sweep] [--gpu-csv file.csv]\n"
+                 "                     [--trace trace.json] [--cpu-driven] [--no-draw-sorting] [--texture-budget MiB]\n"
+                 "                     [--quantize-vertices] [--lod-error PIXELS] [--frames-in-flight N]\n"
+                 "                     [--no-occlusion-culling] [--depth-prepass]\n";
+}
+
+// std::stoul accepts a sign and wraps negative values, a count must be plain digits that fit 32 bits
+uint32_t parseCount(const std::string& value)
+{
+    const unsigned long count = std::stoul(value);
+    if (value.find('-') != std::string::npos || count > std::numeric_limits<uint32_t>::max())
+    {
+        throw std::out_of_range(value);
+    }
+    return static_cast<uint32_t>(count);
+}
+
+bool parseArgs(int argc, char** argv, BenchOptions& options)
+{
+    // Malformed numbers throw, they are reported like any other bad argument
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (arg == "--frames" && hasValue)
+            {
+                options.frames = parseCount(argv[++i]);
+            }
+            else if (arg == "--warmup" && hasValue)
+            {
+                options.warmupFrames = parseCount(argv[++i]);
+            }
+            else if (arg == "--width" && hasValue)
+            {
+                options.extent.width = parseCount(argv[++i]);
+            }
+            else if (arg == "--height" && hasValue)
+            {
+                options.extent.height = parseCount(argv[++i]);
+            }
+            else if (arg == "--out" && hasValue)
+            {
+                options.outputPath = argv[++i];
+            }
+            else if (arg == "--record-threads" && hasValue)
+            {
+                options.recordThreads = parseCount(argv[++i]);
+            }
+            else if (arg == "--replicate" && hasValue)
+            {
+                options.replicate = parseCount(argv[++i]);
+            }
+            else if (arg == "--trace" && hasValue)
+            {
+                options.tracePath = argv[++i];
+            }
+            else if (arg == "--gpu-csv" && hasValue)
+            {
+                options.gpuCsvPath = argv[++i];
+            }
+            else if (arg == "--texture-budget" && hasValue)
+            {
+                options.textureBudgetMiB = parseCount(argv[++i]);
+            }
+            else if (arg == "--frames-in-flight" && hasValue)
+            {
+                options.framesInFlight = parseCount(argv[++i]);
+            }
+            else if (arg == "--lod-error" && hasValue)
+            {
+                options.lodError = std::stof(argv[++i]);
+            }
+            else if (arg == "--record-thread-sweep")
+            {
+                options.recordThreadSweep = true;
+            }
+            else if (arg == "--cpu-driven")
+            {
+                options.cpuDriven = true;
+            }
+            else if (arg == "--no-occlusion-culling")
+            {
+                options.occlusionCulling = false;
+            }
+            else if (arg == "--depth-prepass")
+            {
+                options.depthPrepass = true;
+            }
+            else if (arg == "--no-draw-sorting")
+            {
+                options.drawSorting = false;
+            }
+            else if (arg == "--quantize-vertices")
+            {
+                options.quantizeVertices = true;
+            }
+            else if (arg.starts_with("--"))
+            {
+                return false;
+            }
+            else
+            {
+                options.scenePath = arg;
+            }
+        }
+    }
+    catch (const std::logic_error&)
+    {
+        return false;
+    }
+
+    return !options.scenePath.empty() && options.frames > 0 && options.framesInFlight > 0;
+}
+
+// Names and paths are written into JSON strings
+std::string escapeJson(std::string_view str)
+{
+    std::string escaped;
+    escaped.reserve(str.size());
+    for (const char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+// Nearest-rank percentile, samples must be sorted
+double percentile(const std::vector<double>& sorted, double p)
+{
+    const auto rank = static_cast<size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+void writeStats(std::ostream& os, const char* name, std::vector<double> samples)
+{
+    os << "  \"" << name << "\": ";
+    if (samples.empty())
+    {
+        os << "null";
+        return;
+    }
+
+    std::ranges::sort(samples);
+    const double mean = std::accumulate(samples.begin(), samples.end(), 0.0) / static_cast<double>(samples.size());
+
+    os << "{ \"samples\": " << samples.size()
+       << ", \"mean\": " << mean
+       << ", \"min\": " << samples.front()
+       << ", \"max\": " << samples.back()
+       << ", \"p50\": " << percentile(samples, 50.0)
+       << ", \"p95\": " << percentile(samples, 95.0)
+       << ", \"p99\": " << percentile(samples, 99.0)
+       << " }";
+}
+
+FrameSamples runFrames(spectra::Renderer& renderer, VkDevice device, uint32_t frames, uint32_t warmupFrames)
+{
+    for (uint32_t i = 0; i < warmupFrames; i++)
+    {
+        renderer.render();
+    }
+    renderer.waitUntilReady();
+    vkDeviceWaitIdle(device);
+    renderer.consumeGpuFrameTimeMs();
+
+    FrameSamples samples;
+    samples.cpuFrameTimesMs.reserve(frames);
+    samples.gpuFrameTimesMs.reserve(frames);
+    samples.recordTimesMs.reserve(frames);
+
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        const auto frameStart = std::chrono::steady_clock::now();
+        renderer.render();
+        const auto frameEnd = std::chrono::steady_clock::now();
+
+        samples.cpuFrameTimesMs.push_back(std::chrono::duration<double, std::milli>(frameEnd - frameStart).count());
+        samples.recordTimesMs.push_back(renderer.lastRecordTimeMs());
+
+        // GPU times trail the CPU by the frames in flight, the last few frames of the run are not sampled
+        if (const auto gpuTime = renderer.consumeGpuFrameTimeMs())
+        {
+            samples.gpuFrameTimesMs.push_back(*gpuTime);
+        }
+    }
+    vkDeviceWaitIdle(device);
+
+    return samples;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    BenchOptions options;
+    if (!parseArgs(argc, argv, options))
+    {
+        printUsage();
+        return EXIT_FAILURE;
+    }
+#ifndef SPECTRA_ENABLE_TRACING
+    if (!options.tracePath.empty())
+    {
+        std::cerr << "--trace needs a build configured with -DSPECTRA_ENABLE_TRACING=ON\n";
+        return EXIT_FAILURE;
+    }
+#endif
+    SPECTRA_TRACE_THREAD("Main");
+
+    auto pCtx = std::make_shared<spectra::vk::Context>(true);
+    auto pRenderer = std::make_unique<spectra::Renderer>(pCtx, options.extent, VK_FORMAT_R8G8B8A8_UNORM,
+                                                        options.framesInFlight);
+    pRenderer->setVertexFormat(options.quantizeVertices ? spectra::VertexFormat::Quantized : spectra::VertexFormat::Float);
+    if (!pRenderer->loadScene(options.scenePath))
+    {
+        return EXIT_FAILURE;
+    }
+
+    pRenderer->replicateScene(options.replicate);
+    pRenderer->setGpuDriven(!options.cpuDriven);
+    pRenderer->setOcclusionCulling(options.occlusionCulling);
+    pRenderer->setDepthPrepass(options.depthPrepass);
+    pRenderer->setDrawSorting(options.drawSorting);
+    if (options.textureBudgetMiB > 0)
+    {
+        pRenderer->setTextureBudget(static_cast<VkDeviceSize>(options.textureBudgetMiB) << 20);
+    }
+    if (options.lodError >= 0.0f)
+    {
+        pRenderer->setLodErrorThreshold(options.lodError);
+    }
+    if (options.recordThreads > 0)
+    {
+        pRenderer->setRecordThreadCount(options.recordThreads);
+    }
+
+    // Pipelines compile and geometry uploads in the background, measured frames must include the scene draws
+    pRenderer->waitUntilReady();
+
+    // Only the measured frames of the main run go to the CSV, warmup is skipped
+    for (uint32_t i = 0; i < options.warmupFrames; i++)
+    {
+        pRenderer->render();
+    }
+    // Shader variants are compiled when the warmup first draws with them
+    pRenderer->waitUntilReady();
+    if (!options.gpuCsvPath.empty() && !pRenderer->startGpuTimingCapture(options.gpuCsvPath))
+    {
+        return EXIT_FAILURE;
+    }
+
+    const auto benchStart = std::chrono::steady_clock::now();
+    const FrameSamples samples = runFrames(*pRenderer, pCtx->device, options.frames, 0);
+    const auto benchEnd = std::chrono::steady_clock::now();
+    pRenderer->stopGpuTimingCapture();
+    // Rolling window over the last frames of the main run
+    const auto scopeStats = pRenderer->gpuScopeStats();
+    // Last frame of the main run, only filled on the CPU-driven path
+    const auto drawStats = pRenderer->drawListStats();
+    const auto lodStats = pRenderer->lodStats();
+    // Residency has settled on the benchmark view by the end of the main run
+    const auto textureStats = pRenderer->textureStats();
+    // Frame graph of the last frame of the main run
+    const auto graphStats = pRenderer->renderGraphStats();
+
+    // Record time per thread count, doubling up to the core count
+    std::vector<std::pair<uint32_t, std::vector<double>>> recordScaling;
+    if (options.recordThreadSweep)
+    {
+        const uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1U);
+        const uint32_t defaultThreads = pRenderer->recordThreadCount();
+        std::vector<uint32_t> threadCounts;
+        for (uint32_t threads = 1; threads < maxThreads; threads *= 2)
+        {
+            threadCounts.push_back(threads);
+        }
+        threadCounts.push_back(maxThreads);
+
+        // Only the CPU-driven path records per-draw commands
+        pRenderer->setGpuDriven(false);
+
+        for (const uint32_t threads : threadCounts)
+        {
+            pRenderer->setRecordThreadCount(threads);
+            recordScaling.emplace_back(threads,
+                                       runFrames(*pRenderer, pCtx->device, options.frames, options.warmupFrames).recordTimesMs);
+        }
+        pRenderer->setRecordThreadCount(options.recordThreads > 0 ? options.recordThreads : defaultThreads);
+        pRenderer->setGpuDriven(!options.cpuDriven);
+    }
+
+    std::ofstream outFile;
+    if (!options.outputPath.empty())
+    {
+        outFile.open(options.outputPath);
+        if (!outFile)
+        {
+            std::cerr << "Failed to open " << options.outputPath << "\n";
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& os = outFile.is_open() ? outFile : std::cout;
+
+    const auto shaderStats = pRenderer->shaderCompilerStats();
+
+    os << "{\n"
+       << "  \"scene\": \"" << escapeJson(options.scenePath) << "\",\n"
+       << "  \"device\": \"" << escapeJson(pCtx->physicalDeviceProperties.deviceName) << "\",\n"
+       << "  \"width\": " << options.extent.width << ",\n"
+       << "  \"height\": " << options.extent.height << ",\n"
+       << "  \"frames\": " << options.frames << ",\n"
+       << "  \"replicate\": " << options.replicate << ",\n"
+       << "  \"frames_in_flight\": " << pRenderer->framesInFlight() << ",\n"
+       << "  \"record_threads\": " << pRenderer->recordThreadCount() << ",\n"
+       << "  \"gpu_driven\": " << (pRenderer->gpuDriven() ? "true" : "false") << ",\n"
+       << "  \"occlusion_culling\": " << (pRenderer->occlusionCulling() ? "true" : "false") << ",\n"
+       << "  \"depth_prepass\": " << (pRenderer->depthPrepass() ? "true" : "false") << ",\n"
+       << "  \"total_ms\": " << std::chrono::duration<double, std::milli>(benchEnd - benchStart).count() << ",\n"
+       << "  \"startup_ms\": " << pRenderer->startupTimeMs() << ",\n"
+       << "  \"load_ms\": " << pRenderer->sceneLoadTimeMs() << ",\n"
+       << "  \"shader_cache\": { \"hits\": " << shaderStats.cacheHits
+       << ", \"misses\": " << shaderStats.cacheMisses
+       << ", \"compile_ms\": " << shaderStats.totalMs << " },\n"
+       << "  \"draw_list\": { \"draws\": " << drawStats.draws
+       << ", \"draw_calls\": " << drawStats.drawCalls
+       << ", \"pipeline_binds\": " << drawStats.pipelineBinds
+       << ", \"unsorted_pipeline_binds\": " << drawStats.unsortedPipelineBinds
+       << ", \"material_binds\": " << drawStats.materialBinds
+       << ", \"unsorted_material_binds\": " << drawStats.unsortedMaterialBinds
+       << ", \"build_ms\": " << drawStats.buildMs << " },\n"
+       << "  \"textures\": { \"count\": " << textureStats.textures
+       << ", \"resident_bytes\": " << textureStats.residentBytes
+       << ", \"all_mips_bytes\": " << textureStats.fullBytes
+       << ", \"budget_bytes\": " << textureStats.budgetBytes
+       << ", \"streaming\": " << textureStats.streaming << " },\n"
+       << "  \"geometry\": { \"vertex_format\": \"" << spectra::vertexFormatName(pRenderer->vertexFormat()) << "\""
+       << ", \"vertex_bytes\": " << pRenderer->sceneVertexBytes()
+       << ", \"index_bytes\": " << pRenderer->sceneIndexBytes() << " },\n"
+       << "  \"lod\": { \"error_threshold_px\": " << pRenderer->lodErrorThreshold()
+       << ", \"triangles\": " << lodStats.triangles
+       << ", \"full_detail_triangles\": " << lodStats.fullDetailTriangles << " },\n"
+       << "  \"render_graph\": { \"passes\": " << graphStats.passes
+       << ", \"culled_passes\": " << graphStats.culledPasses
+       << ", \"barrier_batches\": " << graphStats.barrierBatches
+       << ", \"image_barriers\": " << graphStats.imageBarriers
+       << ", \"buffer_barriers\": " << graphStats.bufferBarriers
+       << ", \"transient_images\": " << graphStats.transientImages
+       << ", \"transient_bytes\": " << graphStats.transientBytes
+       << ", \"transient_allocated_bytes\": " << graphStats.allocatedBytes << " },\n";
+
+    os << "  \"pipelines\": [";
+    const auto pipelineRecords = pRenderer->pipelineCompileRecords();
+    for (size_t i = 0; i < pipelineRecords.size(); i++)
+    {
+        const auto& record = pipelineRecords[i];
+        os << (i == 0 ? " " : ", ")
+           << "{ \"name\": \"" << escapeJson(record.name) << "\""
+           << ", \"compile_ms\": " << record.compileMs
+           << ", \"queued_ms\": " << record.queuedMs
+           << ", \"succeeded\": " << (record.succeeded ? "true" : "false")
+           << ", \"shared\": " << (record.shared ? "true" : "false") << " }";
+    }
+    os << " ],\n";
+    writeStats(os, "cpu_frame_ms", samples.cpuFrameTimesMs);
+    os << ",\n";
+    writeStats(os, "gpu_frame_ms", samples.gpuFrameTimesMs);
+    os << ",\n";
+    writeStats(os, "record_cpu_ms", samples.recordTimesMs);
+
+    os << ",\n  \"gpu_scopes\": [";
+    for (size_t i = 0; i < scopeStats.size(); i++)
+    {
+        const auto& scope = scopeStats[i];
+        os << (i == 0 ? " " : ", ")
+           << "{ \"name\": \"" << escapeJson(scope.name) << "\""
+           << ", \"mean\": " << scope.avgMs
+           << ", \"min\": " << scope.minMs
+           << ", \"max\": " << scope.maxMs << " }";
+    }
+    os << " ]";
+
+    if (options.recordThreadSweep)
+    {
+        os << ",\n  \"record_scaling\": [";
+        const double baselineMean = std::accumulate(recordScaling.front().second.begin(), recordScaling.front().second.end(), 0.0)
+                                    / static_cast<double>(recordScaling.front().second.size());
+        for (size_t i = 0; i < recordScaling.size(); i++)
+        {
+            auto& [threads, recordTimes] = recordScaling[i];
+            std::ranges::sort(recordTimes);
+            const double mean = std::accumulate(recordTimes.begin(), recordTimes.end(), 0.0) / static_cast<double>(recordTimes.size());
+            os << (i == 0 ? " " : ", ")
+               << "{ \"threads\": " << threads
+               << ", \"mean\": " << mean
+               << ", \"p50\": " << percentile(recordTimes, 50.0)
+               << ", \"p95\": " << percentile(recordTimes, 95.0)
+               << ", \"speedup\": " << baselineMean / mean << " }";
+        }
+        os << " ]";
+    }
+    os << "\n}\n";
+
+    if (!options.tracePath.empty() && !spectra::trace::writeChromeTrace(options.tracePath))
+    {
+        return EXIT_FAILURE;
+    }
+
+    // Destroy the renderer before the context that owns the device
+    pRenderer.reset();
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,213 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+// Offline scene cooker. Converts a .glb or .gltf file into a scene package (.spk) the engine maps at load instead
+// of parsing: geometry in the engine's float vertex layout reordered for the vertex cache, primitive bounds,
+// LODs, meshlets, flattened nodes and textures re-encoded as KTX2 with their full mip chain. Needs no GPU.
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+#include <ktx.h>
+
+#include "Gltf.h"
+#include "SceneAsset.h"
+#include "TextureStreamer.h"
+
+namespace {
+struct CookOptions
+{
+    std::string inputPath;
+    std::string outputPath;
+    bool basis = false; // Supercompress textures with Basis Universal instead of storing RGBA8
+    spectra::SceneAsset::ImportOptions import { .meshlets = true, .logMetrics = true };
+};
+
+bool parseArgs(int argc, char** argv, CookOptions& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "-o" && hasValue)
+        {
+            options.outputPath = argv[++i];
+        }
+        else if (arg == "--basis")
+        {
+            options.basis = true;
+        }
+        else if (arg == "--no-optimize")
+        {
+            options.import.geometry.optimize = false;
+        }
+        else if (arg == "--overdraw")
+        {
+            options.import.geometry.overdraw = true;
+        }
+        else if (arg == "--no-lods")
+        {
+            options.import.lods = false;
+        }
+        else if (arg == "--no-meshlets")
+        {
+            options.import.meshlets = false;
+        }
+        else if (arg.starts_with("-") || !options.inputPath.empty())
+        {
+            return false;
+        }
+        else
+        {
+            options.inputPath = arg;
+        }
+    }
+
+    if (options.outputPath.empty() && !options.inputPath.empty())
+    {
+        options.outputPath = std::filesystem::path(options.inputPath).replace_extension(".spk").string();
+    }
+    return !options.inputPath.empty();
+}
+
+void destroyKtx(ktxTexture2* pTexture)
+{
+    ktxTexture2_Destroy(pTexture);
+}
+
+// Encodes a PNG or JPEG base color image as an sRGB KTX2 file with every mip level. Empty on failure.
+std::vector<uint8_t> encodeKtx2(std::span<const uint8_t> encoded, bool basis)
+{
+    std::vector<uint8_t> data;
+    std::vector<spectra::TextureStreamer::Level> levels;
+    if (!spectra::TextureStreamer::decodeRgba8(encoded, data, levels))
+    {
+        return {};
+    }
+
+    ktxTextureCreateInfo createInfo {
+        .vkFormat = VK_FORMAT_R8G8B8A8_SRGB,
+        .baseWidth = levels.front().width,
+        .baseHeight = levels.front().height,
+        .baseDepth = 1,
+        .numDimensions = 2,
+        .numLevels = static_cast<ktx_uint32_t>(levels.size()),
+        .numLayers = 1,
+        .numFaces = 1,
+        .isArray = KTX_FALSE,
+        .generateMipmaps = KTX_FALSE,
+    };
+    ktxTexture2* pKtxRaw = nullptr;
+    ktx_error_code_e result = ktxTexture2_Create(&createInfo, KTX_TEXTURE_CREATE_ALLOC_STORAGE, &pKtxRaw);
+    if (result != KTX_SUCCESS)
+    {
+        std::cerr << std::format("Failed to create KTX2 texture: {}\n", ktxErrorString(result));
+        return {};
+    }
+    const std::unique_ptr<ktxTexture2, decltype(&destroyKtx)> pKtx(pKtxRaw, &destroyKtx);
+
+    for (uint32_t level = 0; level < levels.size(); level++)
+    {
+        result = ktxTexture_SetImageFromMemory(ktxTexture(pKtx.get()), level, 0, 0, data.data() + levels[level].offset,
+                                               levels[level].size);
+        if (result != KTX_SUCCESS)
+        {
+            std::cerr << std::format("Failed to set KTX2 level {}: {}\n", level, ktxErrorString(result));
+            return {};
+        }
+    }
+
+    if (basis)
+    {
+        // ETC1S, the runtime transcodes it to whatever block format the device samples
+        result = ktxTexture2_CompressBasis(pKtx.get(), 0);
+        if (result != KTX_SUCCESS)
+        {
+            std::cerr << std::format("Failed to compress texture with Basis Universal: {}\n", ktxErrorString(result));
+            return {};
+        }
+    }
+
+    ktx_uint8_t* pOutput = nullptr;
+    ktx_size_t outputSize = 0;
+    result = ktxTexture_WriteToMemory(ktxTexture(pKtx.get()), &pOutput, &outputSize);
+    if (result != KTX_SUCCESS)
+    {
+        std::cerr << std::format("Failed to write KTX2 texture: {}\n", ktxErrorString(result));
+        return {};
+    }
+    std::vector<uint8_t> output(pOutput, pOutput + outputSize);
+    free(pOutput);
+    return output;
+}
+} // namespace
+
+int main(int argc, char** argv)
+{
+    CookOptions options;
+    if (!parseArgs(argc, argv, options))
+    {
+        std::cerr << "Usage: spectra-cook <scene.glb|scene.gltf> [-o scene.spk] [--basis] [--no-optimize] [--overdraw]"
+                     " [--no-lods] [--no-meshlets]\n";
+        return EXIT_FAILURE;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    tinygltf::Model model;
+    if (!spectra::gltf::loadModel(options.inputPath, model))
+    {
+        return EXIT_FAILURE;
+    }
+    spectra::SceneAsset asset = spectra::SceneAsset::fromGltf(model, options.import);
+
+    // KTX2 images are kept as they are, everything else is decoded and mipmapped once here instead of at every load
+    std::vector<std::vector<uint8_t>> images;
+    uint32_t converted = 0;
+    for (uint32_t i = 0; i < asset.imageCount(); i++)
+    {
+        const std::span<const uint8_t> image = asset.image(i);
+        if (spectra::TextureStreamer::isKtx2(image))
+        {
+            images.emplace_back(image.begin(), image.end());
+            continue;
+        }
+
+        std::vector<uint8_t> ktx2 = encodeKtx2(image, options.basis);
+        if (ktx2.empty())
+        {
+            // The runtime still decodes it, the scene stays complete
+            std::cerr << std::format("Keeping image {} in its original encoding\n", i);
+            images.emplace_back(image.begin(), image.end());
+            continue;
+        }
+        images.push_back(std::move(ktx2));
+        converted++;
+    }
+    asset.setImages(images);
+
+    if (!asset.writePackage(options.outputPath))
+    {
+        return EXIT_FAILURE;
+    }
+
+    const double cookMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::clog << std::format("Cooked {} into {} in {:.0f} ms\n", options.inputPath, options.outputPath, cookMs)
+              << std::format("  {} primitives, {} vertices, {} indices, {} nodes\n", asset.primitives().size(),
+                             asset.vertices().size(), asset.indices().size(), asset.nodes().size())
+              << std::format("  {} LODs, {} meshlets\n", asset.lods().size(), asset.meshlets().size())
+              << std::format("  {} images, {} converted to KTX2{}\n", asset.imageCount(), converted,
+                             options.basis ? " (Basis Universal)" : "")
+              << std::format("  {:.1f} MiB -> {:.1f} MiB\n",
+                             std::filesystem::file_size(options.inputPath) / (1024.0 * 1024.0),
+                             std::filesystem::file_size(options.outputPath) / (1024.0 * 1024.0));
+    return EXIT_SUCCESS;
+}
@@ -1,8 +1,72 @@
+#include <iostream>
+#include <string>
+
 #include "Application.h"
 
-int main()
+namespace {
+void printUsage()
+{
+    std::cerr << "Usage: spectra [--present-mode fifo|mailbox|immediate] [--frames-in-flight N]\n";
+}
+
+bool parsePresentMode(const std::string& name, VkPresentModeKHR& presentMode)
+{
+    if (name == "fifo")
+    {
+        presentMode = VK_PRESENT_MODE_FIFO_KHR;
+    }
+    else if (name == "mailbox")
+    {
+        presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+    }
+    else if (name == "immediate")
+    {
+        presentMode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+bool parseArgs(int argc, char** argv, spectra::Application::Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--present-mode" && hasValue)
+        {
+            if (!parsePresentMode(argv[++i], options.presentMode))
+            {
+                return false;
+            }
+        }
+        else if (arg == "--frames-in-flight" && hasValue)
+        {
+            options.framesInFlight = std::stoul(argv[++i]);
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options.framesInFlight > 0;
+}
+} // namespace
+
+int main(int argc, char** argv)
 {
-    spectra::Application app;
+    spectra::Application::Options options;
+    if (!parseArgs(argc, argv, options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    spectra::Application app(options);
     app.run();
 
     return 0;
@@ -10,11 +10,12 @@
 #include "Error.h"
 
 namespace spectra::vk {
-Context::Context()
+Context::Context(bool headless) : headless(headless)
 {
     vkb::InstanceBuilder builder;
     auto instanceRet = builder.set_app_name("Spectra Engine")
                               .require_api_version(1, 3)
+                              .set_headless(headless)
                               .request_validation_layers()
                               .use_default_debug_messenger()
                               .build();
@@ -25,29 +26,26 @@ Context::Context()
     vkbInstance_ = instanceRet.value();
     instance = vkbInstance_.instance;
 
-    glfwInit();
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API); // Do not create an OpenGL context
-    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE); // Disable window resizing for now
-    pWindow = glfwCreateWindow(1280, 720, "Spectra Engine", nullptr, nullptr);
-
-    VkResult glfwResult = glfwCreateWindowSurface(vkbInstance_, pWindow, nullptr, &surface);
-    if (glfwResult != VK_SUCCESS)
+    if (!headless)
     {
-        throw std::runtime_error(std::format("Failed to create Vulkan surface: {}\n", std::to_string(glfwResult)));
-    }
+        glfwInit();
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API); // Do not create an OpenGL context
+        pWindow = glfwCreateWindow(1280, 720, "Spectra Engine", nullptr, nullptr);
 
-    vkb::PhysicalDeviceSelector selector(vkbInstance_);
-    auto physicalDeviceRet = selector
-                             .set_surface(surface)
-                             .set_minimum_version(1, 4)
-                             .select();
-    if (!physicalDeviceRet)
-    {
-        throw std::runtime_error(std::format("Failed to select physical device: {}\n", physicalDeviceRet.error().message()));
+        VkResult glfwResult = glfwCreateWindowSurface(vkbInstance_, pWindow, nullptr, &surface);
+        if (glfwResult != VK_SUCCESS)
+        {
+            throw std::runtime_error(std::format("Failed to create Vulkan surface: {}\n", std::to_string(glfwResult)));
+        }
     }
-    const auto& vkbPhysicalDevice = physicalDeviceRet.value();
-    physicalDevice = vkbPhysicalDevice.physical_device;
 
+    // GPU-driven rendering issues one multi-draw per frame whose draws select their object through firstInstance
+    const VkPhysicalDeviceFeatures requiredFeatures {
+        .multiDrawIndirect = VK_TRUE,
+        .drawIndirectFirstInstance = VK_TRUE,
+    };
+
+    // The selector skips devices lacking any of these, rather than device creation failing on the first one found
     // TODO: Slang compiler generates something that requires this extension, investigate why
     VkPhysicalDeviceVulkan11Features vk11Features {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES,
@@ -56,6 +54,20 @@ Context::Context()
 
     VkPhysicalDeviceVulkan12Features vk12Features {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .drawIndirectCount = VK_TRUE,
+        // Bindless resources, see BindlessHeap
+        .descriptorIndexing = VK_TRUE,
+        .shaderSampledImageArrayNonUniformIndexing = VK_TRUE,
+        .shaderStorageBufferArrayNonUniformIndexing = VK_TRUE,
+        .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE,
+        .descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE,
+        .descriptorBindingUpdateUnusedWhilePending = VK_TRUE,
+        .descriptorBindingPartiallyBound = VK_TRUE,
+        .descriptorBindingVariableDescriptorCount = VK_TRUE,
+        .runtimeDescriptorArray = VK_TRUE,
+        // The depth-only scene depth uses VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL
+        .separateDepthStencilLayouts = VK_TRUE,
+        .timelineSemaphore = VK_TRUE,
         .bufferDeviceAddress = VK_TRUE,
     };
 
@@ -65,12 +77,34 @@ Context::Context()
         .dynamicRendering = VK_TRUE,
     };
 
+    // Without a surface the selector only considers graphics capabilities, which is what CI and farm nodes need
+    vkb::PhysicalDeviceSelector selector(vkbInstance_, surface);
+    auto physicalDeviceRet = selector
+                             .set_minimum_version(1, 4)
+                             .set_required_features(requiredFeatures)
+                             .set_required_features_11(vk11Features)
+                             .set_required_features_12(vk12Features)
+                             .set_required_features_13(vk13Features)
+                             .select();
+    if (!physicalDeviceRet)
+    {
+        throw std::runtime_error(std::format("Failed to select physical device: {}\n", physicalDeviceRet.error().message()));
+    }
+    auto vkbPhysicalDevice = physicalDeviceRet.value();
+    physicalDevice = vkbPhysicalDevice.physical_device;
+
+    // Compressed texture families are optional, the texture streamer transcodes to whichever one is enabled
+    vkbPhysicalDevice.enable_features_if_present(VkPhysicalDeviceFeatures {
+        .textureCompressionETC2 = VK_TRUE,
+        .textureCompressionASTC_LDR = VK_TRUE,
+        .textureCompressionBC = VK_TRUE,
+    });
+    enabledFeatures = vkbPhysicalDevice.features;
+    physicalDeviceProperties = vkbPhysicalDevice.properties;
+
+    // Required features are enabled by the builder, chaining them again would duplicate the structures
     vkb::DeviceBuilder deviceBuilder(vkbPhysicalDevice);
-    auto deviceRet = deviceBuilder
-                     .add_pNext(&vk11Features)
-                     .add_pNext(&vk12Features)
-                     .add_pNext(&vk13Features)
-                     .build();
+    auto deviceRet = deviceBuilder.build();
     if (!deviceRet)
     {
         throw std::runtime_error(std::format("Failed to create physical device: {}\n", deviceRet.error().message()));
@@ -78,12 +112,37 @@ Context::Context()
     vkbDevice = deviceRet.value();
     device = vkbDevice.device;
 
+    pPipelineCache = std::make_unique<PipelineCache>(device, physicalDeviceProperties, ".spectra-cache/pipeline.bin");
+
     auto graphicsQueueRet = vkbDevice.get_queue(vkb::QueueType::graphics);
     if (!graphicsQueueRet)
     {
         throw std::runtime_error(std::format("Failed to get graphics queue: {}\n", graphicsQueueRet.error().message()));
     }
     graphicsQueue = graphicsQueueRet.value();
+    graphicsQueueFamily = vkbDevice.get_queue_index(vkb::QueueType::graphics).value();
+
+    // Prefer a transfer-only family so copies run on the copy engines alongside rendering
+    auto transferIndexRet = vkbDevice.get_dedicated_queue_index(vkb::QueueType::transfer);
+    if (!transferIndexRet)
+    {
+        transferIndexRet = vkbDevice.get_queue_index(vkb::QueueType::transfer);
+    }
+    if (transferIndexRet)
+    {
+        transferQueueFamily = transferIndexRet.value();
+        vkGetDeviceQueue(device, transferQueueFamily, 0, &transferQueue);
+    }
+    else
+    {
+        transferQueueFamily = graphicsQueueFamily;
+        transferQueue = graphicsQueue;
+    }
+
+    if (headless)
+    {
+        return;
+    }
 
     auto presentQueueRet = vkbDevice.get_queue(vkb::QueueType::present);
     if (!presentQueueRet)
@@ -95,11 +154,18 @@ Context::Context()
 
 Context::~Context()
 {
+    pPipelineCache.reset();
     vkb::destroy_device(vkbDevice);
-    vkb::destroy_surface(vkbInstance_, surface);
+    if (surface != VK_NULL_HANDLE)
+    {
+        vkb::destroy_surface(vkbInstance_, surface);
+    }
     vkb::destroy_instance(vkbInstance_);
     instance = VK_NULL_HANDLE;
-    glfwDestroyWindow(pWindow);
-    glfwTerminate();
+    if (pWindow != nullptr)
+    {
+        glfwDestroyWindow(pWindow);
+        glfwTerminate();
+    }
 }
 } // spectra::vk
\ No newline at end of file
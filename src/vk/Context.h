@@ -5,30 +5,43 @@
 #ifndef CONTEXT_H
 #define CONTEXT_H
 
+#include <memory>
 #include <GLFW/glfw3.h>
 #include <VkBootstrap.h>
 
-constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+#include "PipelineCache.h"
 
 namespace spectra::vk {
 class Context {
 public:
-    Context();
+    // A headless context creates no window or surface and selects a device purely on its rendering capabilities
+    explicit Context(bool headless = false);
     ~Context();
 
+    const bool headless;
+
     GLFWwindow* pWindow = nullptr;
     VkInstance instance = VK_NULL_HANDLE;
     VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties physicalDeviceProperties{};
+    VkPhysicalDeviceFeatures enabledFeatures{};
     VkDevice device = VK_NULL_HANDLE;
 
     // TODO: Add queue and index into a struct
     VkQueue graphicsQueue = VK_NULL_HANDLE;
     VkQueue presentQueue = VK_NULL_HANDLE;
+    // Dedicated or separate transfer queue when the device has one, otherwise the graphics queue
+    VkQueue transferQueue = VK_NULL_HANDLE;
+    uint32_t graphicsQueueFamily = 0;
+    uint32_t transferQueueFamily = 0;
 
     VkSurfaceKHR surface = VK_NULL_HANDLE;
 
     vkb::Device vkbDevice{};
 
+    // Shared by all pipeline creation, persisted on destruction
+    std::unique_ptr<PipelineCache> pPipelineCache;
+
 private:
     vkb::Instance vkbInstance_{};
 };
@@ -0,0 +1,141 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "PipelineCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "Error.h"
+#include "Hash.h"
+
+namespace spectra::vk {
+namespace {
+constexpr uint32_t FILE_MAGIC = 0x43505053; // "SPPC"
+constexpr uint32_t FILE_VERSION = 1;
+} // namespace
+
+PipelineCache::PipelineCache(VkDevice device, const VkPhysicalDeviceProperties& properties, std::filesystem::path path)
+    : device_(device), properties_(properties), path_(std::move(path))
+{
+    std::vector<char> initialData;
+
+    std::ifstream file(path_, std::ios::binary);
+    FileHeader header{};
+    if (file && file.read(reinterpret_cast<char*>(&header), sizeof(header)) && header.dataSize < (1ULL << 31))
+    {
+        initialData.resize(header.dataSize);
+        file.read(initialData.data(), static_cast<std::streamsize>(initialData.size()));
+        if (!file || !isCompatible(header, initialData))
+        {
+            std::cerr << "Discarding incompatible pipeline cache " << path_ << "\n";
+            initialData.clear();
+        }
+    }
+
+    const VkPipelineCacheCreateInfo createInfo
+    {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = initialData.size(),
+        .pInitialData = initialData.empty() ? nullptr : initialData.data(),
+    };
+    CHECK_VK(vkCreatePipelineCache(device_, &createInfo, nullptr, &pipelineCache_))
+
+    std::clog << "Pipeline cache: " << (initialData.empty() ? "cold" : "warm") << " start ("
+              << initialData.size() << " bytes)\n";
+}
+
+PipelineCache::~PipelineCache()
+{
+    save();
+    vkDestroyPipelineCache(device_, pipelineCache_, nullptr);
+}
+
+void PipelineCache::save() const
+{
+    size_t dataSize = 0;
+    CHECK_VK(vkGetPipelineCacheData(device_, pipelineCache_, &dataSize, nullptr))
+
+    std::vector<char> data(dataSize);
+    VkResult result = vkGetPipelineCacheData(device_, pipelineCache_, &dataSize, data.data());
+    if (result != VK_SUCCESS || dataSize == 0)
+    {
+        return;
+    }
+    data.resize(dataSize);
+
+    FileHeader header = makeHeader();
+    header.dataSize = data.size();
+    header.dataHash = fnv1a(data.data(), data.size());
+
+    std::error_code ec;
+    if (path_.has_parent_path())
+    {
+        std::filesystem::create_directories(path_.parent_path(), ec);
+    }
+
+    // Write next to the destination and rename over it, a crash mid-write must not leave a truncated cache behind
+    auto tmpPath = path_;
+    tmpPath += ".tmp";
+    {
+        std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!file)
+        {
+            std::cerr << "Failed to write pipeline cache " << tmpPath << "\n";
+            return;
+        }
+    }
+
+    std::filesystem::rename(tmpPath, path_, ec);
+    if (ec)
+    {
+        std::cerr << "Failed to replace pipeline cache " << path_ << ": " << ec.message() << "\n";
+    }
+}
+
+PipelineCache::FileHeader PipelineCache::makeHeader() const
+{
+    FileHeader header {
+        .magic = FILE_MAGIC,
+        .version = FILE_VERSION,
+        .vendorID = properties_.vendorID,
+        .deviceID = properties_.deviceID,
+        .driverVersion = properties_.driverVersion,
+    };
+    memcpy(header.pipelineCacheUUID, properties_.pipelineCacheUUID, VK_UUID_SIZE);
+    return header;
+}
+
+bool PipelineCache::isCompatible(const FileHeader& header, const std::vector<char>& data) const
+{
+    const FileHeader expected = makeHeader();
+    if (header.magic != expected.magic || header.version != expected.version ||
+        header.vendorID != expected.vendorID || header.deviceID != expected.deviceID ||
+        header.driverVersion != expected.driverVersion ||
+        memcmp(header.pipelineCacheUUID, expected.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+    {
+        return false;
+    }
+
+    if (fnv1a(data.data(), data.size()) != header.dataHash)
+    {
+        return false;
+    }
+
+    // Drivers validate this themselves, but some crash on garbage instead of ignoring it
+    VkPipelineCacheHeaderVersionOne vkHeader{};
+    if (data.size() < sizeof(vkHeader))
+    {
+        return false;
+    }
+    memcpy(&vkHeader, data.data(), sizeof(vkHeader));
+    return vkHeader.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           vkHeader.vendorID == properties_.vendorID &&
+           vkHeader.deviceID == properties_.deviceID &&
+           memcmp(vkHeader.pipelineCacheUUID, properties_.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+} // spectra::vk
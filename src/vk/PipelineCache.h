@@ -0,0 +1,54 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_PIPELINECACHE_H
+#define SPECTRA_PIPELINECACHE_H
+
+#include <filesystem>
+#include <type_traits>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace spectra::vk {
+// Device-wide VkPipelineCache persisted across runs. The file is only reused when it was written by the same
+// device and driver, and is replaced atomically on destruction.
+class PipelineCache {
+public:
+    PipelineCache(VkDevice device, const VkPhysicalDeviceProperties& properties, std::filesystem::path path);
+    ~PipelineCache();
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    void save() const;
+
+    [[nodiscard]] VkPipelineCache handle() const { return pipelineCache_; }
+
+private:
+    // Prepended to the driver blob, the Vulkan cache header alone does not include the driver version
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint32_t driverVersion;
+        uint8_t  pipelineCacheUUID[VK_UUID_SIZE];
+        uint32_t reserved = 0; // Would be padding, the header is written as raw bytes
+        uint64_t dataSize;
+        uint64_t dataHash;
+    };
+    static_assert(std::has_unique_object_representations_v<FileHeader>, "FileHeader must not contain padding");
+
+    [[nodiscard]] FileHeader makeHeader() const;
+    [[nodiscard]] bool isCompatible(const FileHeader& header, const std::vector<char>& data) const;
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties properties_{};
+    std::filesystem::path path_;
+    VkPipelineCache pipelineCache_ = VK_NULL_HANDLE;
+};
+} // spectra::vk
+
+#endif //SPECTRA_PIPELINECACHE_H
@@ -0,0 +1,144 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#include "Swapchain.h"
+
+#include <algorithm>
+#include <format>
+#include <iostream>
+#include <stdexcept>
+
+#include "Error.h"
+
+namespace spectra::vk {
+Swapchain::Swapchain(std::shared_ptr<Context> pCtx, VkPresentModeKHR presentMode)
+    : pCtx_(std::move(pCtx)), requestedPresentMode_(presentMode)
+{
+    if (!create(VK_NULL_HANDLE, current_))
+    {
+        throw std::runtime_error("Failed to create the swapchain");
+    }
+}
+
+Swapchain::~Swapchain()
+{
+    // The device is idle by now, nothing in flight can reference any of them
+    for (RetiredSwapchain& retired : retired_)
+    {
+        destroy(retired.resources);
+    }
+    destroy(current_);
+}
+
+bool Swapchain::recreate(uint64_t lastFrame)
+{
+    int width = 0;
+    int height = 0;
+    glfwGetFramebufferSize(pCtx_->pWindow, &width, &height);
+    if (width == 0 || height == 0)
+    {
+        return false;
+    }
+
+    // The old swapchain is retired by the creation but images acquired from it can still be presented
+    Resources next;
+    if (!create(current_.swapchain.swapchain, next))
+    {
+        return false;
+    }
+    retired_.push_back({ std::move(current_), lastFrame });
+    current_ = std::move(next);
+
+    std::clog << std::format("Swapchain recreated: {}x{}, {} images, {}\n", extent().width, extent().height,
+                             imageCount(), presentModeName(presentMode()));
+    return true;
+}
+
+void Swapchain::collectRetired(uint64_t finishedFrame)
+{
+    // The last present of a retired swapchain was queued before any later frame was submitted. Once such a frame
+    // has finished, the presentation engine is done waiting on its semaphores.
+    const auto freed = std::ranges::remove_if(retired_, [&](RetiredSwapchain& retired)
+    {
+        if (retired.lastFrame >= finishedFrame)
+        {
+            return false;
+        }
+        destroy(retired.resources);
+        return true;
+    });
+    retired_.erase(freed.begin(), freed.end());
+}
+
+bool Swapchain::outdated() const
+{
+    int width = 0;
+    int height = 0;
+    glfwGetFramebufferSize(pCtx_->pWindow, &width, &height);
+    return static_cast<uint32_t>(width) != extent().width || static_cast<uint32_t>(height) != extent().height ||
+           requestedPresentMode_ != current_.requestedPresentMode;
+}
+
+const char* Swapchain::presentModeName(VkPresentModeKHR presentMode)
+{
+    switch (presentMode)
+    {
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+        return "immediate";
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+        return "mailbox";
+    case VK_PRESENT_MODE_FIFO_KHR:
+        return "fifo";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+        return "fifo relaxed";
+    default:
+        return "unknown";
+    }
+}
+
+bool Swapchain::create(VkSwapchainKHR oldSwapchain, Resources& resources) const
+{
+    int width = 0;
+    int height = 0;
+    glfwGetFramebufferSize(pCtx_->pWindow, &width, &height);
+
+    vkb::SwapchainBuilder swapchainBuilder(pCtx_->vkbDevice);
+    auto swapchainRet = swapchainBuilder.set_old_swapchain(oldSwapchain)
+                                        .set_desired_extent(static_cast<uint32_t>(width), static_cast<uint32_t>(height))
+                                        .set_desired_present_mode(requestedPresentMode_)
+                                        .add_fallback_present_mode(VK_PRESENT_MODE_FIFO_KHR)
+                                        .build();
+    if (!swapchainRet)
+    {
+        std::cerr << std::format("Failed to create swapchain: {} ({})\n", swapchainRet.error().message(),
+                                 static_cast<int>(swapchainRet.vk_result()));
+        return false;
+    }
+
+    resources.swapchain = swapchainRet.value();
+    resources.requestedPresentMode = requestedPresentMode_;
+    resources.images = resources.swapchain.get_images().value();
+    resources.imageViews = resources.swapchain.get_image_views().value();
+
+    // Per image rather than per frame: an image is only acquired again once its previous present has waited
+    const VkSemaphoreCreateInfo semaphoreCreateInfo { .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+    resources.presentSemaphores.resize(resources.images.size());
+    for (VkSemaphore& semaphore : resources.presentSemaphores)
+    {
+        CHECK_VK(vkCreateSemaphore(pCtx_->device, &semaphoreCreateInfo, nullptr, &semaphore))
+    }
+    return true;
+}
+
+void Swapchain::destroy(Resources& resources) const
+{
+    for (const VkSemaphore semaphore : resources.presentSemaphores)
+    {
+        vkDestroySemaphore(pCtx_->device, semaphore, nullptr);
+    }
+    resources.swapchain.destroy_image_views(resources.imageViews);
+    vkb::destroy_swapchain(resources.swapchain);
+    resources = {};
+}
+} // spectra::vk
@@ -0,0 +1,78 @@
+//
+// Created by Amila Abeygunasekara on Fri 16/10/2026.
+//
+
+#ifndef SPECTRA_SWAPCHAIN_H
+#define SPECTRA_SWAPCHAIN_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <VkBootstrap.h>
+
+#include "Context.h"
+
+namespace spectra::vk {
+// Presentable images of the window surface with one present semaphore per image. Recreating hands the current
+// swapchain to the new one as its old swapchain and keeps it, with its views and semaphores, until the frames that
+// rendered to it have finished, so resizing never idles the device. Frames are identified by the renderer's frame
+// numbers.
+class Swapchain {
+public:
+    Swapchain(std::shared_ptr<Context> pCtx, VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR);
+    ~Swapchain();
+
+    Swapchain(const Swapchain&) = delete;
+    Swapchain& operator=(const Swapchain&) = delete;
+
+    // Rebuilds at the current framebuffer size, retiring the current swapchain once frame lastFrame has finished.
+    // Returns false while the window has no area, the current swapchain stays in use.
+    bool recreate(uint64_t lastFrame);
+    // Destroys retired swapchains whose frames have all finished
+    void collectRetired(uint64_t finishedFrame);
+
+    // Applied by the next recreate(). FIFO is the fallback when the surface does not support the mode.
+    void setPresentMode(VkPresentModeKHR presentMode) { requestedPresentMode_ = presentMode; }
+    [[nodiscard]] VkPresentModeKHR requestedPresentMode() const { return requestedPresentMode_; }
+    [[nodiscard]] VkPresentModeKHR presentMode() const { return current_.swapchain.present_mode; }
+    // Whether the framebuffer size or the requested present mode changed since the swapchain was created
+    [[nodiscard]] bool outdated() const;
+
+    [[nodiscard]] VkSwapchainKHR handle() const { return current_.swapchain.swapchain; }
+    [[nodiscard]] VkExtent2D extent() const { return current_.swapchain.extent; }
+    [[nodiscard]] VkFormat format() const { return current_.swapchain.image_format; }
+    [[nodiscard]] uint32_t imageCount() const { return current_.swapchain.image_count; }
+    [[nodiscard]] const std::vector<VkImage>& images() const { return current_.images; }
+    [[nodiscard]] const std::vector<VkImageView>& imageViews() const { return current_.imageViews; }
+    // Signaled by the frame rendering to an image, waited on by its presentation
+    [[nodiscard]] VkSemaphore presentSemaphore(uint32_t image) const { return current_.presentSemaphores[image]; }
+
+    static const char* presentModeName(VkPresentModeKHR presentMode);
+
+private:
+    struct Resources
+    {
+        vkb::Swapchain swapchain{};
+        VkPresentModeKHR requestedPresentMode = VK_PRESENT_MODE_FIFO_KHR; // May differ from the one in use
+        std::vector<VkImage> images;
+        std::vector<VkImageView> imageViews;
+        std::vector<VkSemaphore> presentSemaphores;
+    };
+
+    struct RetiredSwapchain
+    {
+        Resources resources;
+        uint64_t lastFrame = 0; // Last frame number that rendered to it
+    };
+
+    bool create(VkSwapchainKHR oldSwapchain, Resources& resources) const;
+    void destroy(Resources& resources) const;
+
+    std::shared_ptr<Context> pCtx_;
+    VkPresentModeKHR requestedPresentMode_ = VK_PRESENT_MODE_FIFO_KHR;
+    Resources current_;
+    std::vector<RetiredSwapchain> retired_;
+};
+} // spectra::vk
+
+#endif //SPECTRA_SWAPCHAIN_H
@@ -0,0 +1,33 @@
+//
+// Created by Amila Abeygunasekara on Sat 17/10/2026.
+//
+
+#ifndef SPECTRA_TESTS_CHECK_H
+#define SPECTRA_TESTS_CHECK_H
+
+#include <cstdlib>
+#include <iostream>
+
+namespace spectra::test {
+// Failed checks are reported and counted, a test keeps going so one run shows every failure
+inline int failureCount = 0;
+
+inline void check(bool passed, const char* expression, const char* file, int line)
+{
+    if (!passed)
+    {
+        std::cerr << file << ":" << line << ": check failed: " << expression << "\n";
+        failureCount++;
+    }
+}
+
+// Exit code of a test executable, ctest treats anything but zero as a failure
+inline int result()
+{
+    return failureCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+} // spectra::test
+
+#define CHECK(condition) ::spectra::test::check((condition), #condition, __FILE__, __LINE__)
+
+#endif //SPECTRA_TESTS_CHECK_H
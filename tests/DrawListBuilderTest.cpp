@@ -0,0 +1,174 @@
+//
+// Created by Amila Abeygunasekara on Sat 17/10/2026.
+//
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "Check.h"
+#include "DrawListBuilder.h"
+
+namespace {
+using spectra::DrawListBuilder;
+
+constexpr uint32_t MAX_PIPELINE = (1U << DrawListBuilder::PIPELINE_BITS) - 1;
+constexpr uint32_t MAX_MATERIAL = (1U << DrawListBuilder::MATERIAL_BITS) - 1;
+constexpr uint32_t MAX_MESH = (1U << DrawListBuilder::MESH_BITS) - 1;
+constexpr uint64_t DEPTH_MASK = (uint64_t{ 1 } << DrawListBuilder::DEPTH_BITS) - 1;
+
+void testKeyRoundTrip()
+{
+    // Every field at its limit must come back unchanged and leave its neighbours alone
+    const uint64_t full = DrawListBuilder::makeKey(MAX_PIPELINE, MAX_MATERIAL, MAX_MESH, 1.0f);
+    CHECK(full == ~uint64_t{ 0 });
+
+    const uint64_t meshOnly = DrawListBuilder::makeKey(0, 0, MAX_MESH, 0.0f);
+    CHECK(DrawListBuilder::keyPipeline(meshOnly) == 0);
+    CHECK(DrawListBuilder::keyMaterial(meshOnly) == 0);
+    CHECK(DrawListBuilder::keyMesh(meshOnly) == MAX_MESH);
+    CHECK((meshOnly & DEPTH_MASK) == 0);
+
+    const uint64_t materialOnly = DrawListBuilder::makeKey(0, MAX_MATERIAL, 0, 0.0f);
+    CHECK(DrawListBuilder::keyPipeline(materialOnly) == 0);
+    CHECK(DrawListBuilder::keyMaterial(materialOnly) == MAX_MATERIAL);
+    CHECK(DrawListBuilder::keyMesh(materialOnly) == 0);
+
+    const uint64_t pipelineOnly = DrawListBuilder::makeKey(MAX_PIPELINE, 0, 0, 0.0f);
+    CHECK(DrawListBuilder::keyPipeline(pipelineOnly) == MAX_PIPELINE);
+    CHECK(DrawListBuilder::keyMaterial(pipelineOnly) == 0);
+    CHECK(DrawListBuilder::keyMesh(pipelineOnly) == 0);
+
+    std::mt19937 rng(7);
+    for (int i = 0; i < 1000; i++)
+    {
+        const uint32_t pipeline = rng() & MAX_PIPELINE;
+        const uint32_t material = rng() & MAX_MATERIAL;
+        const uint32_t mesh = rng() & MAX_MESH;
+        const uint64_t key = DrawListBuilder::makeKey(pipeline, material, mesh, 0.5f);
+        CHECK(DrawListBuilder::keyPipeline(key) == pipeline);
+        CHECK(DrawListBuilder::keyMaterial(key) == material);
+        CHECK(DrawListBuilder::keyMesh(key) == mesh);
+    }
+
+    // Depth is clamped to [0, 1] and sorts front to back
+    CHECK(DrawListBuilder::makeKey(1, 2, 3, -1.0f) == DrawListBuilder::makeKey(1, 2, 3, 0.0f));
+    CHECK(DrawListBuilder::makeKey(1, 2, 3, 2.0f) == DrawListBuilder::makeKey(1, 2, 3, 1.0f));
+    CHECK(DrawListBuilder::makeKey(1, 2, 3, 0.25f) < DrawListBuilder::makeKey(1, 2, 3, 0.75f));
+    CHECK((DrawListBuilder::makeKey(1, 2, 3, 1.0f) & DEPTH_MASK) == DEPTH_MASK);
+}
+
+void testSortOrder()
+{
+    // Random keys vary every radix digit, a narrow material range also leaves some digits shared by all keys
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+    std::vector<uint64_t> keys;
+    for (int i = 0; i < 5000; i++)
+    {
+        keys.push_back(DrawListBuilder::makeKey(rng() % 3, rng() % 4, rng() % 50, depth(rng)));
+    }
+    // Duplicates check that equal keys keep the order they were added in
+    for (int i = 0; i < 500; i++)
+    {
+        keys.push_back(keys[rng() % keys.size()]);
+    }
+
+    DrawListBuilder builder;
+    builder.begin();
+    for (uint32_t item = 0; item < keys.size(); item++)
+    {
+        builder.add(keys[item], item);
+    }
+    builder.build();
+
+    const auto instances = builder.instances();
+    CHECK(instances.size() == keys.size());
+    std::vector<uint32_t> expected(keys.size());
+    for (uint32_t item = 0; item < keys.size(); item++)
+    {
+        expected[item] = item;
+    }
+    std::ranges::stable_sort(expected, [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    CHECK(std::ranges::equal(instances, expected));
+
+    for (size_t i = 1; i < builder.batches().size(); i++)
+    {
+        CHECK(builder.batches()[i - 1].key <= builder.batches()[i].key);
+    }
+}
+
+void testBatchMerging()
+{
+    DrawListBuilder builder;
+    builder.begin();
+    // Same pipeline, material and mesh at different depths merge, any other field splits the batch
+    builder.add(DrawListBuilder::makeKey(0, 1, 5, 0.9f), 0);
+    builder.add(DrawListBuilder::makeKey(0, 1, 5, 0.1f), 1);
+    builder.add(DrawListBuilder::makeKey(0, 1, 6, 0.5f), 2);
+    builder.add(DrawListBuilder::makeKey(0, 2, 5, 0.5f), 3);
+    builder.add(DrawListBuilder::makeKey(1, 1, 5, 0.5f), 4);
+    builder.add(DrawListBuilder::makeKey(0, 1, 5, 0.5f), 5);
+    builder.build();
+
+    const auto batches = builder.batches();
+    CHECK(batches.size() == 4);
+    if (batches.size() == 4)
+    {
+        CHECK(batches[0].firstInstance == 0 && batches[0].instanceCount == 3);
+        CHECK(DrawListBuilder::keyMesh(batches[0].key) == 5 && DrawListBuilder::keyMaterial(batches[0].key) == 1);
+        CHECK(batches[1].firstInstance == 3 && batches[1].instanceCount == 1);
+        CHECK(DrawListBuilder::keyMesh(batches[1].key) == 6);
+        CHECK(batches[2].firstInstance == 4 && batches[2].instanceCount == 1);
+        CHECK(DrawListBuilder::keyMaterial(batches[2].key) == 2);
+        CHECK(batches[3].firstInstance == 5 && batches[3].instanceCount == 1);
+        CHECK(DrawListBuilder::keyPipeline(batches[3].key) == 1);
+    }
+    // The merged batch draws its instances front to back
+    const auto instances = builder.instances();
+    CHECK(instances.size() == 6 && instances[0] == 1 && instances[1] == 5 && instances[2] == 0);
+
+    const DrawListBuilder::Stats& stats = builder.stats();
+    CHECK(stats.draws == 6);
+    CHECK(stats.drawCalls == 4);
+    CHECK(stats.pipelineBinds == 2);
+    CHECK(stats.materialBinds == 3);
+    CHECK(stats.unsortedPipelineBinds == 3);
+    CHECK(stats.unsortedMaterialBinds == 4);
+}
+
+void testUnsortedBuild()
+{
+    // Without sorting every draw keeps its position, even identical keys stay separate batches
+    DrawListBuilder builder;
+    builder.begin();
+    const uint64_t key = DrawListBuilder::makeKey(0, 1, 5, 0.5f);
+    builder.add(DrawListBuilder::makeKey(1, 0, 0, 0.0f), 0);
+    builder.add(key, 1);
+    builder.add(key, 2);
+    builder.build(false);
+
+    const auto batches = builder.batches();
+    CHECK(batches.size() == 3);
+    for (uint32_t i = 0; i < batches.size(); i++)
+    {
+        CHECK(batches[i].firstInstance == i && batches[i].instanceCount == 1);
+        CHECK(builder.instances()[i] == i);
+    }
+
+    // A reused builder starts empty
+    builder.begin();
+    builder.build();
+    CHECK(builder.batches().empty());
+    CHECK(builder.instances().empty());
+}
+} // namespace
+
+int main()
+{
+    testKeyRoundTrip();
+    testSortOrder();
+    testBatchMerging();
+    testUnsortedBuild();
+    return spectra::test::result();
+}
@@ -0,0 +1,128 @@
+//
+// Created by Amila Abeygunasekara on Sat 17/10/2026.
+//
+
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Check.h"
+#include "FrustumCuller.h"
+#include "ThreadPool.h"
+
+namespace {
+using spectra::Frustum;
+using spectra::FrustumCuller;
+
+constexpr std::array KERNELS = { FrustumCuller::Kernel::Scalar, FrustumCuller::Kernel::Sse,
+                                 FrustumCuller::Kernel::Avx2 };
+
+glm::vec4 plane(float x, float y, float z, float w)
+{
+    const float length = std::sqrt(x * x + y * y + z * z);
+    return { x / length, y / length, z / length, w / length };
+}
+
+// Camera at the origin looking down -z with a 90 degree field of view, near 0.1 and far 100
+Frustum cameraFrustum()
+{
+    Frustum frustum;
+    frustum.planes = {
+        plane(1.0f, 0.0f, -1.0f, 0.0f),  // Left
+        plane(-1.0f, 0.0f, -1.0f, 0.0f), // Right
+        plane(0.0f, 1.0f, -1.0f, 0.0f),  // Bottom
+        plane(0.0f, -1.0f, -1.0f, 0.0f), // Top
+        plane(0.0f, 0.0f, -1.0f, -0.1f), // Near
+        plane(0.0f, 0.0f, 1.0f, 100.0f), // Far
+    };
+    return frustum;
+}
+
+void fillRandomBoxes(FrustumCuller& culler, uint32_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> position(-120.0f, 120.0f);
+    std::uniform_real_distribution<float> halfSize(0.1f, 8.0f);
+    culler.resize(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const glm::vec3 center(position(rng), position(rng), position(rng));
+        const glm::vec3 extent(halfSize(rng), halfSize(rng), halfSize(rng));
+        culler.setBounds(i, center - extent, center + extent);
+    }
+}
+
+void testKnownBoxes()
+{
+    FrustumCuller culler;
+    culler.setKernel(FrustumCuller::Kernel::Scalar);
+    culler.resize(5);
+    culler.setBounds(0, glm::vec3(-1.0f, -1.0f, -11.0f), glm::vec3(1.0f, 1.0f, -9.0f)); // In front
+    culler.setBounds(1, glm::vec3(-1.0f, -1.0f, 9.0f), glm::vec3(1.0f, 1.0f, 11.0f));   // Behind
+    culler.setBounds(2, glm::vec3(-15.0f, -1.0f, -11.0f), glm::vec3(-9.0f, 1.0f, -9.0f)); // Across the left plane
+    culler.setBounds(3, glm::vec3(-30.0f, -1.0f, -11.0f), glm::vec3(-20.0f, 1.0f, -9.0f)); // Left of it
+    culler.setBounds(4, glm::vec3(-1.0f, -1.0f, -200.0f), glm::vec3(1.0f, 1.0f, -150.0f)); // Beyond the far plane
+
+    std::vector<uint32_t> visible;
+    culler.cull(cameraFrustum(), visible);
+    CHECK((visible == std::vector<uint32_t>{ 0, 2 }));
+    CHECK(culler.stats().tested == 5);
+    CHECK(culler.stats().visible == 2);
+}
+
+// Every kernel and the threaded path must agree with the scalar kernel. Counts that are not a multiple of the
+// SIMD width exercise the scalar tails.
+void testKernelsAgree(const Frustum& frustum, uint32_t count, uint32_t seed)
+{
+    FrustumCuller culler;
+    fillRandomBoxes(culler, count, seed);
+
+    std::vector<uint32_t> expected;
+    culler.setKernel(FrustumCuller::Kernel::Scalar);
+    culler.cull(frustum, expected);
+    CHECK(!expected.empty() && expected.size() < count);
+
+    spectra::ThreadPool threadPool(4);
+    for (const FrustumCuller::Kernel kernel : KERNELS)
+    {
+        if (!FrustumCuller::isSupported(kernel))
+        {
+            std::clog << "Skipping the unsupported " << FrustumCuller::kernelName(kernel) << " kernel\n";
+            continue;
+        }
+        culler.setKernel(kernel);
+
+        std::vector<uint32_t> visible;
+        culler.cull(frustum, visible);
+        CHECK(visible == expected);
+
+        culler.cull(frustum, visible, &threadPool);
+        CHECK(visible == expected);
+    }
+}
+} // namespace
+
+int main()
+{
+    testKnownBoxes();
+
+    testKernelsAgree(cameraFrustum(), 1003, 1);
+    testKernelsAgree(cameraFrustum(), FrustumCuller::PARALLEL_MIN_OBJECTS * 2 + 5, 2);
+
+    // Oblique planes give every sign combination of the normals
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+    for (uint32_t seed = 10; seed < 14; seed++)
+    {
+        Frustum frustum;
+        for (auto& p : frustum.planes)
+        {
+            p = plane(component(rng), component(rng), component(rng), 60.0f * std::abs(component(rng)));
+        }
+        testKernelsAgree(frustum, FrustumCuller::PARALLEL_MIN_OBJECTS + 77, seed);
+    }
+
+    return spectra::test::result();
+}
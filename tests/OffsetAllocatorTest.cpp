@@ -0,0 +1,156 @@
+//
+// Created by Amila Abeygunasekara on Sat 17/10/2026.
+//
+
+#include <random>
+#include <vector>
+
+#include "Check.h"
+#include "OffsetAllocator.h"
+
+namespace {
+using spectra::OffsetAllocator;
+
+void testFillAndExhaust()
+{
+    OffsetAllocator allocator(100);
+    const auto a = allocator.allocate(40);
+    const auto b = allocator.allocate(60);
+    CHECK(a && b);
+    CHECK(allocator.usedSize() == 100);
+    CHECK(allocator.largestFreeRange() == 0);
+    CHECK(!allocator.allocate(1));
+
+    // Zero sizes and alignments are rejected rather than handed an empty range
+    OffsetAllocator empty(16);
+    CHECK(!empty.allocate(0));
+    CHECK(!empty.allocate(4, 0));
+    CHECK(!empty.allocate(17));
+}
+
+void testCoalescing()
+{
+    OffsetAllocator allocator(30);
+    const auto a = allocator.allocate(10);
+    const auto b = allocator.allocate(10);
+    const auto c = allocator.allocate(10);
+    CHECK(a && b && c);
+    if (!a || !b || !c)
+    {
+        return;
+    }
+
+    // Freeing the middle leaves a hole, its neighbours merge with it from either side
+    allocator.free(*b);
+    CHECK(allocator.freeRangeCount() == 1);
+    CHECK(allocator.largestFreeRange() == 10);
+    allocator.free(*c);
+    CHECK(allocator.freeRangeCount() == 1);
+    CHECK(allocator.largestFreeRange() == 20);
+    allocator.free(*a);
+    CHECK(allocator.freeRangeCount() == 1);
+    CHECK(allocator.largestFreeRange() == 30);
+    CHECK(allocator.usedSize() == 0);
+}
+
+void testAlignment()
+{
+    OffsetAllocator allocator(64);
+    const auto small = allocator.allocate(3);
+    const auto aligned = allocator.allocate(8, 16);
+    CHECK(small && small->offset == 0);
+    CHECK(aligned && aligned->offset == 16 && aligned->size == 8);
+    // Padding skipped for the alignment stays free, only the requested size counts as used
+    CHECK(allocator.usedSize() == 11);
+    const auto padding = allocator.allocate(13);
+    CHECK(padding && padding->offset == 3);
+}
+
+void testBestFit()
+{
+    // Holes of 8 and 4 elements, a 4-element request must take the smaller one
+    OffsetAllocator allocator(40);
+    const auto a = allocator.allocate(8);
+    const auto keepA = allocator.allocate(4);
+    const auto b = allocator.allocate(4);
+    const auto keepB = allocator.allocate(24);
+    CHECK(a && keepA && b && keepB);
+    if (!a || !b)
+    {
+        return;
+    }
+    allocator.free(*a);
+    allocator.free(*b);
+
+    const auto fit = allocator.allocate(4);
+    CHECK(fit && fit->offset == b->offset);
+    const auto large = allocator.allocate(8);
+    CHECK(large && large->offset == a->offset);
+}
+
+void testRandomAgainstModel()
+{
+    // Random allocations and frees, checked against a map of which elements are taken
+    constexpr uint64_t CAPACITY = 4096;
+    OffsetAllocator allocator(CAPACITY);
+    std::vector<bool> taken(CAPACITY, false);
+    std::vector<OffsetAllocator::Allocation> live;
+    uint64_t used = 0;
+
+    std::mt19937 rng(3);
+    for (int step = 0; step < 20000; step++)
+    {
+        if (live.empty() || rng() % 3 != 0)
+        {
+            const uint64_t size = 1 + rng() % 64;
+            const uint64_t alignment = uint64_t{ 1 } << (rng() % 5);
+            const auto allocation = allocator.allocate(size, alignment);
+            if (!allocation)
+            {
+                continue;
+            }
+            CHECK(allocation->offset % alignment == 0);
+            CHECK(allocation->offset + allocation->size <= CAPACITY);
+            for (uint64_t i = allocation->offset; i < allocation->offset + allocation->size; i++)
+            {
+                CHECK(!taken[i]);
+                taken[i] = true;
+            }
+            used += size;
+            live.push_back(*allocation);
+        }
+        else
+        {
+            const size_t index = rng() % live.size();
+            const OffsetAllocator::Allocation allocation = live[index];
+            live[index] = live.back();
+            live.pop_back();
+            allocator.free(allocation);
+            for (uint64_t i = allocation.offset; i < allocation.offset + allocation.size; i++)
+            {
+                taken[i] = false;
+            }
+            used -= allocation.size;
+        }
+        CHECK(allocator.usedSize() == used);
+    }
+
+    for (const auto& allocation : live)
+    {
+        allocator.free(allocation);
+    }
+    CHECK(allocator.usedSize() == 0);
+    CHECK(allocator.freeRangeCount() == 1);
+    CHECK(allocator.largestFreeRange() == CAPACITY);
+}
+} // namespace
+
+int main()
+{
+    testFillAndExhaust();
+    testCoalescing();
+    testAlignment();
+    testBestFit();
+    testRandomAgainstModel();
+    return spectra::test::result();
+}